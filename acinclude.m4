@@ -222,7 +222,8 @@ dnl Note: each time a change is done in m4_pattern_forbid, autogen.sh
 dnl should be tested with and without ax_pthread.m4 availability (in
 dnl the latter case, there should be an error).
 m4_pattern_forbid([AX_PTHREAD\b])
-AX_PTHREAD([])
+AX_PTHREAD([AC_DEFINE([HAVE_PTHREAD], 1,
+  [Define if POSIX threads are available (only used by tools/bench).])])
 
 dnl Check for ISO C11 Thread
 MPFR_CHECK_C11_THREAD()
@@ -32,6 +32,7 @@ mpfr_acosh (mpfr_ptr y, mpfr_srcptr x , mpfr_rnd_t rnd_mode)
   MPFR_SAVE_EXPO_DECL (expo);
   int inexact;
   int comp;
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC (
     ("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
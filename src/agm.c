@@ -37,6 +37,7 @@ mpfr_agm (mpfr_ptr r, mpfr_srcptr op2, mpfr_srcptr op1, mpfr_rnd_t rnd_mode)
   MPFR_ZIV_DECL (loop);
   MPFR_TMP_DECL(marker);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (r));
 
   MPFR_LOG_FUNC
     (("op2[%Pu]=%.*Rg op1[%Pu]=%.*Rg rnd=%d",
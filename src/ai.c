@@ -595,6 +595,228 @@ mpfr_ai2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
   return r;
 }
 
+/* Airy function Ai evaluated by its asymptotic expansion for large |x|
+   (formulae 9.7.5 and 9.7.9 from the DLMF). Let X = |x|, zeta = 2/3*X^(3/2),
+   u_0 = 1, u_k = u_(k-1)*(6k-5)(6k-3)(6k-1)/(216k(2k-1)), and v_k =
+   u_k/zeta^k, thus v_k = v_(k-1)*(6k-5)(6k-1)/(48k*X^(3/2)). Then:
+     Ai(x) ~ exp(-zeta)/(2*sqrt(Pi)*X^(1/4)) * S                 if x > 0,
+     Ai(x) ~ (cos(zeta)*(P-Q) + sin(zeta)*(P+Q))/sqrt(2*Pi*X^(1/2)) if x < 0,
+   with S = sum((-1)^k*v_k), P = sum((-1)^k*v_(2k)), Q = sum((-1)^k*v_(2k+1)),
+   where the second formula comes from cos(zeta-Pi/4) = (cos(zeta)+sin(zeta))
+   /sqrt(2) and sin(zeta-Pi/4) = (sin(zeta)-cos(zeta))/sqrt(2).
+   For x real, the remainder of each of the series S, P and Q is bounded in
+   absolute value by its first neglected term (DLMF 9.7(iv)). The v_k decrease
+   as long as k <= 2*zeta, thus the expansion cannot give more than about
+   2*zeta*log2(e) bits.
+   Assumes x is a regular number with |x| >= 2.
+   Return 0 if the expansion does not converge enough (the value 0 as inexact
+   flag cannot happen for Ai(x) with x nonzero). */
+static int
+mpfr_ai_asympt (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_GROUP_DECL (group);
+  mpfr_t absx, h, r, z, v, s, q;
+  mpfr_prec_t w;                 /* working precision */
+  mpfr_exp_t ek, es, err;
+  unsigned long int k, n;
+  int neg, inex, ok;
+
+  MPFR_LOG_FUNC (
+    ("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd),
+    ("y[%Pu]=%.*Rg", mpfr_get_prec (y), mpfr_log_prec, y) );
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+  MPFR_ASSERTD (MPFR_GET_EXP (x) >= 2);
+
+  neg = MPFR_IS_NEG (x);
+  MPFR_ALIAS (absx, x, MPFR_SIGN_POS, MPFR_GET_EXP (x));
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  if (!neg)
+    {
+      mpfr_t t, u;
+      int underflow;
+
+      /* Ai(x) <= exp(-zeta)/2 for x >= 1, thus if zeta*log2(e) >= 1 - emin,
+         then Ai(x) < 2^(emin-2), and the result underflows. Otherwise
+         EXP(zeta) is at most about log2(1-emin), so that the working
+         precision below stays reasonable. */
+      mpfr_init2 (t, MPFR_SMALL_PRECISION);
+      mpfr_init2 (u, sizeof (mpfr_exp_t) * CHAR_BIT);
+      mpfr_sqrt (t, absx, MPFR_RNDD);
+      mpfr_mul (t, t, absx, MPFR_RNDD);
+      /* 0.9617966939259755 <~ 2/3 * log2(e) */
+      mpfr_set_str (u, "0.9617966939259755", 10, MPFR_RNDD);
+      mpfr_mul (t, t, u, MPFR_RNDD);
+      inex = mpfr_set_exp_t (u, expo.saved_emin, MPFR_RNDN);
+      MPFR_ASSERTD (inex == 0);
+      inex = mpfr_ui_sub (u, 1, u, MPFR_RNDN);
+      MPFR_ASSERTD (inex == 0);
+      underflow = mpfr_cmp (t, u) >= 0;
+      mpfr_clear (t);
+      mpfr_clear (u);
+      if (underflow)
+        {
+          MPFR_SAVE_EXPO_FREE (expo);
+          return mpfr_underflow (y, rnd == MPFR_RNDN ? MPFR_RNDZ : rnd, 1);
+        }
+    }
+
+  /* zeta has about 3/2*EXP(x) bits before the binary point, which must be
+     accurate for exp(-zeta), cos(zeta) and sin(zeta) */
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + MPFR_GET_EXP (x)
+    + MPFR_GET_EXP (x) / 2 + 12;
+  MPFR_GROUP_INIT_6 (group, w, h, r, z, v, s, q);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      ok = 0;
+      /* In the following, eps = 2^(-w). We have h = X^(3/2)*(1+t1) with
+         |t1| <= 2*eps, r = 1/X^(3/2)*(1+t2) with |t2| <= 3*eps and
+         z = zeta*(1+t3) with |t3| <= 3*eps, neglecting second order terms,
+         which is harmless for w >= 8. */
+      mpfr_sqrt (h, absx, MPFR_RNDN);
+      mpfr_mul (h, h, absx, MPFR_RNDN);
+      mpfr_ui_div (r, 1, h, MPFR_RNDN);
+      mpfr_mul_2ui (z, h, 1, MPFR_RNDN);
+      mpfr_div_ui (z, z, 3, MPFR_RNDN);
+      if (mpfr_cmp_ui (z, w / 3) < 0)
+        break;  /* 2*zeta*log2(e) < w: the expansion cannot give w bits */
+
+      /* Sum the series until the first term v_n < 2^(-w), and check that
+         v_(n+1) < 2^(-w) too, so that the first neglected term of each of
+         P and Q is bounded by 2^(-w). Since we only add terms v_k with
+         k <= 2*zeta, the terms decrease, thus v_k <= v_1 < 1/16 for k >= 1,
+         S and P are in [1/2, 1], and Q is in [0, 1/16]. */
+      mpfr_set_ui (v, 1, MPFR_RNDN);
+      mpfr_set_ui (s, 1, MPFR_RNDN);
+      mpfr_set_ui (q, 0, MPFR_RNDN);
+      ek = -3;   /* max of EXP(v_k) + ceil(log2(k)) for the terms added */
+      for (k = 1, n = 0; ; k++)
+        {
+          if (mpfr_cmp_ui_2exp (z, k, -1) < 0)
+            break;  /* k > 2*zeta: the terms do not decrease any more */
+          mpfr_mul (v, v, r, MPFR_RNDN);
+          if (6 * k - 1 <= ULONG_MAX / (6 * k - 5))
+            mpfr_mul_ui (v, v, (6 * k - 5) * (6 * k - 1), MPFR_RNDN);
+          else
+            {
+              mpfr_mul_ui (v, v, 6 * k - 5, MPFR_RNDN);
+              mpfr_mul_ui (v, v, 6 * k - 1, MPFR_RNDN);
+            }
+          mpfr_div_ui2 (v, v, 48, k, MPFR_RNDN);
+          /* each step has at most 5 roundings, and r has a relative error
+             at most 3*eps, thus the relative error on v_k is bounded by
+             (1+eps)^(8k) - 1 <= 9k*eps */
+          if (MPFR_GET_EXP (v) <= - (mpfr_exp_t) w)
+            {
+              if (n != 0)
+                {
+                  ok = 1;
+                  break;
+                }
+              n = k; /* v_n is the first neglected term */
+              continue;
+            }
+          if (n != 0)
+            break;  /* v_(n+1) >= 2^(-w) */
+          if (MPFR_GET_EXP (v) + (mpfr_exp_t) MPFR_INT_CEIL_LOG2 (k) > ek)
+            ek = MPFR_GET_EXP (v) + MPFR_INT_CEIL_LOG2 (k);
+          if (neg && (k & 1))
+            {
+              if (k & 2)
+                mpfr_sub (q, q, v, MPFR_RNDN);
+              else
+                mpfr_add (q, q, v, MPFR_RNDN);
+            }
+          else if (neg ? (k & 2) : (k & 1))
+            mpfr_sub (s, s, v, MPFR_RNDN);
+          else
+            mpfr_add (s, s, v, MPFR_RNDN);
+        }
+      if (!ok)
+        break;  /* the expansion does not give w bits */
+      MPFR_LOG_MSG (("Truncation rank: %lu\n", n));
+
+      /* Since the partial sums are bounded by 1, the error on the sum of
+         v_0, ..., v_(n-1) is at most (9*sum(k*v_k) + n)*eps
+         <= n*(9*2^ek + 1)*eps <= 2^es*eps, and adding the error of at most
+         eps for the neglected terms, each of S, P and Q has an absolute
+         error at most 2^(es+1)*eps. */
+      es = MPFR_INT_CEIL_LOG2 (n) + MAX (ek + 4, 1);
+
+      err = MPFR_GET_EXP (z);
+      if (!neg)
+        {
+          /* |z - zeta| <= 3*zeta*eps <= 1/4, thus exp(-z) = exp(-zeta)*(1+t)
+             with |t| <= 6*zeta*eps, and since 2^err > z, the relative error
+             on the result is bounded by (6*zeta + 1 + 2^(es+2) + 3 + 2)*eps
+             <= 2^(max(err + 3, es + 2) + 2) * eps, since S >= 1/2. */
+          mpfr_neg (z, z, MPFR_RNDN);
+          mpfr_exp (r, z, MPFR_RNDN);
+          mpfr_mul (s, s, r, MPFR_RNDN);
+          mpfr_sqrt (h, absx, MPFR_RNDN);
+          mpfr_const_pi (v, MPFR_RNDN);
+          mpfr_mul (h, h, v, MPFR_RNDN);
+          mpfr_sqrt (h, h, MPFR_RNDN);  /* sqrt(Pi)*X^(1/4)*(1+t), |t|<=3*eps */
+          mpfr_div (s, s, h, MPFR_RNDN);
+          mpfr_div_2ui (s, s, 1, MPFR_RNDN);
+          err = MAX (err + 3, es + 2) + 2;
+        }
+      else
+        {
+          /* cos(z) and sin(z) have an absolute error at most
+             3*zeta*eps + eps/2 <= (3*zeta + 1)*eps, P-Q and P+Q are bounded
+             by 2 with absolute error at most (2^(es+2) + 1)*eps, thus
+             cos(z)*(P-Q) + sin(z)*(P+Q) has an absolute error at most
+             (12*zeta + 4 + 2^(es+3) + 2 + 2 + 4)*eps
+             <= 2^(max(err + 4, es + 3) + 2) * eps. */
+          mpfr_sin_cos (v, r, z, MPFR_RNDN);
+          mpfr_sub (h, s, q, MPFR_RNDN);
+          mpfr_add (s, s, q, MPFR_RNDN);
+          mpfr_mul (r, r, h, MPFR_RNDN);
+          mpfr_mul (v, v, s, MPFR_RNDN);
+          mpfr_add (s, r, v, MPFR_RNDN);
+          err = MAX (err + 4, es + 3) + 2;
+          mpfr_sqrt (h, absx, MPFR_RNDN);
+          mpfr_const_pi (v, MPFR_RNDN);
+          mpfr_mul (h, h, v, MPFR_RNDN);
+          mpfr_mul_2ui (h, h, 1, MPFR_RNDN);
+          mpfr_sqrt (h, h, MPFR_RNDN);  /* with relative error <= 3*eps */
+          mpfr_div (s, s, h, MPFR_RNDN);
+          /* the absolute error on the quotient is bounded by
+             2^err*eps/|h| + 4*eps*|s| + 1/2 ulp(s)
+             <= (2^(err+1-EXP(h)) + 2^(EXP(s)+3)) * eps */
+          if (MPFR_IS_ZERO (s))
+            goto next;
+          err = MAX (err + 1 - MPFR_GET_EXP (h), MPFR_GET_EXP (s) + 3) + 1
+            - MPFR_GET_EXP (s);
+        }
+
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, w - err, MPFR_PREC (y), rnd)))
+        break;
+    next:
+      MPFR_ZIV_NEXT (loop, w);
+      MPFR_GROUP_REPREC_6 (group, w, h, r, z, v, s, q);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  if (!ok)
+    {
+      MPFR_GROUP_CLEAR (group);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return 0;  /* means that the asymptotic expansion failed */
+    }
+
+  inex = mpfr_set (y, s, rnd);
+  MPFR_GROUP_CLEAR (group);
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inex, rnd);
+}
+
 /* We consider that the boundary between the area where the naive method
    should preferably be used and the area where Smith' method should preferably
    be used has the following form:
@@ -608,6 +830,12 @@ mpfr_ai2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
    * If x>0 and MPFR_AI_THRESHOLD3*x + MPFR_AI_THRESHOLD2*prec > MPFR_AI_SCALE,
    use Smith' algorithm;
    * otherwise, use the naive method.
+
+   Independently, for |x| >= 2, the asymptotic expansion is used first if
+   MPFR_AI_SCALE*|x|^(3/2) >= MPFR_AI_ASYMPT_THRESHOLD*prec. It can give
+   about 2*log2(e)*zeta bits, with zeta = 2/3*|x|^(3/2), thus the threshold
+   should not be less than about 0.52*MPFR_AI_SCALE; if the expansion does
+   not converge enough nevertheless, we fall back to the above methods.
 */
 
 #define MPFR_AI_SCALE 1048576
@@ -616,7 +844,7 @@ int
 mpfr_ai (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
 {
   mpfr_t temp1, temp2;
-  int use_ai2;
+  int use_ai2, use_asympt;
   MPFR_SAVE_EXPO_DECL (expo);
 
   /* Special cases */
@@ -648,12 +876,32 @@ mpfr_ai (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
       mpfr_mul_si (temp1, temp1, MPFR_AI_THRESHOLD3, MPFR_RNDN);
 
   mpfr_add (temp1, temp1, temp2, MPFR_RNDN);
-  mpfr_clear (temp2);
 
   use_ai2 = mpfr_cmp_si (temp1, MPFR_AI_SCALE) > 0;
+
+  use_asympt = ! MPFR_IS_ZERO (x) && MPFR_GET_EXP (x) >= 2;
+  if (use_asympt)
+    {
+      mpfr_abs (temp1, x, MPFR_RNDN);
+      mpfr_sqrt (temp2, temp1, MPFR_RNDN);
+      mpfr_mul (temp1, temp1, temp2, MPFR_RNDN);
+      mpfr_mul_ui (temp1, temp1, MPFR_AI_SCALE, MPFR_RNDN);
+      mpfr_set_ui (temp2, MPFR_AI_ASYMPT_THRESHOLD, MPFR_RNDN);
+      mpfr_mul_ui (temp2, temp2, MPFR_PREC (y) > ULONG_MAX ?
+                   ULONG_MAX : (unsigned long) MPFR_PREC (y), MPFR_RNDN);
+      use_asympt = mpfr_cmp (temp1, temp2) >= 0;
+    }
   mpfr_clear (temp1);
+  mpfr_clear (temp2);
 
   MPFR_SAVE_EXPO_FREE (expo); /* Ignore all previous exceptions. */
 
+  if (use_asympt)
+    {
+      int inex = mpfr_ai_asympt (y, x, rnd);
+      if (inex != 0)
+        return inex;
+    }
+
   return use_ai2 ? mpfr_ai2 (y, x, rnd) : mpfr_ai1 (y, x, rnd);
 }
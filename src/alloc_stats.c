@@ -0,0 +1,227 @@
+/* mpfr_alloc_stats_enable, mpfr_alloc_stats_export, mpfr_alloc_stats_reset
+   -- allocation accounting of the MPFR functions
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* The allocations are counted by wrappers of the GMP memory functions,
+   installed with mp_set_memory_functions the first time the accounting
+   is enabled, and never removed (they just forward to the previous
+   functions when nothing is counted). Thus the user-defined memory
+   functions, if any, must be set before, like for the tests (see
+   tests/memory.c), and the first call to mpfr_alloc_stats_enable must
+   not be done concurrently with other calls to MPFR or GMP.
+   The counters are per-thread. They are only updated between the entry
+   and the exit of the outermost call to a function with a record (see
+   MPFR_LATENCY_FUNC in mpfr-impl.h), i.e., when depth is positive, and
+   at the exit, they are added to the record of this function, which is
+   allocated the first time and linked in a per-thread list, like the
+   latency histograms (see latency.c). The blocks obtained with alloca
+   by MPFR_TMP_ALLOC are not counted, but its heap fallback is. */
+
+static void *(*alloc_stats_allocate_orig) (size_t) = NULL;
+static void *(*alloc_stats_reallocate_orig) (void *, size_t, size_t);
+static void (*alloc_stats_free_orig) (void *, size_t);
+
+static MPFR_THREAD_ATTR mpfr_latency_rec_ptr alloc_list = NULL;
+static MPFR_THREAD_ATTR unsigned int depth = 0;
+static MPFR_THREAD_ATTR unsigned long cur_mallocs;
+static MPFR_THREAD_ATTR size_t cur_bytes, cur_live, cur_peak;
+
+/* Count a block of size n, or the increase of a block to size n + old
+   (the bytes are those of the increase, if any). */
+static void
+alloc_stats_count (size_t old, size_t n)
+{
+  cur_mallocs ++;
+  if (n <= old)
+    return;
+  cur_bytes += n - old;
+  cur_live += n - old;
+  if (cur_live > cur_peak)
+    cur_peak = cur_live;
+}
+
+/* Blocks allocated before the call may be freed during the call: cur_live
+   is then kept non-negative, thus it is the memory allocated during the
+   call that is still live, and possibly less. */
+static void
+alloc_stats_uncount (size_t n)
+{
+  cur_live = cur_live > n ? cur_live - n : 0;
+}
+
+static void *
+alloc_stats_allocate (size_t n)
+{
+  if (depth != 0)
+    alloc_stats_count (0, n);
+  return (*alloc_stats_allocate_orig) (n);
+}
+
+static void *
+alloc_stats_reallocate (void *p, size_t old, size_t n)
+{
+  if (depth != 0)
+    {
+      alloc_stats_count (old, n);
+      if (n < old)
+        alloc_stats_uncount (old - n);
+    }
+  return (*alloc_stats_reallocate_orig) (p, old, n);
+}
+
+static void
+alloc_stats_free (void *p, size_t n)
+{
+  if (depth != 0)
+    alloc_stats_uncount (n);
+  (*alloc_stats_free_orig) (p, n);
+}
+
+/* Called at the entry of a function with a record (see mpfr_latency_start)
+   when the accounting is enabled. */
+void
+mpfr_alloc_stats_start (void)
+{
+  if (depth++ == 0)
+    {
+      cur_mallocs = 0;
+      cur_bytes = cur_live = cur_peak = 0;
+    }
+}
+
+/* Called at the exit of a function with a record (see mpfr_latency_stop)
+   when the accounting is enabled. */
+void
+mpfr_alloc_stats_stop (mpfr_latency_rec_ptr r)
+{
+  mpfr_alloc_stats_t *a;
+
+  MPFR_ASSERTD (depth > 0);
+  if (--depth != 0)
+    return;
+  if (MPFR_UNLIKELY (r->alloc == NULL))
+    {
+      r->alloc = (mpfr_alloc_stats_t *)
+        (*__gmp_allocate_func) (sizeof (mpfr_alloc_stats_t));
+      memset (r->alloc, 0, sizeof (mpfr_alloc_stats_t));
+      r->alloc->name = r->name;
+      r->alloc_next = alloc_list;
+      alloc_list = r;
+    }
+  a = r->alloc;
+  a->calls ++;
+  a->mallocs += cur_mallocs;
+  a->bytes += cur_bytes;
+  if (cur_peak > a->peak)
+    a->peak = cur_peak;
+}
+
+int
+mpfr_alloc_stats_enable (int enable)
+{
+  int old = (__gmpfr_instr & MPFR_INSTR_ALLOC) != 0;
+
+  if (enable)
+    {
+      if (alloc_stats_allocate_orig == NULL)
+        {
+          mp_get_memory_functions (&alloc_stats_allocate_orig,
+                                   &alloc_stats_reallocate_orig,
+                                   &alloc_stats_free_orig);
+          mp_set_memory_functions (alloc_stats_allocate,
+                                   alloc_stats_reallocate,
+                                   alloc_stats_free);
+        }
+#ifndef MPFR_HAVE_GMP_IMPL
+      /* the memory functions cached by this thread (see mpfr-gmp.h) must
+         be fetched again, so that the wrappers are used */
+      mpfr_allocate_func = 0;
+#endif
+      __gmpfr_instr |= MPFR_INSTR_ALLOC;
+    }
+  else
+    __gmpfr_instr &= ~MPFR_INSTR_ALLOC;
+  return old;
+}
+
+/* Add the counters of the current thread to those of tab[0..n-1], where
+   the entries with a NULL name are free. Return 0 if all the counters
+   could be merged, non-zero if tab was too small. */
+int
+mpfr_alloc_stats_export (mpfr_alloc_stats_t *tab, size_t n)
+{
+  mpfr_latency_rec_ptr r;
+  int lost = 0;
+
+  for (r = alloc_list; r != NULL; r = r->alloc_next)
+    {
+      size_t i;
+
+      for (i = 0; i < n && tab[i].name != NULL &&
+             strcmp (tab[i].name, r->name) != 0; i++);
+      if (i == n)
+        {
+          lost = 1;
+          continue;
+        }
+      if (tab[i].name == NULL)
+        {
+          memset (&tab[i], 0, sizeof (mpfr_alloc_stats_t));
+          tab[i].name = r->name;
+        }
+      tab[i].calls += r->alloc->calls;
+      tab[i].mallocs += r->alloc->mallocs;
+      tab[i].bytes += r->alloc->bytes;
+      if (r->alloc->peak > tab[i].peak)
+        tab[i].peak = r->alloc->peak;
+    }
+  return lost;
+}
+
+void
+mpfr_alloc_stats_reset (void)
+{
+  mpfr_latency_rec_ptr r;
+
+  for (r = alloc_list; r != NULL; r = r->alloc_next)
+    {
+      memset (r->alloc, 0, sizeof (mpfr_alloc_stats_t));
+      r->alloc->name = r->name;
+    }
+}
+
+void
+mpfr_alloc_stats_freecache (void)
+{
+  mpfr_latency_rec_ptr r, next;
+
+  for (r = alloc_list; r != NULL; r = next)
+    {
+      next = r->alloc_next;
+      (*__gmp_free_func) (r->alloc, sizeof (mpfr_alloc_stats_t));
+      r->alloc = NULL;
+      r->alloc_next = NULL;
+    }
+  alloc_list = NULL;
+}
@@ -23,35 +23,83 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
-/* If x = p/2^r, put in y an approximation of atan(x)/x using 2^m terms
-   for the series expansion, with an error of at most 1 ulp.
+typedef struct {
+  mpz_srcptr p;
+  unsigned long r;
+  int small;             /* a(j), b(j) and p^2 fit in an unsigned long */
+  unsigned long pu, p2u; /* p and p^2 when small is set */
+} mpfr_atan_aux_data;
+
+/* Term of index j >= 1 of the series of atan(x)/x where the terms are
+   summed by pairs, see mpfr_atan_aux and mpfr_bsplit */
+static void
+mpfr_atan_aux_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T,
+                    mp_bitcnt_t *f, unsigned long j, void *data)
+{
+  mpfr_atan_aux_data *d = (mpfr_atan_aux_data *) data;
+
+  /* P <- p^2, T <- ((4j+3)*2^r - (4j+1)*p) * p^2, B <- (4j+1)*(4j+3) */
+  if (d->small)
+    {
+      /* usual case for the first calls of mpfr_atan_aux, which have the
+         largest number of terms: avoid most of the GMP calls */
+      mpz_set_ui (P, d->p2u);
+      mpz_set_ui (T, ((4 * j + 3) << d->r) - (4 * j + 1) * d->pu);
+      if (d->p2u != 1)
+        mpz_mul_ui (T, T, d->p2u);
+      mpz_set_ui (B, (4 * j + 1) * (4 * j + 3));
+    }
+  else
+    {
+      mpz_mul (P, d->p, d->p);
+      mpz_set_ui (T, 4 * j + 3);
+      mpz_mul_2exp (T, T, d->r);
+      mpz_submul_ui (T, d->p, 4 * j + 1);
+      mpz_mul (T, T, P);
+      mpz_set_ui (B, 4 * j + 1);
+      mpz_mul_ui (B, B, 4 * j + 3);
+    }
+  mpz_set_ui (Q, 1);
+  *f = 2 * d->r;
+}
+
+/* If x = p/2^r, put in y an approximation of atan(x)/x, with an error of
+   at most 1 ulp.
    Assumes |x| < 1.
 
    If X=x^2, we want 1 - X/3 + X^2/5 - ... + (-1)^k*X^k/(2k+1) + ...
 
    Assume p is non-zero.
 
-   When we sum terms up to x^k/(2k+1), the denominator Q[0] is
-   3*5*7*...*(2k+1) ~ (2k/e)^k.
+   We write X = p'/2^r' with p' odd. The terms of index 2j and 2j+1 are
+   summed by pairs, which halves the number of nodes of the binary
+   splitting, whose cost dominates for small precisions:
+     X^(2j) * (1/(4j+1) - X/(4j+3))
+       = X^(2j) * ((4j+3)*2^r' - (4j+1)*p') / (2^r'*(4j+1)*(4j+3)).
+   The pairs of index 1 to M-1 are summed by mpfr_bsplit, with
+   MPFR_BSPLIT_POW since p(j) = p'^2 for all j, q(j) = 2^(2r'),
+   a(j) = (4j+3)*2^r' - (4j+1)*p' and b(j) = (4j+1)*(4j+3). This gives
+   T/(B*2^e), thus atan(x)/x ~ (3*2^r' - p')/(3*2^r') + T/(B*2^(e+r')).
+   The term of index k is bounded by 2^(-k*g), where g = r' - log2(p'),
+   and we choose N <= 2M so that the first neglected term is less than
+   2^(-precy-1), which is 1/2 ulp(y) since y > 1/2. The denominator B is
+   5*7*9*...*(4M-1) ~ (4M/e)^(2M).
+
+   bs is used as temporary storage.
 */
 static void
-mpfr_atan_aux (mpfr_ptr y, mpz_ptr p, long r, int m, mpz_t *tab)
+mpfr_atan_aux (mpfr_ptr y, mpz_ptr p, long r, mpfr_bsplit_ptr bs)
 {
-  mpz_t *S, *Q, *ptoj;
-  mp_bitcnt_t n, h, j;  /* unsigned type, which is >= unsigned long */
+  mp_bitcnt_t n;  /* unsigned type, which is >= unsigned long */
+  unsigned long N, M;
+  mpz_ptr S, Q, B;
+  mpfr_atan_aux_data data;
   mpfr_exp_t diff, expo;
-  int im, i, k, l, done;
-  mpfr_prec_t mult;
-  mpfr_prec_t accu[MPFR_PREC_BITS], log2_nb_terms[MPFR_PREC_BITS];
   mpfr_prec_t precy = MPFR_PREC(y);
+  double m;
+  long s, g, l, w;
 
   MPFR_ASSERTD(mpz_cmp_ui (p, 0) != 0);
-  MPFR_ASSERTD (m+1 <= MPFR_PREC_BITS);
-
-  /* Set Tables */
-  S    = tab;           /* S */
-  ptoj = S + 1*(m+1);   /* p^2^j Precomputed table */
-  Q    = S + 2*(m+1);   /* Product of Odd integer  table  */
 
   /* From p to p^2, and r to 2r */
   mpz_mul (p, p, p);
@@ -69,140 +117,170 @@ mpfr_atan_aux (mpfr_ptr y, mpz_ptr p, long r, int m, mpz_t *tab)
   /* since |p/2^r| < 1, and p is a non-zero integer, necessarily r > 0 */
 
   MPFR_ASSERTD (mpz_sgn (p) > 0);
-  MPFR_ASSERTD (m > 0);
-
-  /* check if p=1 (special case) */
-  l = 0;
-  /*
-    We compute by binary splitting, with X = x^2 = p/2^r:
-    P(a,b) = p if a+1=b, P(a,c)*P(c,b) otherwise
-    Q(a,b) = (2a+1)*2^r if a+1=b [except Q(0,1)=1], Q(a,c)*Q(c,b) otherwise
-    S(a,b) = p*(2a+1) if a+1=b, Q(c,b)*S(a,c)+Q(a,c)*P(a,c)*S(c,b) otherwise
-    Then atan(x)/x ~ S(0,i)/Q(0,i) for i so that (p/2^r)^i/i is small enough.
-    The factor 2^(r*(b-a)) in Q(a,b) is implicit, thus we have to take it
-    into account when we compute with Q.
-  */
-  accu[0] = 0; /* accu[k] = Mult[0] + ... + Mult[k], where Mult[j] is the
-                  number of bits of the corresponding term S[j]/Q[j] */
-  if (mpz_cmp_ui (p, 1) != 0)
-    {
-      /* p <> 1: precompute ptoj table */
-      mpz_set (ptoj[0], p);
-      for (im = 1 ; im <= m ; im ++)
-        mpz_mul (ptoj[im], ptoj[im - 1], ptoj[im - 1]);
-      /* main loop */
-      n = 1UL << m;
-      MPFR_ASSERTN (n != 0);  /* no overflow */
-      /* the ith term being X^i/(2i+1) with X=p/2^r, we can stop when
-         p^i/2^(r*i) < 2^(-precy), i.e. r*i > precy + log2(p^i) */
-      for (i = k = done = 0; (i < n) && (done == 0); i += 2, k ++)
-        {
-          /* initialize both S[k],Q[k] and S[k+1],Q[k+1] */
-          mpz_set_ui (Q[k+1], 2 * i + 3); /* Q(i+1,i+2) */
-          mpz_mul_ui (S[k+1], p, 2 * i + 1); /* S(i+1,i+2) */
-          mpz_mul_2exp (S[k], Q[k+1], r);
-          mpz_sub (S[k], S[k], S[k+1]); /* S(i,i+2) */
-          mpz_mul_ui (Q[k], Q[k+1], 2 * i + 1); /* Q(i,i+2) */
-          log2_nb_terms[k] = 1; /* S[k]/Q[k] corresponds to 2 terms */
-          for (j = (i + 2) >> 1, l = 1; (j & 1) == 0; l ++, j >>= 1, k --)
-            {
-              /* invariant: S[k-1]/Q[k-1] and S[k]/Q[k] correspond
-                 to 2^l terms each. We combine them into S[k-1]/Q[k-1] */
-              MPFR_ASSERTD (k > 0);
-              mpz_mul (S[k], S[k], Q[k-1]);
-              mpz_mul (S[k], S[k], ptoj[l]);
-              mpz_mul (S[k-1], S[k-1], Q[k]);
-              mpz_mul_2exp (S[k-1], S[k-1], r << l);
-              mpz_add (S[k-1], S[k-1], S[k]);
-              mpz_mul (Q[k-1], Q[k-1], Q[k]);
-              log2_nb_terms[k-1] = l + 1;
-              /* now S[k-1]/Q[k-1] corresponds to 2^(l+1) terms */
-              MPFR_MPZ_SIZEINBASE2(mult, ptoj[l+1]);
-              mult = (r << (l + 1)) - mult - 1;
-              accu[k-1] = (k == 1) ? mult : accu[k-2] + mult;
-              if (accu[k-1] > precy)
-                done = 1;
-            }
-        }
-    }
-  else /* special case p=1: the ith term being X^i/(2i+1) with X=1/2^r,
-          we can stop when r*i > precy i.e. i > precy/r */
-    {
-      n = 1UL << m;
-      MPFR_ASSERTN (n != 0);  /* no overflow */
-      for (i = k = 0; (i < n) && (i <= precy / r); i += 2, k ++)
-        {
-          mpz_set_ui (Q[k + 1], 2 * i + 3);
-          mpz_mul_2exp (S[k], Q[k+1], r);
-          mpz_sub_ui (S[k], S[k], 1 + 2 * i);
-          mpz_mul_ui (Q[k], Q[k + 1], 1 + 2 * i);
-          log2_nb_terms[k] = 1; /* S[k]/Q[k] corresponds to 2 terms */
-          for (j = (i + 2) >> 1, l = 1; (j & 1) == 0; l++, j >>= 1, k --)
-            {
-              MPFR_ASSERTD (k > 0);
-              mpz_mul (S[k], S[k], Q[k-1]);
-              mpz_mul (S[k-1], S[k-1], Q[k]);
-              mpz_mul_2exp (S[k-1], S[k-1], r << l);
-              mpz_add (S[k-1], S[k-1], S[k]);
-              mpz_mul (Q[k-1], Q[k-1], Q[k]);
-              log2_nb_terms[k-1] = l + 1;
-            }
-        }
-    }
 
-  /* we need to combine S[0]/Q[0]...S[k-1]/Q[k-1] */
-  h = 0; /* number of terms accumulated in S[k]/Q[k] */
-  while (k > 1)
+  /* Lower bound of g in 1/8 bits: p >= m*2^s with m in [1/2,1) rounded
+     toward zero by mpz_get_d_2exp, thus p < m'*2^s with m' = m*(1+2^(-40))
+     and log2(p) < s + c/8, where c = ceil(log2(m'^8)) <= 1. The three
+     squarings below have a relative error much less than 2^(-40). With
+     respect to g >= r - s, this saves up to 20% of the terms when p has
+     only a few bits, which is the most expensive call. */
+  m = mpz_get_d_2exp (&s, p);
+  m += m / 1099511627776.0; /* 2^40 */
+  m = m * m;
+  m = m * m;
+  m = m * m;
+  g = 8 * (r - s) - __gmpfr_ceil_log2 (m);
+  MPFR_ASSERTD (g >= 1);
+  N = (8 * (unsigned long) precy + 8 + g - 1) / g;
+
+  /* the pairs of index 1 to M-1, where M = ceil(N/2) >= 1; since
+     p < 2^r and 4j+3 < 2^l for j < M, a(j) < 2^(r+l), b(j) < 2^(2l)
+     and p^2 < 2^(2s) */
+  M = N / 2 + (N & 1);
+  l = MPFR_INT_CEIL_LOG2 (4 * M);
+  data.p = p;
+  data.r = r;
+  w = sizeof (unsigned long) * CHAR_BIT;
+  data.small = r + l <= w && 2 * l <= w && 2 * s <= w;
+  if (data.small)
     {
-      k --;
-      /* combine S[k-1]/Q[k-1] and S[k]/Q[k] */
-      mpz_mul (S[k], S[k], Q[k-1]);
-      if (mpz_cmp_ui (p, 1) != 0)
-        mpz_mul (S[k], S[k], ptoj[log2_nb_terms[k-1]]);
-      mpz_mul (S[k-1], S[k-1], Q[k]);
-      h += (mp_bitcnt_t) 1 << log2_nb_terms[k];
-      mpz_mul_2exp (S[k-1], S[k-1], r * h);
-      mpz_add (S[k-1], S[k-1], S[k]);
-      mpz_mul (Q[k-1], Q[k-1], Q[k]);
+      data.pu = mpz_get_ui (p);
+      data.p2u = data.pu * data.pu;
     }
-
-  MPFR_MPZ_SIZEINBASE2 (diff, S[0]);
+  mpfr_bsplit (bs, mpfr_atan_aux_term, &data,
+               MPFR_BSPLIT_WITH_A | MPFR_BSPLIT_WITH_B | MPFR_BSPLIT_POW,
+               1, M, 0);
+
+  /* S <- (3*2^r - p)*B*Q*2^e + 3*T and B <- 3*B, using P (not needed
+     here) and Q = 1 (since q(j) = 2^(2r)) as temporary storage, so that
+     atan(x)/x ~ S/(B*2^(e+r)) */
+  S = MPFR_BSPLIT_P (bs);
+  Q = MPFR_BSPLIT_Q (bs);
+  B = MPFR_BSPLIT_B (bs);
+  MPFR_ASSERTD (mpz_cmp_ui (Q, 1) == 0);
+  mpz_set_ui (Q, 3);
+  mpz_mul_2exp (Q, Q, r);
+  mpz_sub (Q, Q, p);
+  mpz_mul (S, B, Q);
+  mpz_mul_2exp (S, S, MPFR_BSPLIT_E (bs));
+  mpz_addmul_ui (S, MPFR_BSPLIT_T (bs), 3);
+  mpz_mul_ui (B, B, 3);
+
+  MPFR_MPZ_SIZEINBASE2 (diff, S);
   diff -= 2 * precy;
   expo = diff;
   if (diff >= 0)
-    mpz_tdiv_q_2exp (S[0], S[0], diff);
+    mpz_tdiv_q_2exp (S, S, diff);
   else
-    mpz_mul_2exp (S[0], S[0], -diff);
+    mpz_mul_2exp (S, S, -diff);
 
-  MPFR_MPZ_SIZEINBASE2 (diff, Q[0]);
+  MPFR_MPZ_SIZEINBASE2 (diff, B);
   diff -= precy;
   expo -= diff;
   if (diff >= 0)
-    mpz_tdiv_q_2exp (Q[0], Q[0], diff);
+    mpz_tdiv_q_2exp (B, B, diff);
   else
-    mpz_mul_2exp (Q[0], Q[0], -diff);
+    mpz_mul_2exp (B, B, -diff);
 
-  mpz_tdiv_q (S[0], S[0], Q[0]);
-  mpfr_set_z (y, S[0], MPFR_RNDD);
+  mpz_tdiv_q (S, S, B);
+  mpfr_set_z (y, S, MPFR_RNDD);
   /* TODO: Check/prove that the following expression doesn't overflow. */
-  expo = MPFR_GET_EXP (y) + expo - r * (i - 1);
+  expo = MPFR_GET_EXP (y) + expo - (mpfr_exp_t) MPFR_BSPLIT_E (bs) - r;
   MPFR_SET_EXP (y, expo);
 }
 
+#ifndef MPFR_ATAN_CACHE_LIMBS
+# define MPFR_ATAN_CACHE_LIMBS 256
+#endif
+
+/* Per-thread cache of the integers used by mpfr_atan_aux, so that their
+   memory is reused by the next calls instead of being allocated and freed
+   each time. Only the memory is reused, not the values: all of them
+   depend on x, including the products of the b(j), since the number of
+   terms depends on x. They are kept only when the working precision is at
+   most MPFR_ATAN_CACHE_LIMBS limbs, to bound the memory used. A zero
+   mpfr_bsplit_t is initialized, see mpfr_bsplit_init. */
+static MPFR_THREAD_ATTR mpfr_bsplit_t atan_bs;
+
+void
+mpfr_atan_freecache (void)
+{
+  mpfr_bsplit_clear (atan_bs);
+}
+
+/* Put in atan an approximation of atan(x) for x > 1, using
+   atan(x) = Pi/2 - atan(u) with u = 1/x, where
+   atan(u) = u * (1 - v/3 + v^2/5 - ... + (-v)^(n-1)/(2n-1)) + err
+   with v = u^2 and |err| <= u^(2n+1)/(2n+1). This needs only n-1
+   multiplications and the (cached) value of Pi, thus is much faster than
+   the binary splitting below when n is small, i.e., for large x.
+   Assumes EXP(x) >= 2, thus u < 1/2, and that n terms are enough for the
+   precision w of atan, i.e., 2n*(EXP(x)-1) >= w (then |err| < 2^(-w-1)).
+
+   Let e = 2^(-w). u has relative error at most e, and v at most 3e.
+   We compute t[n-1] = 1/(2n-1) and t[k] = 1/(2k+1) - v*t[k+1] in Horner
+   form: since 0 <= v*t[k+1] < (1/4)*(1/(2k+1)), if t[k+1] has relative
+   error d, then t[k] has relative error at most e + (4/3)*e + (d+4e)/3,
+   which gives d < 6e for all k. Then s = u*t[0] <= u < 1/2 has relative
+   error at most 8e, and atan = Pi/2 - s in [1, 2) has an error at most
+   ulp(Pi/2)/2 + 8e*s + |err| + ulp(atan)/2 <= 2^(-w) * (1 + 4 + 1/2 + 1)
+   < 2^(3-w) = 2^(EXP(atan)+2-w). */
+static void
+mpfr_atan_large (mpfr_ptr atan, mpfr_srcptr x, unsigned long n)
+{
+  mpfr_t u, v, t;
+  mpfr_prec_t w;
+  unsigned long k;
+
+  MPFR_ASSERTD (MPFR_IS_POS (x) && MPFR_GET_EXP (x) >= 2 && n >= 1);
+
+  w = MPFR_PREC (atan);
+  mpfr_init2 (u, w);
+  mpfr_init2 (v, w);
+  mpfr_init2 (t, w);
+
+  mpfr_ui_div (u, 1, x, MPFR_RNDN);
+  mpfr_set_ui (t, 1, MPFR_RNDN);
+  if (n > 1) /* then v cannot underflow, since 2*(EXP(x)-1) < w */
+    {
+      mpfr_sqr (v, u, MPFR_RNDN);
+      mpfr_div_ui (t, t, 2 * n - 1, MPFR_RNDN);
+    }
+  for (k = n - 1; k-- > 0; )
+    {
+      mpfr_mul (t, t, v, MPFR_RNDN);
+      mpfr_set_ui (atan, 1, MPFR_RNDN);
+      mpfr_div_ui (atan, atan, 2 * k + 1, MPFR_RNDN);
+      mpfr_sub (t, atan, t, MPFR_RNDN);
+    }
+  mpfr_mul (u, u, t, MPFR_RNDN);
+
+  mpfr_const_pi (atan, MPFR_RNDN);
+  mpfr_div_2ui (atan, atan, 1, MPFR_RNDN);
+  mpfr_sub (atan, atan, u, MPFR_RNDN);
+
+  mpfr_clear (u);
+  mpfr_clear (v);
+  mpfr_clear (t);
+}
+
+/* maximal number of terms of mpfr_atan_large, see mpfr_atan */
+static MPFR_TUNE_TAB_CONST short atan_large_tab[] = { MPFR_ATAN_LARGE_TAB };
+
 int
 mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
   mpfr_t xp, arctgt, sk, tmp, tmp2;
   mpz_t  ukz;
-  mpz_t tabz[3*(MPFR_PREC_BITS+1)];
   mpfr_exp_t exptol;
   mpfr_prec_t prec, realprec, est_lost, lost;
   unsigned long twopoweri, log2p, red;
   int comparaison, inexact;
-  int i, n0, oldn0;
+  int i, n0;
   MPFR_GROUP_DECL (group);
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
+  MPFR_LATENCY_FUNC (MPFR_PREC (atan));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
@@ -269,13 +347,44 @@ mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       return mpfr_check_range (atan, inexact, rnd_mode);
     }
 
+  /* For large |x|, use the series of atan(1/|x|) when it has at most
+     the number of terms given by MPFR_ATAN_LARGE_TAB for the working
+     precision, see mpfr_atan_large. In the unlikely case of a Ziv
+     failure, we keep using it with more terms. */
+  MPFR_STAT_STATIC_ASSERT (numberof (atan_large_tab) == MPFR_PREC_TAB_SIZE);
+  if (comparaison > 0 && MPFR_GET_EXP (xp) >= 2)
+    {
+      mpfr_uexp_t e2 = 2 * (mpfr_uexp_t) (MPFR_GET_EXP (xp) - 1);
+
+      prec = MPFR_PREC (atan) + 5;
+      if (((mpfr_uexp_t) prec + e2 - 1) / e2
+          <= (mpfr_uexp_t) atan_large_tab[MPFR_PREC_TAB_INDEX (prec)])
+        {
+          MPFR_GROUP_INIT_1 (group, prec, arctgt);
+          MPFR_ZIV_INIT (loop, prec);
+          for (;;)
+            {
+              mpfr_atan_large (arctgt, xp, ((mpfr_uexp_t) prec + e2 - 1) / e2);
+              if (MPFR_LIKELY (MPFR_CAN_ROUND (arctgt, prec - 2,
+                                               MPFR_PREC (atan), rnd_mode)))
+                break;
+              MPFR_ZIV_NEXT (loop, prec);
+              MPFR_GROUP_REPREC_1 (group, prec, arctgt);
+            }
+          MPFR_ZIV_FREE (loop);
+          inexact = mpfr_set4 (atan, arctgt, rnd_mode, MPFR_SIGN (x));
+          MPFR_GROUP_CLEAR (group);
+          MPFR_SAVE_EXPO_FREE (expo);
+          return mpfr_check_range (atan, inexact, rnd_mode);
+        }
+    }
+
   realprec = MPFR_PREC (atan) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (atan)) + 4;
   prec = realprec + GMP_NUMB_BITS;
 
   /* Initialisation */
   mpz_init2 (ukz, prec); /* ukz will need 'prec' bits below */
   MPFR_GROUP_INIT_4 (group, prec, sk, tmp, tmp2, arctgt);
-  oldn0 = 0;
 
   MPFR_ZIV_INIT (loop, prec);
   for (;;)
@@ -303,13 +412,6 @@ mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
       /* Initialisation */
       MPFR_GROUP_REPREC_4 (group, prec, sk, tmp, tmp2, arctgt);
-      MPFR_ASSERTD (n0 <= MPFR_PREC_BITS);
-      /* Note: the tabz[] entries are used to get a rational approximation
-         of atan(x) to precision 'prec', thus allocating them to 'prec' bits
-         should be good enough. */
-      for (i = oldn0; i < 3 * (n0 + 1); i++)
-        mpz_init2 (tabz[i], prec);
-      oldn0 = 3 * (n0 + 1);
 
       /* The mpfr_ui_div below mustn't underflow. This is guaranteed by
          MPFR_SAVE_EXPO_MARK, but let's check that for maintainability. */
@@ -384,7 +486,7 @@ mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
               /* Calculation of arctan(Ak) */
               mpfr_set_z (tmp, ukz, MPFR_RNDN);
               mpfr_div_2ui (tmp, tmp, twopoweri, MPFR_RNDN);
-              mpfr_atan_aux (tmp2, ukz, twopoweri, n0 - i, tabz);
+              mpfr_atan_aux (tmp2, ukz, twopoweri, atan_bs);
               mpfr_mul (tmp2, tmp2, tmp, MPFR_RNDN);
               /* Addition */
               mpfr_add (arctgt, arctgt, tmp2, MPFR_RNDN);
@@ -419,8 +521,8 @@ mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
   inexact = mpfr_set4 (atan, arctgt, rnd_mode, MPFR_SIGN (x));
 
-  for (i = 0 ; i < oldn0 ; i++)
-    mpz_clear (tabz[i]);
+  if (MPFR_PREC2LIMBS (prec) > MPFR_ATAN_CACHE_LIMBS)
+    mpfr_bsplit_clear (atan_bs);
   mpz_clear (ukz);
   MPFR_GROUP_CLEAR (group);
 
@@ -53,6 +53,7 @@ mpfr_atan2 (mpfr_ptr dest, mpfr_srcptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_exp_t e;
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
+  MPFR_LATENCY_FUNC (MPFR_PREC (dest));
 
   MPFR_LOG_FUNC
     (("y[%Pu]=%.*Rg x[%Pu]=%.*Rg rnd=%d",
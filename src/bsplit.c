@@ -0,0 +1,340 @@
+/* mpfr_bsplit -- binary splitting for hypergeometric-type series
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Cf http://www.ginac.de/CLN/binsplit.pdf. For a series
+     S(n1,n2) = sum(a(n)/b(n) * p(n1)...p(n)/(q(n1)...q(n)), n = n1..n2-1)
+   where the a(n), b(n), p(n), q(n) are integers, mpfr_bsplit computes
+     P = p(n1)...p(n2-1), Q*2^e = q(n1)...q(n2-1), B = b(n1)...b(n2-1),
+   and T such that S(n1,n2) = T/(B*Q*2^e), using the formulas
+     P(n1,n2) = P(n1,m)*P(m,n2),
+     Q(n1,n2) = Q(n1,m)*Q(m,n2), e(n1,n2) = e(n1,m) + e(m,n2),
+     B(n1,n2) = B(n1,m)*B(m,n2),
+     T(n1,n2) = B(m,n2)*Q(m,n2)*2^e(m,n2)*T(n1,m)
+                + B(n1,m)*P(n1,m)*T(m,n2).
+   The power of two of each q(n) is kept apart in e, so that multiplying by
+   it is only a shift: this is the usual case q(n) = q'(n)*2^r for a series
+   at x = p/2^r. Since S(n1,n2) and the ratio P/(Q*2^e) are all that matter,
+   common powers of two of T, P and 2^e are removed as we go.
+
+   The term of index n is given by a function term(P,Q,B,T,f,n,data), which
+   sets P to p(n), Q to q(n), and optionally *f to r when q(n) has an
+   implicit factor 2^r (*f is zero on entry). If MPFR_BSPLIT_WITH_B is set
+   in flags, it also sets B to b(n), otherwise b(n) = 1. If
+   MPFR_BSPLIT_WITH_A is set, it also sets T to a(n)*p(n), otherwise
+   a(n) = 1 and T = p(n).
+
+   If MPFR_BSPLIT_POW is set, p(n) does not depend on n. Then P(n1,n2) only
+   depends on n2-n1, and since the lengths n2-n1 take at most two values at
+   each level of the recursion, we compute each power of p only once, in a
+   table, instead of once per node. In that case P is not stored in the
+   nodes and the integers T, P, 2^e are not trimmed when P is needed, thus
+   p should preferably be odd.
+
+   The number of terms n2-n1 is arbitrary. The integers of the nodes and of
+   the power table are kept in bs from one call to the next one, so that
+   their memory is reused.
+
+   There is no size threshold to tune here: the recursion always goes down
+   to single terms, since merging two one-limb nodes with the fast path of
+   mpfr_bsplit_mul costs the same multiplications as summing them in a
+   loop, and the call overhead is saved by doing the leaves inline; the
+   power of two is removed as soon as T is even, which only costs a shift.
+   Whether binary splitting is used at all is decided by the callers, with
+   MPFR_EXP_THRESHOLD, MPFR_SINCOS_THRESHOLD or MPFR_TRANS_Q_THRESHOLD. */
+
+/* Integers of the node at depth k of the recursion */
+#define BS_P(bs,k) ((bs)->tab[4 * (k)])
+#define BS_Q(bs,k) ((bs)->tab[4 * (k) + 1])
+#define BS_B(bs,k) ((bs)->tab[4 * (k) + 2])
+#define BS_T(bs,k) ((bs)->tab[4 * (k) + 3])
+
+/* Non-zero when the integer z is 1, resp. when |z| = 1. These cases are
+   frequent (q(n) a power of two, p(n) = 1 or -1), and then we avoid a
+   multiplication, which is significant for small integers. */
+#define BS_IS_ONE(z) (SIZ (z) == 1 && PTR (z)[0] == 1)
+#define BS_IS_PM_ONE(z) (ABSIZ (z) == 1 && PTR (z)[0] == 1)
+
+/* r <- a*b, with a fast path when a and b fit in one limb, which is the
+   usual case at the bottom of the recursion, where the cost of mpz_mul is
+   dominated by its overhead */
+static void
+mpfr_bsplit_mul (mpz_ptr r, mpz_srcptr a, mpz_srcptr b)
+{
+  int sa = SIZ (a), sb = SIZ (b);
+
+  if ((sa == 1 || sa == -1) && (sb == 1 || sb == -1) && ALLOC (r) >= 2)
+    {
+      mp_limb_t h, l;
+
+      umul_ppmm (h, l, PTR (a)[0], PTR (b)[0]);
+      PTR (r)[0] = l;
+      PTR (r)[1] = h;
+      SIZ (r) = (h != 0) ? 2 * sa * sb : sa * sb;
+    }
+  else
+    mpz_mul (r, a, b);
+}
+
+void
+mpfr_bsplit_init (mpfr_bsplit_ptr bs)
+{
+  bs->alloc = 0;
+  bs->tab = NULL;
+  bs->e = NULL;
+  bs->pow = NULL;
+  bs->powlen = NULL;
+  bs->npow = 0;
+}
+
+void
+mpfr_bsplit_clear (mpfr_bsplit_ptr bs)
+{
+  int i;
+
+  if (bs->alloc != 0)
+    {
+      for (i = 0; i < 4 * bs->alloc; i++)
+        mpz_clear (bs->tab[i]);
+      for (i = 0; i < 2 * bs->alloc; i++)
+        mpz_clear (bs->pow[i]);
+      (*__gmp_free_func) (bs->tab, 4 * bs->alloc * sizeof (mpz_t));
+      (*__gmp_free_func) (bs->pow, 2 * bs->alloc * sizeof (mpz_t));
+      (*__gmp_free_func) (bs->e, bs->alloc * sizeof (mp_bitcnt_t));
+      (*__gmp_free_func) (bs->powlen, 2 * bs->alloc * sizeof (unsigned long));
+    }
+  mpfr_bsplit_init (bs);
+}
+
+/* Make sure bs has at least n levels */
+static void
+mpfr_bsplit_grow (mpfr_bsplit_ptr bs, int n)
+{
+  int i, old = bs->alloc;
+
+  if (n <= old)
+    return;
+  if (old == 0)
+    {
+      bs->tab = (mpz_t *) (*__gmp_allocate_func) (4 * n * sizeof (mpz_t));
+      bs->pow = (mpz_t *) (*__gmp_allocate_func) (2 * n * sizeof (mpz_t));
+      bs->e = (mp_bitcnt_t *) (*__gmp_allocate_func)
+        (n * sizeof (mp_bitcnt_t));
+      bs->powlen = (unsigned long *) (*__gmp_allocate_func)
+        (2 * n * sizeof (unsigned long));
+    }
+  else
+    {
+      bs->tab = (mpz_t *) (*__gmp_reallocate_func)
+        (bs->tab, 4 * old * sizeof (mpz_t), 4 * n * sizeof (mpz_t));
+      bs->pow = (mpz_t *) (*__gmp_reallocate_func)
+        (bs->pow, 2 * old * sizeof (mpz_t), 2 * n * sizeof (mpz_t));
+      bs->e = (mp_bitcnt_t *) (*__gmp_reallocate_func)
+        (bs->e, old * sizeof (mp_bitcnt_t), n * sizeof (mp_bitcnt_t));
+      bs->powlen = (unsigned long *) (*__gmp_reallocate_func)
+        (bs->powlen, 2 * old * sizeof (unsigned long),
+         2 * n * sizeof (unsigned long));
+    }
+  for (i = 4 * old; i < 4 * n; i++)
+    mpz_init (bs->tab[i]);
+  for (i = 2 * old; i < 2 * n; i++)
+    mpz_init (bs->pow[i]);
+  bs->alloc = n;
+}
+
+/* Return p^l, with MPFR_BSPLIT_POW, where l is the length of a node.
+   The entry l = 1 is set by the first leaf. */
+static mpz_srcptr
+mpfr_bsplit_pow (mpfr_bsplit_ptr bs, unsigned long l)
+{
+  mpz_srcptr a, b;
+  int i;
+
+  for (i = 0; i < bs->npow; i++)
+    if (bs->powlen[i] == l)
+      return bs->pow[i];
+  MPFR_ASSERTD (l > 1);
+  a = mpfr_bsplit_pow (bs, l / 2);
+  b = mpfr_bsplit_pow (bs, l - l / 2);
+  /* at most two lengths per level, thus the table cannot be full */
+  MPFR_ASSERTN (bs->npow < 2 * bs->alloc);
+  i = bs->npow++;
+  bs->powlen[i] = l;
+  mpfr_bsplit_mul (bs->pow[i], a, b);
+  return bs->pow[i];
+}
+
+/* Remove the common power of two of T, P (when needed) and 2^e, where e > 0
+   and T is even */
+static void
+mpfr_bsplit_trim (mpfr_bsplit_ptr bs, int k, int need_P)
+{
+  mp_bitcnt_t v, w;
+
+  v = bs->e[k];
+  if (need_P && (bs->flags & MPFR_BSPLIT_POW))
+    return;
+  w = mpz_scan1 (BS_T (bs, k), 0); /* ~0 if T = 0 */
+  if (w < v)
+    v = w;
+  if (need_P)
+    {
+      w = mpz_scan1 (BS_P (bs, k), 0);
+      if (w < v)
+        v = w;
+    }
+  if (v > 0)
+    {
+      mpz_tdiv_q_2exp (BS_T (bs, k), BS_T (bs, k), v); /* exact */
+      if (need_P)
+        mpz_tdiv_q_2exp (BS_P (bs, k), BS_P (bs, k), v); /* exact */
+      bs->e[k] -= v;
+    }
+}
+
+/* Set the node at depth k to the term of index n */
+static void
+mpfr_bsplit_leaf (mpfr_bsplit_ptr bs, int k, unsigned long n, int need_P)
+{
+  int flags = bs->flags;
+  /* without a(n), T = p(n), thus we let term set T directly */
+  mpz_ptr P = (flags & MPFR_BSPLIT_WITH_A) ? BS_P (bs, k) : BS_T (bs, k);
+  mpz_ptr Q = BS_Q (bs, k);
+
+  bs->e[k] = 0;
+  (*bs->term) (P, Q, BS_B (bs, k), BS_T (bs, k), &bs->e[k], n, bs->data);
+  if (P != BS_P (bs, k) && need_P && (flags & MPFR_BSPLIT_POW) == 0)
+    mpz_set (BS_P (bs, k), P);
+  if ((flags & MPFR_BSPLIT_POW) && bs->npow == 0)
+    {
+      bs->npow = 1;
+      bs->powlen[0] = 1;
+      mpz_set (bs->pow[0], P);
+    }
+  /* move the power of two of q(n) into e */
+  MPFR_ASSERTD (mpz_sgn (Q) != 0);
+  if (ABSIZ (Q) == 1)
+    {
+      mp_limb_t q = PTR (Q)[0];
+      int c;
+
+      /* usual case, avoid the GMP calls */
+      count_trailing_zeros (c, q);
+      PTR (Q)[0] = q >> c;
+      bs->e[k] += c;
+    }
+  else if (mpz_even_p (Q))
+    {
+      mp_bitcnt_t v = mpz_scan1 (Q, 0);
+
+      mpz_tdiv_q_2exp (Q, Q, v); /* exact */
+      bs->e[k] += v;
+    }
+  if (bs->e[k] != 0 && mpz_even_p (BS_T (bs, k)))
+    mpfr_bsplit_trim (bs, k, need_P);
+}
+
+/* Set the node at depth k to the terms of index n1 to n2-1, n2-n1 >= 2 */
+static void
+mpfr_bsplit_rec (mpfr_bsplit_ptr bs, int k, unsigned long n1,
+                 unsigned long n2, int need_P)
+{
+  int flags = bs->flags;
+  /* m = floor((n1+n2)/2) */
+  unsigned long m = (n1 / 2) + (n2 / 2) + (n1 & 1UL & n2);
+  mpz_srcptr P0;
+
+  MPFR_ASSERTD (n1 < m && m < n2 && k + 1 < bs->alloc);
+  /* the leaves are done here, to save a recursive call */
+  if (m == n1 + 1)
+    mpfr_bsplit_leaf (bs, k, n1, 1);
+  else
+    mpfr_bsplit_rec (bs, k, n1, m, 1);
+  if (n2 == m + 1)
+    mpfr_bsplit_leaf (bs, k + 1, m, need_P);
+  else
+    mpfr_bsplit_rec (bs, k + 1, m, n2, need_P);
+  P0 = (flags & MPFR_BSPLIT_POW) ? mpfr_bsplit_pow (bs, m - n1)
+    : BS_P (bs, k);
+
+  /* T0 <- T0*B1*Q1*2^e1 + B0*P0*T1 */
+  if (!BS_IS_ONE (BS_Q (bs, k + 1)))
+    mpfr_bsplit_mul (BS_T (bs, k), BS_T (bs, k), BS_Q (bs, k + 1));
+  if (!BS_IS_PM_ONE (P0))
+    mpfr_bsplit_mul (BS_T (bs, k + 1), BS_T (bs, k + 1), P0);
+  else if (SIZ (P0) < 0)
+    mpz_neg (BS_T (bs, k + 1), BS_T (bs, k + 1));
+  if (flags & MPFR_BSPLIT_WITH_B)
+    {
+      mpfr_bsplit_mul (BS_T (bs, k), BS_T (bs, k), BS_B (bs, k + 1));
+      mpfr_bsplit_mul (BS_T (bs, k + 1), BS_T (bs, k + 1), BS_B (bs, k));
+      mpfr_bsplit_mul (BS_B (bs, k), BS_B (bs, k), BS_B (bs, k + 1));
+    }
+  mpz_mul_2exp (BS_T (bs, k), BS_T (bs, k), bs->e[k + 1]);
+  mpz_add (BS_T (bs, k), BS_T (bs, k), BS_T (bs, k + 1));
+  if (need_P && (flags & MPFR_BSPLIT_POW) == 0)
+    mpfr_bsplit_mul (BS_P (bs, k), BS_P (bs, k), BS_P (bs, k + 1));
+  if (!BS_IS_ONE (BS_Q (bs, k + 1)))
+    mpfr_bsplit_mul (BS_Q (bs, k), BS_Q (bs, k), BS_Q (bs, k + 1));
+  bs->e[k] += bs->e[k + 1];
+  if (bs->e[k] != 0 && mpz_even_p (BS_T (bs, k)))
+    mpfr_bsplit_trim (bs, k, need_P);
+}
+
+/* Compute the terms of index n1 to n2-1 (n1 <= n2) of the series given by
+   term, data and flags (see above). The result is in MPFR_BSPLIT_T(bs),
+   MPFR_BSPLIT_Q(bs), MPFR_BSPLIT_E(bs), MPFR_BSPLIT_B(bs) when
+   MPFR_BSPLIT_WITH_B is set, and MPFR_BSPLIT_P(bs) when need_P is non-zero.
+   For n1 = n2, this gives the empty sum T = 0, with P = Q = B = 1 and
+   e = 0, so that the caller does not need a special case. */
+void
+mpfr_bsplit (mpfr_bsplit_ptr bs, mpfr_bsplit_term_t term, void *data,
+             int flags, unsigned long n1, unsigned long n2, int need_P)
+{
+  MPFR_ASSERTN (n1 <= n2);
+  if (n1 == n2)
+    {
+      mpfr_bsplit_grow (bs, 1);
+      mpz_set_ui (BS_P (bs, 0), 1);
+      mpz_set_ui (BS_Q (bs, 0), 1);
+      mpz_set_ui (BS_B (bs, 0), 1);
+      mpz_set_ui (BS_T (bs, 0), 0);
+      bs->e[0] = 0;
+      return;
+    }
+  /* the depth of the recursion is ceil(log2(n2-n1)) */
+  mpfr_bsplit_grow (bs, MPFR_INT_CEIL_LOG2 (n2 - n1) + 1);
+  bs->term = term;
+  bs->data = data;
+  bs->flags = flags;
+  bs->npow = 0;
+  if ((flags & MPFR_BSPLIT_WITH_B) == 0)
+    mpz_set_ui (BS_B (bs, 0), 1);
+  if (n2 == n1 + 1)
+    mpfr_bsplit_leaf (bs, 0, n1, need_P);
+  else
+    mpfr_bsplit_rec (bs, 0, n1, n2, need_P);
+  if (need_P && (flags & MPFR_BSPLIT_POW))
+    mpz_set (BS_P (bs, 0), mpfr_bsplit_pow (bs, n2 - n1));
+}
@@ -53,21 +53,14 @@ mpfr_clear_cache (mpfr_cache_t cache)
     }
 }
 
-int
-mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
+/* Make sure that the precision of the cache is at least prec, and return
+   it. The cache must be locked in read-only mode, and it is still locked
+   in read-only mode on return. The exponent range must be extended. */
+static mpfr_prec_t
+mpfr_cache_extend (mpfr_cache_t cache, mpfr_prec_t prec)
 {
-  mpfr_prec_t prec = MPFR_PREC (dest);
   mpfr_prec_t pold;
-  int inexact, sign;
-  MPFR_SAVE_EXPO_DECL (expo);
-
-  /* Call the initialisation function of the cache if it's needed */
-  MPFR_DEFERRED_INIT_CALL(cache);
-
-  MPFR_SAVE_EXPO_MARK (expo);
 
-  /* Get the cache in read-only mode */
-  MPFR_LOCK_READ(cache->lock);
   /* Read the precision within the cache */
   pold = MPFR_PREC (cache->x);
   if (MPFR_UNLIKELY (prec > pold))
@@ -104,6 +97,26 @@ mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
       MPFR_LOCK_WRITE2READ(cache->lock);
     }
 
+  return pold;
+}
+
+int
+mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
+{
+  mpfr_prec_t prec = MPFR_PREC (dest);
+  mpfr_prec_t pold;
+  int inexact, sign;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  /* Call the initialisation function of the cache if it's needed */
+  MPFR_DEFERRED_INIT_CALL(cache);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* Get the cache in read-only mode */
+  MPFR_LOCK_READ(cache->lock);
+  pold = mpfr_cache_extend (cache, prec);
+
   /* now pold >= prec is the precision of cache->x */
   MPFR_ASSERTD (pold >= prec);
   MPFR_ASSERTD (MPFR_PREC (cache->x) == pold);
@@ -188,3 +201,72 @@ mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
 
   return mpfr_check_range (dest, inexact, rnd);
 }
+
+/* Set z to the integer formed by the n bits of the cached constant c of
+   weights 2^(e-1) down to 2^(e-n), i.e., z = floor(c*2^(n-e)) mod 2^n.
+   The cache is first extended so that its error is less than 2^(e-n-1),
+   thus z differs by at most 1 (modulo 2^n) from the integer obtained from
+   the exact value of the constant. Apart from the extension of the cache,
+   the cost is O(n), whatever the value of e: this is used for example to
+   extract a window of bits from a long expansion of 2/Pi in the
+   Payne-Hanek argument reduction (see reduce_pi.c). */
+void
+mpfr_cache_window (mpz_ptr z, mpfr_cache_t cache, mpfr_exp_t e,
+                   mpfr_prec_t n)
+{
+  mpfr_prec_t pold;
+  mpfr_exp_t i0, i1;
+  mp_size_t xn, lo, hi, k;
+  int sh;
+  mp_limb_t *zp;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_ASSERTD (n >= 1);
+
+  MPFR_DEFERRED_INIT_CALL(cache);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* Get the cache in read-only mode */
+  MPFR_LOCK_READ(cache->lock);
+
+  /* we need the exponent of the constant to know the required precision */
+  mpfr_cache_extend (cache, MPFR_PREC_MIN);
+  MPFR_ASSERTN (MPFR_IS_POS (cache->x));
+
+  /* the bit of weight 2^(e-1) (resp. 2^(e-n)) is bit i0 (resp. i1) of the
+     significand of cache->x, counting from 1 for the most significant bit */
+  i0 = MPFR_GET_EXP (cache->x) - e + 1;
+  i1 = i0 + n - 1;
+
+  if (i1 <= 0)
+    mpz_set_ui (z, 0);
+  else
+    {
+      pold = mpfr_cache_extend (cache, i1 + 1);
+      xn = MPFR_PREC2LIMBS (pold);
+
+      /* the bits to extract are those of positions xn*GMP_NUMB_BITS-i1 to
+         xn*GMP_NUMB_BITS-i0 in the limb array, counting from 0 */
+      lo = ((mpfr_exp_t) xn * GMP_NUMB_BITS - i1) / GMP_NUMB_BITS;
+      sh = ((mpfr_exp_t) xn * GMP_NUMB_BITS - i1) % GMP_NUMB_BITS;
+      hi = i0 <= 1 ? xn - 1
+        : ((mpfr_exp_t) xn * GMP_NUMB_BITS - i0) / GMP_NUMB_BITS;
+      k = hi - lo + 1;
+
+      mpz_realloc2 (z, (mp_bitcnt_t) k * GMP_NUMB_BITS);
+      zp = PTR(z);
+      if (sh != 0)
+        mpn_rshift (zp, MPFR_MANT (cache->x) + lo, k, sh);
+      else
+        MPN_COPY (zp, MPFR_MANT (cache->x) + lo, k);
+      MPN_NORMALIZE (zp, k);
+      SIZ(z) = k;
+      mpz_fdiv_r_2exp (z, z, n);
+    }
+
+  /* Free the cache in read-only mode */
+  MPFR_UNLOCK_READ(cache->lock);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+}
@@ -41,43 +41,25 @@ mpfr_const_catalan (mpfr_ptr x, mpfr_rnd_t rnd_mode) {
   return mpfr_cache (x, __gmpfr_cache_const_catalan, rnd_mode);
 }
 
-/* return T, Q such that T/Q = sum(k!^2/(2k)!/(2k+1)^2, k=n1..n2-1) */
+/* Term of index n of the series sum(k!^2/(2k)!/(2k+1)^2, k=0..infinity),
+   with p(0)/q(0) = 1 and p(n)/q(n) = (2n-1)*n/(2*(2n+1)^2) for n >= 1,
+   see mpfr_bsplit. */
 static void
-S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2)
+catalan_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T, mp_bitcnt_t *f,
+              unsigned long n, void *data)
 {
-  if (n2 == n1 + 1)
+  (void) B; (void) T; (void) data; /* no a(n), b(n), nor data */
+  if (n == 0)
     {
-      if (n1 == 0)
-        {
-          mpz_set_ui (P, 1);
-          mpz_set_ui (Q, 1);
-        }
-      else
-        {
-          mpz_set_ui (P, 2 * n1 - 1);
-          mpz_mul_ui (P, P, n1);
-          mpz_ui_pow_ui (Q, 2 * n1 + 1, 2);
-          mpz_mul_2exp (Q, Q, 1);
-        }
-      mpz_set (T, P);
+      mpz_set_ui (P, 1);
+      mpz_set_ui (Q, 1);
     }
   else
     {
-      unsigned long m = (n1 + n2) / 2;
-      mpz_t T2, P2, Q2;
-      S (T, P, Q, n1, m);
-      mpz_init (T2);
-      mpz_init (P2);
-      mpz_init (Q2);
-      S (T2, P2, Q2, m, n2);
-      mpz_mul (T, T, Q2);
-      mpz_mul (T2, T2, P);
-      mpz_add (T, T, T2);
-      mpz_mul (P, P, P2);
-      mpz_mul (Q, Q, Q2);
-      mpz_clear (T2);
-      mpz_clear (P2);
-      mpz_clear (Q2);
+      mpz_set_ui (P, 2 * n - 1);
+      mpz_mul_ui (P, P, n);
+      mpz_ui_pow_ui (Q, 2 * n + 1, 2);
+      *f = 1;
     }
 }
 
@@ -93,7 +75,7 @@ int
 mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
 {
   mpfr_t x, y, z;
-  mpz_t T, P, Q;
+  mpfr_bsplit_t bs;
   mpfr_prec_t pg, p;
   int inex;
   MPFR_ZIV_DECL (loop);
@@ -124,9 +106,7 @@ mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
   p = pg + MPFR_INT_CEIL_LOG2 (pg) + 7;
 
   MPFR_GROUP_INIT_3 (group, p, x, y, z);
-  mpz_init (T);
-  mpz_init (P);
-  mpz_init (Q);
+  mpfr_bsplit_init (bs);
 
   MPFR_ZIV_INIT (loop, p);
   for (;;) {
@@ -135,11 +115,12 @@ mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
     mpfr_log (x, x, MPFR_RNDU);
     mpfr_const_pi (y, MPFR_RNDU);
     mpfr_mul (x, x, y, MPFR_RNDN);
-    S (T, P, Q, 0, (p - 1) / 2);
-    mpz_mul_ui (T, T, 3);
-    mpfr_set_z (y, T, MPFR_RNDU);
-    mpfr_set_z (z, Q, MPFR_RNDD);
+    mpfr_bsplit (bs, catalan_term, NULL, 0, 0, (p - 1) / 2, 0);
+    mpz_mul_ui (MPFR_BSPLIT_T (bs), MPFR_BSPLIT_T (bs), 3);
+    mpfr_set_z (y, MPFR_BSPLIT_T (bs), MPFR_RNDU);
+    mpfr_set_z (z, MPFR_BSPLIT_Q (bs), MPFR_RNDD);
     mpfr_div (y, y, z, MPFR_RNDN);
+    mpfr_div_2ui (y, y, MPFR_BSPLIT_E (bs), MPFR_RNDN); /* exact */
     mpfr_add (x, x, y, MPFR_RNDN);
     mpfr_div_2ui (x, x, 3, MPFR_RNDN);
 
@@ -153,9 +134,7 @@ mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
   inex = mpfr_set (g, x, rnd_mode);
 
   MPFR_GROUP_CLEAR (group);
-  mpz_clear (T);
-  mpz_clear (P);
-  mpz_clear (Q);
+  mpfr_bsplit_clear (bs);
 
   return inex;
 }
@@ -144,47 +144,30 @@ mpfr_const_euler_bs_1 (mpfr_const_euler_bs_t s,
   }
 }
 
+/* Term of index n of the series sum((2k)!^3/(k!^4 8^(2k) (2N)^(2k)), k=0..)
+   divided by 4N, with p(0)/q(0) = 1/(4N) and p(n)/q(n) = (2n-1)^3/(32nN^2)
+   for n >= 1, see mpfr_bsplit. */
 static void
-mpfr_const_euler_bs_2 (mpz_t P, mpz_t Q, mpz_t T,
-                       unsigned long n1, unsigned long n2, unsigned long N,
-                       int cont)
+mpfr_const_euler_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T,
+                       mp_bitcnt_t *f, unsigned long n, void *data)
 {
-  if (n2 - n1 == 1)
+  unsigned long N = *(unsigned long *) data;
+
+  (void) B; (void) T; /* no a(n) nor b(n) */
+  if (n == 0)
     {
-      if (n1 == 0)
-        {
-          mpz_set_ui (P, 1);
-          mpz_set_ui (Q, 4 * N);
-        }
-      else
-        {
-          mpz_set_ui (P, 2 * n1 - 1);
-          mpz_pow_ui (P, P, 3);
-          mpz_set_ui (Q, 32 * n1);
-          mpz_mul_ui (Q, Q, N);
-          mpz_mul_ui (Q, Q, N);
-        }
-      mpz_set (T, P);
+      mpz_set_ui (P, 1);
+      mpz_set_ui (Q, N);
+      *f = 2;
     }
   else
     {
-      mpz_t P2, Q2, T2;
-      unsigned long m = (n1 + n2) / 2;
-
-      mpz_init (P2);
-      mpz_init (Q2);
-      mpz_init (T2);
-      mpfr_const_euler_bs_2 (P, Q, T, n1, m, N, 1);
-      mpfr_const_euler_bs_2 (P2, Q2, T2, m, n2, N, 1);
-      mpz_mul (T, T, Q2);
-      mpz_mul (T2, T2, P);
-      mpz_add (T, T, T2);
-      if (cont)
-        mpz_mul (P, P, P2);
-      mpz_mul (Q, Q, Q2);
-      mpz_clear (P2);
-      mpz_clear (Q2);
-      mpz_clear (T2);
+      mpz_set_ui (P, 2 * n - 1);
+      mpz_pow_ui (P, P, 3);
+      mpz_set_ui (Q, n);
+      mpz_mul_ui (Q, Q, N);
+      mpz_mul_ui (Q, Q, N);
+      *f = 5;
     }
 }
 
@@ -192,6 +175,7 @@ int
 mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 {
   mpfr_const_euler_bs_t sum;
+  mpfr_bsplit_t bs;
   mpz_t t, u, v;
   unsigned long n, N;
   mpfr_prec_t prec, wp, magn;
@@ -204,6 +188,7 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 
   mpfr_init2 (y, wp);
   mpfr_const_euler_bs_init (sum);
+  mpfr_bsplit_init (bs);
   mpz_init (t);
   mpz_init (u);
   mpz_init (v);
@@ -238,13 +223,14 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
       mpz_tdiv_q (v, u, t);
       /* v * 2^-wp = S/I with error < 1 */
 
-      /* C / (D * V) = U where
+      /* T / (Q * 2^e) = U where
          U = (1/(4n)) sum_{k=0}^{2n-1} [(2k)!]^3 / ((k!)^4 8^(2k) (2n)^(2k)) */
-      mpfr_const_euler_bs_2 (sum->C, sum->D, sum->V, 0, 2*n, n, 0);
+      mpfr_bsplit (bs, mpfr_const_euler_term, &n, 0, 0, 2*n, 0);
       mpz_mul (t, sum->Q, sum->Q);
-      mpz_mul (t, t, sum->V);
+      mpz_mul (t, t, MPFR_BSPLIT_T (bs));
       mpz_mul (u, sum->T, sum->T);
-      mpz_mul (u, u, sum->D);
+      mpz_mul (u, u, MPFR_BSPLIT_Q (bs));
+      mpz_mul_2exp (u, u, MPFR_BSPLIT_E (bs));
       mpz_mul_2exp (t, t, wp);
       mpz_tdiv_q (t, t, u);
       /* t * 2^-wp = U/I^2 with error < 1 */
@@ -279,6 +265,7 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
   mpz_clear (u);
   mpz_clear (v);
   mpfr_const_euler_bs_clear (sum);
+  mpfr_bsplit_clear (bs);
 
   return inexact; /* always inexact */
 }
@@ -49,72 +49,34 @@ mpfr_const_log2 (mpfr_ptr x, mpfr_rnd_t rnd_mode) {
   return mpfr_cache (x, __gmpfr_cache_const_log2, rnd_mode);
 }
 
-/* Auxiliary function: Compute the terms from n1 to n2 (excluded)
-   3/4*sum((-1)^n*n!^2/2^n/(2*n+1)!, n = n1..n2-1).
-   Numerator is T[0], denominator is Q[0],
-   Compute P[0] only when need_P is non-zero.
-   Need 1+ceil(log(n2-n1)/log(2)) cells in T[],P[],Q[].
-*/
+/* Term of index n of the series
+   3/4*sum((-1)^n*n!^2/2^n/(2*n+1)!, n = 0..infinity),
+   with p(0)/q(0) = 3/4 and p(n)/q(n) = -n/(4*(2*n+1)) for n >= 1,
+   see mpfr_bsplit. */
 static void
-S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2, int need_P)
+log2_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T, mp_bitcnt_t *f,
+           unsigned long n, void *data)
 {
-  if (n2 == n1 + 1)
+  (void) B; (void) T; (void) data; /* no a(n), b(n), nor data */
+  if (n == 0)
     {
-      if (n1 == 0)
-        mpz_set_ui (P[0], 3);
-      else
-        {
-          mpz_set_ui (P[0], n1);
-          mpz_neg (P[0], P[0]);
-        }
-      if (n1 <= (ULONG_MAX / 4 - 1) / 2)
-        mpz_set_ui (Q[0], 4 * (2 * n1 + 1));
-      else /* to avoid overflow in 4 * (2 * n1 + 1) */
-        {
-          mpz_set_ui (Q[0], n1);
-          mpz_mul_2exp (Q[0], Q[0], 1);
-          mpz_add_ui (Q[0], Q[0], 1);
-          mpz_mul_2exp (Q[0], Q[0], 2);
-        }
-      mpz_set (T[0], P[0]);
+      mpz_set_ui (P, 3);
+      mpz_set_ui (Q, 1);
     }
   else
     {
-      unsigned long m = (n1 / 2) + (n2 / 2) + (n1 & 1UL & n2);
-      unsigned long v, w;
-
-      S (T, P, Q, n1, m, 1);
-      S (T + 1, P + 1, Q + 1, m, n2, need_P);
-      mpz_mul (T[0], T[0], Q[1]);
-      mpz_mul (T[1], T[1], P[0]);
-      mpz_add (T[0], T[0], T[1]);
-      if (need_P)
-        mpz_mul (P[0], P[0], P[1]);
-      mpz_mul (Q[0], Q[0], Q[1]);
-
-      /* remove common trailing zeroes if any */
-      v = mpz_scan1 (T[0], 0);
-      if (v > 0)
+      mpz_set_ui (P, n);
+      mpz_neg (P, P);
+      if (n <= (ULONG_MAX - 1) / 2)
+        mpz_set_ui (Q, 2 * n + 1);
+      else /* to avoid overflow in 2 * n + 1 */
         {
-          w = mpz_scan1 (Q[0], 0);
-          if (w < v)
-            v = w;
-          if (need_P)
-            {
-              w = mpz_scan1 (P[0], 0);
-              if (w < v)
-                v = w;
-            }
-          /* now v = min(val(T), val(Q), val(P)) */
-          if (v > 0)
-            {
-              mpz_fdiv_q_2exp (T[0], T[0], v);
-              mpz_fdiv_q_2exp (Q[0], Q[0], v);
-              if (need_P)
-                mpz_fdiv_q_2exp (P[0], P[0], v);
-            }
+          mpz_set_ui (Q, n);
+          mpz_mul_2exp (Q, Q, 1);
+          mpz_add_ui (Q, Q, 1);
         }
     }
+  *f = 2;
 }
 
 /* Don't need to save / restore exponent range: the cache does it */
@@ -124,12 +86,10 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
   unsigned long n = MPFR_PREC (x);
   mpfr_prec_t w; /* working precision */
   unsigned long N;
-  mpz_t *T, *P, *Q;
+  mpfr_bsplit_t bs;
   mpfr_t t, q;
   int inexact;
-  unsigned long lgN, i;
   MPFR_GROUP_DECL(group);
-  MPFR_TMP_DECL(marker);
   MPFR_ZIV_DECL(loop);
 
   MPFR_LOG_FUNC (
@@ -142,8 +102,8 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
   else
     w = n + 10; /* idem at least for prec < 300000 */
 
-  MPFR_TMP_MARK(marker);
   MPFR_GROUP_INIT_2(group, w, t, q);
+  mpfr_bsplit_init (bs);
 
   MPFR_ZIV_INIT (loop, w);
   for (;;)
@@ -155,29 +115,12 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
       /* the following are needed for error analysis (see algorithms.tex) */
       MPFR_ASSERTD(w >= 3 && N >= 2);
 
-      lgN = MPFR_INT_CEIL_LOG2 (N) + 1;
-      T  = (mpz_t *) MPFR_TMP_ALLOC (3 * lgN * sizeof (mpz_t));
-      P  = T + lgN;
-      Q  = T + 2*lgN;
-      for (i = 0; i < lgN; i++)
-        {
-          mpz_init (T[i]);
-          mpz_init (P[i]);
-          mpz_init (Q[i]);
-        }
-
-      S (T, P, Q, 0, N, 0);
+      mpfr_bsplit (bs, log2_term, NULL, 0, 0, N, 0);
 
-      mpfr_set_z (t, T[0], MPFR_RNDN);
-      mpfr_set_z (q, Q[0], MPFR_RNDN);
+      mpfr_set_z (t, MPFR_BSPLIT_T (bs), MPFR_RNDN);
+      mpfr_set_z (q, MPFR_BSPLIT_Q (bs), MPFR_RNDN);
       mpfr_div (t, t, q, MPFR_RNDN);
-
-      for (i = 0; i < lgN; i++)
-        {
-          mpz_clear (T[i]);
-          mpz_clear (P[i]);
-          mpz_clear (Q[i]);
-        }
+      mpfr_div_2ui (t, t, MPFR_BSPLIT_E (bs), MPFR_RNDN); /* exact */
 
       /* for prec < 300000 and all rounding modes we checked by exhaustive
          search that the rounding is correct */
@@ -191,8 +134,8 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
 
   inexact = mpfr_set (x, t, rnd_mode);
 
+  mpfr_bsplit_clear (bs);
   MPFR_GROUP_CLEAR(group);
-  MPFR_TMP_FREE(marker);
 
   return inexact;
 }
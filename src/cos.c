@@ -34,11 +34,13 @@ mpfr_cos_fast (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 }
 
 /* f <- 1 - r/2! + r^2/4! + ... + (-1)^l r^l/(2l)! + ...
+   If odd is non-zero, computes instead f <- 1 - r/3! + r^2/5! + ...
+   + (-1)^l r^l/(2l+1)! + ..., i.e., sin(sqrt(r))/sqrt(r).
    Assumes |r| < 1/2, and f, r have the same precision.
    Returns e such that the error on f is bounded by 2^e ulps.
 */
 static int
-mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
+mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r, int odd)
 {
   mpz_t x, t, s;
   mpfr_exp_t ex, l, m;
@@ -80,7 +82,7 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
   mpz_set_ui (s, 1); /* initialize sum with 1 */
   mpz_mul_2exp (s, s, p + q); /* scale all values by 2^(p+q) */
   mpz_set (t, s); /* invariant: t is previous term */
-  for (i = 1; (m = mpz_sizeinbase (t, 2)) >= q; i += 2)
+  for (i = odd ? 2 : 1; (m = mpz_sizeinbase (t, 2)) >= q; i += 2)
     {
       /* adjust precision of x to that of t */
       l = mpz_sizeinbase (x, 2);
@@ -93,7 +95,7 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
       /* multiply t by r */
       mpz_mul (t, t, x);
       mpz_fdiv_q_2exp (t, t, -ex);
-      /* divide t by i*(i+1) */
+      /* divide t by i*(i+1), i.e., (2l-1)*(2l) or (2l)*(2l+1) if odd */
       if (i < maxi)
         mpz_fdiv_q_ui (t, t, i * (i + 1));
       else
@@ -110,7 +112,7 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
          4/3*(3l)*2^(-m)*t <= 4*l since |t| < 2^m.
          Therefore the error on s is bounded by 2*l*(l+1). */
       /* add or subtract to s */
-      if (i % 4 == 1)
+      if (i % 4 == (odd ? 2 : 1))
         mpz_sub (s, s, t);
       else
         mpz_add (s, s, t);
@@ -127,16 +129,124 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
   return 2 * MPFR_INT_CEIL_LOG2 (l + 1) + 1; /* bound is 2l(l+1) */
 }
 
+/* Kernels for reduced arguments, used by mpfr_cos and mpfr_sin (which
+   call each other's kernel after a reduction modulo Pi/2, see below).
+   Both assume x is a regular number with |x| < 1, and return k such that
+   the error on s is bounded by 2^(EXP(s)+k-PREC(s)), where the precision
+   of s is the working precision. */
+
+/* s <- cos(x), using cos(2y) = 2cos(y)^2-1 K times */
+mpfr_exp_t
+mpfr_cos_reduced (mpfr_ptr s, mpfr_srcptr x)
+{
+  mpfr_prec_t m, K, k, l;
+  mpfr_t r;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x) && MPFR_GET_EXP (x) <= 0);
+
+  m = MPFR_PREC (s);
+  mpfr_init2 (r, m);
+  mpfr_mul (r, x, x, MPFR_RNDU); /* err <= 1 ulp */
+
+  /* we need |r| < 1/2 for mpfr_cos2_aux, i.e., EXP(r) - 2K <= -1,
+     which holds since EXP(r) <= 0 */
+  K = __gmpfr_isqrt (m / 3) + 1;
+  MPFR_SET_EXP (r, MPFR_GET_EXP (r) - 2 * K); /* Can't overflow! */
+
+  /* s <- 1 - r/2! + ... + (-1)^l r^l/(2l)! */
+  l = mpfr_cos2_aux (s, r, 0);
+  /* l is the error bound in ulps on s */
+  MPFR_SET_ONE (r);
+  for (k = 0; k < K; k++)
+    {
+      mpfr_sqr (s, s, MPFR_RNDU);            /* err <= 2*olderr */
+      MPFR_SET_EXP (s, MPFR_GET_EXP (s) + 1); /* Can't overflow */
+      mpfr_sub (s, s, r, MPFR_RNDN);         /* err <= 4*olderr */
+      /* since |x| < 1, all the values cos(x/2^k) are >= cos(1) > 1/2 */
+      MPFR_ASSERTD (MPFR_GET_EXP (s) >= 0 && MPFR_GET_EXP (s) <= 1);
+    }
+  mpfr_clear (r);
+
+  /* The absolute error on s is bounded by (2l+1/3)*2^(2K-m) <=
+     (2l+1)*2^(2K-m), and EXP(s) >= 0 */
+  return MPFR_INT_CEIL_LOG2 (2 * l + 1) + 2 * K;
+}
+
+/* s <- sin(x), using sin(3y) = 3sin(y)-4sin(y)^3 K times, which has
+   no cancellation, contrary to sin(x) = sqrt(1-cos(x)^2) near 0.
+   Let u = 2^(-m) where m = PREC(s), so that each rounding to nearest gives
+   a relative error at most u.
+   (a) y = x/3^K has a relative error at most (d+1)*u, where d is the
+       number of divisions below. Since |x*cot(x)| <= 1, this yields a
+       relative error at most (d+1)*u on sin(3^K*y).
+   (b) f = sin(sqrt(r))/sqrt(r) with r = y^2 has an error at most 2^e ulps,
+       thus a relative error at most 2^(e+1)*u since f > 1/2 (the error on
+       r only adds u/6).
+   (c) s = y*f adds u, and each of the K steps adds less than 4u: since
+       |y| < 1/3 at each step, 3-4s^2 >= 2.5, and the relative error on s
+       is multiplied by |(3-12s^2)/(3-4s^2)| <= 1.
+   The total relative error is thus at most (2^(e+1)+4K+d+3)*u. */
+mpfr_exp_t
+mpfr_sin_reduced (mpfr_ptr s, mpfr_srcptr x)
+{
+  mpfr_prec_t m;
+  mpfr_exp_t e;
+  unsigned long K, i, d, t;
+  mpfr_t y, r;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x) && MPFR_GET_EXP (x) <= 0);
+
+  m = MPFR_PREC (s);
+  mpfr_init2 (y, m);
+  mpfr_init2 (r, m);
+
+  /* choose K such that |y| < 2^(-sqrt(m)/2), using 3^K >= 2^(64K/41),
+     and K >= 1 if EXP(x) = 0 so that |y| < 1/3 */
+  e = MPFR_GET_EXP (x) + __gmpfr_isqrt (m) / 2 + 1;
+  K = (e > 0) ? ((unsigned long) e * 41) / 64 + 1 : 0;
+
+  mpfr_set (y, x, MPFR_RNDN);
+  for (i = K, d = 0; i > 0; i -= t, d++)
+    {
+      /* divide by 3^t with t <= 20, since 3^20 < 2^32 */
+      unsigned long q, j;
+
+      t = (i < 20) ? i : 20;
+      for (q = 1, j = 0; j < t; j++)
+        q *= 3;
+      mpfr_div_ui (y, y, q, MPFR_RNDN);
+    }
+
+  mpfr_sqr (r, y, MPFR_RNDN);
+  e = mpfr_cos2_aux (s, r, 1);
+  mpfr_mul (s, s, y, MPFR_RNDN);
+  for (i = 0; i < K; i++)
+    {
+      mpfr_sqr (r, s, MPFR_RNDN);
+      mpfr_mul_2ui (r, r, 2, MPFR_RNDN);
+      mpfr_ui_sub (r, 3, r, MPFR_RNDN);
+      mpfr_mul (s, s, r, MPFR_RNDN);
+    }
+  mpfr_clear (y);
+  mpfr_clear (r);
+
+  /* a relative error of at most 2^k*u gives an absolute error of at most
+     2^(EXP(s)+k-m) */
+  return MPFR_INT_CEIL_LOG2 ((2UL << e) + 4 * K + d + 3);
+}
+
 int
 mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
-  mpfr_prec_t K0, K, precy, m, k, l;
-  int inexact, reduce = 0;
-  mpfr_t r, s, xr, c;
-  mpfr_exp_t exps, cancel = 0, expx;
+  mpfr_prec_t K0, precy, m;
+  int inexact, reduce = 0, q;
+  mpfr_t s, xr;
+  mpfr_srcptr xx;
+  mpfr_exp_t exps, cancel = 0, expx, k;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_GROUP_DECL (group);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC (
     ("x[%Pu]=%*.Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
@@ -176,79 +286,46 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   K0 = __gmpfr_isqrt (precy / 3);
   m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * K0;
 
-  if (expx >= 3)
+  if (expx >= 1)
     {
       reduce = 1;
-      /* As expx + m - 1 will silently be converted into mpfr_prec_t
-         in the mpfr_init2 call, the assert below may be useful to
-         avoid undefined behavior. */
-      MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
-      mpfr_init2 (c, expx + m - 1);
       mpfr_init2 (xr, m);
     }
 
-  MPFR_GROUP_INIT_2 (group, m, r, s);
+  MPFR_GROUP_INIT_1 (group, m, s);
   MPFR_ZIV_INIT (loop, m);
   for (;;)
     {
-      /* If |x| >= 4, first reduce x cmod (2*Pi) into xr, using mpfr_remainder:
-         let e = EXP(x) >= 3, and m the target precision:
-         (1) c <- 2*Pi              [precision e+m-1, nearest]
-         (2) xr <- remainder (x, c) [precision m, nearest]
-         We have |c - 2*Pi| <= 1/2ulp(c) = 2^(3-e-m)
-                 |xr - x - k c| <= 1/2ulp(xr) <= 2^(1-m)
-                 |k| <= |x|/(2*Pi) <= 2^(e-2)
-         Thus |xr - x - 2kPi| <= |k| |c - 2Pi| + 2^(1-m) <= 2^(2-m).
-         It follows |cos(xr) - cos(x)| <= 2^(2-m). */
+      /* If |x| >= 1, first reduce x modulo Pi/2 into xr, with
+         |xr| <= Pi/4 + 2^(-m) < 1, using the Payne-Hanek reduction:
+         |xr - (x - (q+4n)*Pi/2)| <= 2^(-m), where m is the precision
+         of xr. It follows |cos(xr+q*Pi/2) - cos(x)| <= 2^(-m).
+         Then cos(x) = cos(xr), -sin(xr), -cos(xr) or sin(xr) for
+         q = 0, 1, 2, 3: near the zeros of cos, we thus use the sine kernel,
+         which has no cancellation. */
       if (reduce)
         {
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN); /* 2Pi */
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          if (MPFR_IS_ZERO(xr))
+          q = mpfr_reduce_pi (xr, x, 2);
+          /* |xr| >= 1 may only happen for a tiny working precision */
+          if (MPFR_IS_ZERO (xr) || MPFR_GET_EXP (xr) > 0)
             goto ziv_next;
-          /* now |xr| <= 4, thus r <= 16 below */
-          mpfr_mul (r, xr, xr, MPFR_RNDU); /* err <= 1 ulp */
+          xx = xr;
         }
       else
-        mpfr_mul (r, x, x, MPFR_RNDU); /* err <= 1 ulp */
-
-      /* now |x| < 4 (or xr if reduce = 1), thus |r| <= 16 */
-
-      /* we need |r| < 1/2 for mpfr_cos2_aux, i.e., EXP(r) - 2K <= -1 */
-      K = K0 + 1 + MAX(0, MPFR_GET_EXP(r)) / 2;
-      /* since K0 >= 0, if EXP(r) < 0, then K >= 1, thus EXP(r) - 2K <= -3;
-         otherwise if EXP(r) >= 0, then K >= 1/2 + EXP(r)/2, thus
-         EXP(r) - 2K <= -1 */
-
-      MPFR_SET_EXP (r, MPFR_GET_EXP (r) - 2 * K); /* Can't overflow! */
-
-      /* s <- 1 - r/2! + ... + (-1)^l r^l/(2l)! */
-      l = mpfr_cos2_aux (s, r);
-      /* l is the error bound in ulps on s */
-      MPFR_SET_ONE (r);
-      for (k = 0; k < K; k++)
         {
-          mpfr_sqr (s, s, MPFR_RNDU);            /* err <= 2*olderr */
-          MPFR_SET_EXP (s, MPFR_GET_EXP (s) + 1); /* Can't overflow */
-          mpfr_sub (s, s, r, MPFR_RNDN);         /* err <= 4*olderr */
-          if (MPFR_IS_ZERO(s))
-            goto ziv_next;
-          MPFR_ASSERTD (MPFR_GET_EXP (s) <= 1);
+          q = 0;
+          xx = x;
         }
 
-      /* The absolute error on s is bounded by (2l+1/3)*2^(2K-m)
-         2l+1/3 <= 2l+1.
-         If |x| >= 4, we need to add 2^(2-m) for the argument reduction
-         by 2Pi: if K = 0, this amounts to add 4 to 2l+1/3, i.e., to add
-         2 to l; if K >= 1, this amounts to add 1 to 2*l+1/3. */
-      l = 2 * l + 1;
-      if (reduce)
-        l += (K == 0) ? 4 : 1;
-      k = MPFR_INT_CEIL_LOG2 (l) + 2*K;
-      /* now the error is bounded by 2^(k-m) = 2^(EXP(s)-err) */
+      k = (q & 1) ? mpfr_sin_reduced (s, xx) : mpfr_cos_reduced (s, xx);
+      if (q == 1 || q == 2)
+        MPFR_CHANGE_SIGN (s);
 
+      /* The error on s is bounded by 2^(EXP(s)+k-m), plus 2^(-m) for the
+         argument reduction: in all cases it is at most 2^(k-m) with
+         the following value of k. */
       exps = MPFR_GET_EXP (s);
+      k = reduce ? MAX (exps + k, 0) + 1 : exps + k;
       if (MPFR_LIKELY (MPFR_CAN_ROUND (s, exps + m - k, precy, rnd_mode)))
         break;
 
@@ -269,6 +346,8 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
             }
         }
 
+      /* x is near a zero of cos: the argument reduction loses about
+         -EXP(s) bits */
       if (exps < cancel)
         {
           m += cancel - exps;
@@ -277,21 +356,15 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
     ziv_next:
       MPFR_ZIV_NEXT (loop, m);
-      MPFR_GROUP_REPREC_2 (group, m, r, s);
+      MPFR_GROUP_REPREC_1 (group, m, s);
       if (reduce)
-        {
-          mpfr_set_prec (xr, m);
-          mpfr_set_prec (c, expx + m - 1);
-        }
+        mpfr_set_prec (xr, m);
     }
   MPFR_ZIV_FREE (loop);
   inexact = mpfr_set (y, s, rnd_mode);
   MPFR_GROUP_CLEAR (group);
   if (reduce)
-    {
-      mpfr_clear (xr);
-      mpfr_clear (c);
-    }
+    mpfr_clear (xr);
 
  end:
   MPFR_SAVE_EXPO_FREE (expo);
@@ -32,6 +32,7 @@ mpfr_cosh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
   mpfr_t x;
   int inexact;
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC (
     ("x[%Pu]=%*.Rg rnd=%d", mpfr_get_prec (xt), mpfr_log_prec, xt, rnd_mode),
@@ -125,7 +125,9 @@ mpfr_eint_aux (mpfr_t y, mpfr_srcptr x)
   mpfr_ui_sub (erru, k, erru, MPFR_RNDD);
   if (MPFR_IS_NEG (erru))
     {
-      /* the truncated series does not converge, return fail */
+      /* the truncated series does not converge, return fail, with y
+         set to a regular number since the caller uses its exponent */
+      mpfr_set_ui (y, 1, MPFR_RNDN);
       e = w;
     }
   else
@@ -195,6 +197,10 @@ mpfr_eint_asympt (mpfr_ptr y, mpfr_srcptr x)
   return err_exp;
 }
 
+/* multiplier (in units of 1/1024) of the convergence bound of x
+   above which the asymptotic expansion is used, see mpfr_eint */
+static MPFR_TUNE_TAB_CONST short eint_asympt_tab[] = { MPFR_EINT_ASYMPT_TAB };
+
 /* mpfr_eint returns Ei(x) for x >= 0,
    and -E1(-x) for x < 0, following http://dlmf.nist.gov/6.2 */
 int
@@ -206,11 +212,14 @@ mpfr_eint (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
   mpfr_prec_t prec;
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC (
     ("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd),
     ("y[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (y), mpfr_log_prec, y, inex));
 
+  MPFR_STAT_STATIC_ASSERT (numberof (eint_asympt_tab) == MPFR_PREC_TAB_SIZE);
+
   if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)))
     {
       if (MPFR_IS_NAN (x))
@@ -308,10 +317,13 @@ mpfr_eint (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
     {
       /* For the asymptotic expansion to work, we need that the smallest
          value of k!/|x|^k is smaller than 2^(-p). The minimum is obtained for
-         x=k, and it is smaller than e*sqrt(x)/e^x for x>=1. */
+         x=k, and it is smaller than e*sqrt(x)/e^x for x>=1. This bound is
+         multiplied by c/1024 >= 1 from MPFR_EINT_ASYMPT_TAB. */
       if (MPFR_GET_EXP (x) > 0 &&
-          mpfr_cmp_d (x_abs, ((double) prec +
-                            0.5 * (double) MPFR_GET_EXP (x)) * LOG2 + 1.0) > 0)
+          mpfr_cmp_d (x_abs, (double) eint_asympt_tab[MPFR_PREC_TAB_INDEX
+                                                      (prec)] / 1024.0
+                      * ((double) prec + 0.5 * (double) MPFR_GET_EXP (x))
+                      * LOG2 + 1.0) > 0)
         err = mpfr_eint_asympt (tmp, x);
       else
         {
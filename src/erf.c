@@ -32,6 +32,7 @@ mpfr_erf (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mp_limb_t xf_limb[(53 - 1) / GMP_NUMB_BITS + 1];
   int inex, large;
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
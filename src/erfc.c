@@ -1,4 +1,5 @@
-/* mpfr_erfc -- The Complementary Error Function of a floating-point number
+/* mpfr_erfc, mpfr_erf_erfc -- The Complementary Error Function of a
+   floating-point number
 
 Copyright 2005-2016 Free Software Foundation, Inc.
 Contributed by the AriC and Caramba projects, INRIA.
@@ -28,7 +29,8 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 /* Put in y an approximation of erfc(x) for large x, using formulae 7.1.23 and
    7.1.24 from Abramowitz and Stegun.
    Returns e such that the error is bounded by 2^e ulp(y),
-   or returns 0 in case of underflow.
+   or returns 0 in case of underflow, or -1 (and then y is meaningless)
+   if the terms start to increase before reaching ulp(y).
 */
 static mpfr_exp_t
 mpfr_erfc_asympt (mpfr_ptr y, mpfr_srcptr x)
@@ -66,6 +68,16 @@ mpfr_erfc_asympt (mpfr_ptr y, mpfr_srcptr x)
           mpfr_add_ui (err, err, 1, MPFR_RNDU);
           break;
         }
+      /* the next term is larger than t when (2k+1)/(2x^2) >= 1: this can
+         happen in small precision near the threshold of
+         mpfr_erfc_use_asympt, where the smallest term is about ulp(y) */
+      if ((double) (2 * k + 1) * mpfr_get_d (xx, MPFR_RNDU) >= 1.0)
+        {
+          mpfr_clear (t);
+          mpfr_clear (xx);
+          mpfr_clear (err);
+          return -1;
+        }
       if (k & 1)
         mpfr_sub (y, y, t, MPFR_RNDN);
       else
@@ -120,6 +132,120 @@ mpfr_erfc_asympt (mpfr_ptr y, mpfr_srcptr x)
   return exp_err;
 }
 
+/* Put in y an approximation of erfc(x) for x > 0, using
+
+   erf(x) = 2x/sqrt(Pi) exp(-x^2) sum(2^k x^(2k)/(1*3*...*(2k+1)), k >= 0)
+
+   (formula 7.1.6 from Abramowitz and Stegun) and erfc(x) = 1 - erf(x).
+   Contrary to the Taylor expansion of erf at x=0, whose terms go up to
+   about exp(x^2) for a sum of about 1, all the terms are positive here,
+   thus the only cancellation is the one in 1 - erf(x), of about
+   x^2/log(2) bits (instead of twice this amount when erf(x) is computed
+   with the Taylor expansion). This is the same gain as the idea of
+   Gawronski, Mueller and Reinhard (computing the Taylor expansion of
+   erfc(x)*exp(x^2/2), see the TODO file), with a simpler error analysis.
+   Returns e such that |y - erfc(x)| <= 2^e.
+
+   Error analysis: let u = 2^(-w), where w = PREC(y), and assume
+   (16K+4z+32) u <= 1/2, where K is the number of terms and z = x^2.
+   The computed z has relative error at most u, thus the computed term
+   t[k] = o(o(t[k-1] * 2z) / (2k+1)) has relative error at most
+   (1+u)^(3k) - 1 <= 4ku, and since all terms are positive, the relative
+   error on the sum is at most 8Ku. We stop when t[k] < 2^(EXP(s)-w) and
+   2k+3 >= 4z, so that the ratio of two consecutive terms is at most 1/2,
+   and the neglected terms add at most 2 t[k] <= 8u s. The relative error
+   on exp(-z) is at most (2z+3)u, and the final multiplications by x and
+   by 2/sqrt(Pi) add at most 5u. All in all the relative error on erf(x)
+   is at most E u with E = 16K + 4z + 32 (the factor 2 accounting for the
+   second order terms), thus since erf(x) < 1, the absolute error on erf(x)
+   is at most E u, and that on y = o(1 - erf(x)) is at most (E+1) u.
+   If e is not NULL, it must have the same precision as y, and receives the
+   approximation of erf(x), with the same error bound. */
+static mpfr_exp_t
+mpfr_erfc_0 (mpfr_ptr y, mpfr_ptr e, mpfr_srcptr x)
+{
+  mpfr_t z, s, t;
+  mpfr_prec_t w = MPFR_PREC (y);
+  unsigned long k;
+  double err;
+
+  MPFR_ASSERTD (MPFR_IS_POS (x));
+  MPFR_ASSERTD (e == NULL || MPFR_PREC (e) == w);
+
+  mpfr_init2 (z, w);
+  mpfr_init2 (s, w);
+  mpfr_init2 (t, w);
+  mpfr_sqr (z, x, MPFR_RNDN);
+  mpfr_mul_2ui (z, z, 1, MPFR_RNDN); /* z ~ 2x^2 */
+  mpfr_set_ui (s, 1, MPFR_RNDN);
+  mpfr_set_ui (t, 1, MPFR_RNDN);
+  for (k = 1; ; k++)
+    {
+      mpfr_mul (t, t, z, MPFR_RNDN);
+      mpfr_div_ui (t, t, 2 * k + 1, MPFR_RNDN);
+      if (MPFR_GET_EXP (t) < MPFR_GET_EXP (s) - w &&
+          mpfr_cmp_ui (z, k + 1) <= 0)
+        break;
+      mpfr_add (s, s, t, MPFR_RNDN);
+    }
+  mpfr_div_2ui (t, z, 1, MPFR_RNDN);
+  mpfr_neg (t, t, MPFR_RNDN);
+  mpfr_exp (t, t, MPFR_RNDN);
+  mpfr_mul (s, s, t, MPFR_RNDN);
+  mpfr_mul (s, s, x, MPFR_RNDN);
+  mpfr_const_pi (t, MPFR_RNDN);
+  mpfr_sqrt (t, t, MPFR_RNDN);
+  mpfr_div (s, s, t, MPFR_RNDN);
+  mpfr_mul_2ui (s, s, 1, MPFR_RNDN);  /* s ~ erf(x) */
+  mpfr_ui_sub (y, 1, s, MPFR_RNDN);
+  if (e != NULL)
+    mpfr_swap (e, s);
+
+  err = 16.0 * (double) k + 2.0 * mpfr_get_d (z, MPFR_RNDU) + 33.0;
+
+  mpfr_clear (z);
+  mpfr_clear (s);
+  mpfr_clear (t);
+  return __gmpfr_ceil_log2 (err) - w;
+}
+
+/* Return non-zero if the asymptotic expansion should be used for erfc(x)
+   with working precision p. Its smallest term is about exp(-x^2), thus it
+   only converges for x^2 >= p*log(2); just above, it is already much faster
+   than mpfr_erfc_0 (e.g., 0.5ms instead of 2.7ms for p=1000 and x=27),
+   thus we switch when x^2 >= c*p, where c >= 710/1024 is given by
+   MPFR_ERFC_ASYMPT_TAB (about 0.7 by default, the previous test
+   x^2 >= 4^(EXP(x)-1) >= p could wait until x^2 >= 4p). */
+static MPFR_TUNE_TAB_CONST short erfc_asympt_tab[] = { MPFR_ERFC_ASYMPT_TAB };
+
+static int
+mpfr_erfc_use_asympt (mpfr_srcptr x, mpfr_prec_t p)
+{
+  mpfr_t t, u;
+  int ret;
+
+  MPFR_STAT_STATIC_ASSERT (numberof (erfc_asympt_tab) == MPFR_PREC_TAB_SIZE);
+
+  if (MPFR_IS_NEG (x) || 2 * MPFR_GET_EXP (x) < MPFR_INT_CEIL_LOG2 (p) - 1)
+    return 0; /* x^2 < 4^EXP(x) < p/2 */
+  mpfr_init2 (t, 32);
+  mpfr_init2 (u, 64);
+  mpfr_sqr (t, x, MPFR_RNDZ);
+  mpfr_mul_2ui (t, t, 10, MPFR_RNDZ);
+  mpfr_set_ui (u, p, MPFR_RNDU);
+  mpfr_mul_ui (u, u, erfc_asympt_tab[MPFR_PREC_TAB_INDEX (p)], MPFR_RNDU);
+  ret = mpfr_cmp (t, u) >= 0;
+  mpfr_clear (t);
+  mpfr_clear (u);
+  return ret;
+}
+
+/* mpfr_erfc_0 loses about x^2/log(2) bits by cancellation, plus the bits
+   of its error bound E (x^2 is small enough to fit in a double here) */
+#define ERFC_0_EXTRA(x, p)                                              \
+  ((mpfr_prec_t) (mpfr_get_d (x, MPFR_RNDU) * mpfr_get_d (x, MPFR_RNDU) \
+                  * 1.4426950408889634) + 8 + MPFR_INT_CEIL_LOG2 (p))
+
 int
 mpfr_erfc (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
 {
@@ -127,9 +253,11 @@ mpfr_erfc (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
   mpfr_t tmp;
   mpfr_exp_t te, err;
   mpfr_prec_t prec;
+  int asympt;
   mpfr_exp_t emin = mpfr_get_emin ();
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd),
@@ -226,17 +354,24 @@ mpfr_erfc (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
   prec = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + 3;
   if (MPFR_GET_EXP (x) > 0)
     prec += 2 * MPFR_GET_EXP(x);
+  asympt = mpfr_erfc_use_asympt (x, prec);
+  if (MPFR_IS_POS (x) && ! asympt && MPFR_GET_EXP (x) > 0)
+    prec += ERFC_0_EXTRA (x, prec);
 
   mpfr_init2 (tmp, prec);
 
   MPFR_ZIV_INIT (loop, prec);            /* Initialize the ZivLoop controller */
   for (;;)                               /* Infinite loop */
     {
-      /* use asymptotic formula only whenever x^2 >= p*log(2),
-         otherwise it will not converge */
-      if (MPFR_IS_POS (x) &&
-          2 * MPFR_GET_EXP (x) - 2 >= MPFR_INT_CEIL_LOG2 (prec))
-        /* we have x^2 >= p in that case */
+      /* the asymptotic expansion does not converge any more if the
+         precision increased too much */
+      if (asympt && ! mpfr_erfc_use_asympt (x, prec))
+        {
+          asympt = 0;
+          prec += ERFC_0_EXTRA (x, prec);
+          mpfr_set_prec (tmp, prec);
+        }
+      if (asympt)
         {
           err = mpfr_erfc_asympt (tmp, x);
           if (err == 0) /* underflow case */
@@ -245,6 +380,23 @@ mpfr_erfc (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
               MPFR_SAVE_EXPO_FREE (expo);
               return mpfr_underflow (y, (rnd == MPFR_RNDN) ? MPFR_RNDZ : rnd, 1);
             }
+          if (err < 0) /* the expansion does not converge */
+            {
+              asympt = 0;
+              prec += ERFC_0_EXTRA (x, prec);
+              mpfr_set_prec (tmp, prec);
+              continue;
+            }
+        }
+      else if (MPFR_IS_POS (x) && MPFR_GET_EXP (x) > 0)
+        {
+          err = mpfr_erfc_0 (tmp, NULL, x);
+          /* the error is bounded by 2^err, with err < -1 when the error
+             analysis of mpfr_erfc_0 applies */
+          if (err < -1 && ! MPFR_IS_ZERO (tmp))
+            err = prec - (MPFR_GET_EXP (tmp) - err);
+          else
+            err = prec; /* ensures MPFR_CAN_ROUND fails */
         }
       else
         {
@@ -275,3 +427,121 @@ mpfr_erfc (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (y, inex, rnd);
 }
+
+/* Put in y and z the values of erf(x) and erfc(x). The work is shared in
+   the two cases where mpfr_erfc computes erf(x) anyway: for |x| < 1, where
+   erfc(x) = 1 - erf(x), and for |x| >= 1 below the asymptotic range, where
+   mpfr_erfc_0 gives both erf(|x|) and erfc(|x|); we then use
+   erf(x) = -erf(|x|) and erfc(x) = 2 - erfc(|x|) for x < 0. Otherwise (tiny
+   or large |x|), mpfr_erf and mpfr_erfc have their own shortcuts, and are
+   called separately. */
+int
+mpfr_erf_erfc (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t e, t, ax;
+  mpfr_prec_t pmax, w;
+  mpfr_exp_t err, expx;
+  int inexy, inexz, mid;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MAX (MPFR_PREC (y), MPFR_PREC (z)));
+
+  MPFR_LOG_FUNC
+    (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
+     ("erf[%Pu]=%.*Rg erfc[%Pu]=%.*Rg", mpfr_get_prec (y), mpfr_log_prec, y,
+      mpfr_get_prec (z), mpfr_log_prec, z));
+
+  MPFR_ASSERTN (y != z);
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)))
+    goto separate;
+
+  expx = MPFR_GET_EXP (x);
+  /* for |x| < 2^(-PREC(z)), erfc(x) is obtained directly */
+  if (expx < - (mpfr_exp_t) MPFR_PREC (z))
+    goto separate;
+
+  pmax = MAX (MPFR_PREC (y), MPFR_PREC (z));
+  w = pmax + MPFR_INT_CEIL_LOG2 (pmax) + 3;
+  mid = expx > 0;
+  MPFR_TMP_INIT_ABS (ax, x);
+  if (mid)
+    {
+      w += 2 * expx;
+      if (mpfr_erfc_use_asympt (ax, w))
+        goto separate;
+      w += ERFC_0_EXTRA (ax, w);
+    }
+  else
+    w -= expx; /* 1 - erf(x) may have about -EXP(x) identical bits */
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  mpfr_init2 (e, w);
+  mpfr_init2 (t, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      if (mid)
+        {
+          /* the errors on e ~ erf(|x|) and t ~ erfc(|x|) are bounded by
+             2^err, with err < -1 when the error analysis applies */
+          err = mpfr_erfc_0 (t, e, ax);
+          if (MPFR_IS_NEG (x))
+            {
+              mpfr_neg (e, e, MPFR_RNDN);
+              /* 2 - t < 2 is rounded with error at most 2^(-w) <= 2^err */
+              mpfr_ui_sub (t, 2, t, MPFR_RNDN);
+              err ++;
+            }
+          if (err < -1 && ! MPFR_IS_ZERO (t) &&
+              MPFR_CAN_ROUND (e, MPFR_GET_EXP (e) - err, MPFR_PREC (y),
+                              rnd_mode) &&
+              MPFR_CAN_ROUND (t, MPFR_GET_EXP (t) - err, MPFR_PREC (z),
+                              rnd_mode))
+            break;
+        }
+      else
+        {
+          /* |e - erf(x)| <= 2^(EXP(e)-w-1) <= 2^(-w-1) since |erf(x)| < 1,
+             and 1 - e < 2 is rounded with error at most 2^(-w), thus
+             |t - erfc(x)| < 2^(1-w) */
+          mpfr_erf (e, x, MPFR_RNDN);
+          mpfr_ui_sub (t, 1, e, MPFR_RNDN);
+          if (MPFR_CAN_ROUND (e, w, MPFR_PREC (y), rnd_mode) &&
+              MPFR_CAN_ROUND (t, w - 1 + MPFR_GET_EXP (t), MPFR_PREC (z),
+                              rnd_mode))
+            break;
+        }
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (e, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexy = mpfr_set (y, e, rnd_mode);
+  inexz = mpfr_set (z, t, rnd_mode);
+
+  mpfr_clear (e);
+  mpfr_clear (t);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  inexy = mpfr_check_range (y, inexy, rnd_mode);
+  inexz = mpfr_check_range (z, inexz, rnd_mode);
+  MPFR_RET (INEX(inexy,inexz));
+
+ separate:
+  /* if x and y are the same variable, x is needed first by mpfr_erfc */
+  if (y == x)
+    {
+      inexz = mpfr_erfc (z, x, rnd_mode);
+      inexy = mpfr_erf (y, x, rnd_mode);
+    }
+  else
+    {
+      inexy = mpfr_erf (y, x, rnd_mode);
+      inexz = mpfr_erfc (z, x, rnd_mode);
+    }
+  return INEX(inexy,inexz);
+}
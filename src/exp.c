@@ -41,6 +41,7 @@ mpfr_exp (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_prec_t precy;
   int inexact;
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
@@ -171,7 +172,15 @@ mpfr_exp (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
     }
   else  /* General case */
     {
-      if (MPFR_UNLIKELY (precy >= MPFR_EXP_THRESHOLD))
+      /* For a sparse input, i.e., when x has few significant bits compared
+         to the target precision, the argument reduction of mpfr_exp_2
+         destroys the sparsity, while mpfr_exp_3 works directly on the bits
+         of x, and only has a few binary splitting steps to perform. Thus we
+         use mpfr_exp_3 from a smaller precision in that case. */
+      if (MPFR_UNLIKELY (precy >= MPFR_EXP_THRESHOLD
+                         || (precy >= MPFR_EXP_SPARSE_THRESHOLD
+                             && mpfr_min_prec (x) <=
+                             precy / MPFR_EXP_SPARSE_RATIO)))
         /* mpfr_exp_3 saves the exponent range and flags itself, otherwise
            the flag changes in mpfr_exp_3 are lost */
         inexact = mpfr_exp_3 (y, x, rnd_mode); /* O(M(n) log(n)^2) */
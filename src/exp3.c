@@ -23,37 +23,45 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H /* for MPFR_MPZ_SIZEINBASE2 */
 #include "mpfr-impl.h"
 
-/* y <- exp(p/2^r) within 1 ulp, using 2^m terms from the series
-   Assume |p/2^r| < 1.
-   We use the following binary splitting formula:
-   P(a,b) = p if a+1=b, P(a,c)*P(c,b) otherwise
-   Q(a,b) = a*2^r if a+1=b [except Q(0,1)=1], Q(a,c)*Q(c,b) otherwise
-   T(a,b) = P(a,b) if a+1=b, Q(c,b)*T(a,c)+P(a,c)*T(c,b) otherwise
-   Then exp(p/2^r) ~ T(0,i)/Q(0,i) for i so that (p/2^r)^i/i! is small enough.
-
-   Since P(a,b) = p^(b-a), and we consider only values of b-a of the form 2^j,
-   we don't need to compute P(), we only precompute p^(2^j) in the ptoj[] array
-   below.
-
-   Since Q(a,b) is divisible by 2^(r*(b-a-1)), we don't compute the power of
-   two part.
-*/
+typedef struct {
+  mpz_srcptr p;
+  unsigned long r;
+} mpfr_exp_rational_data;
+
+/* Term of index n >= 1 of the series of exp(p/2^r), see mpfr_bsplit */
 static void
-mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
-                   mpz_t *Q, mpfr_prec_t *mult)
+mpfr_exp_rational_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T,
+                        mp_bitcnt_t *f, unsigned long n, void *data)
 {
-  mp_bitcnt_t n, h, i, j;  /* unsigned type, which is >= unsigned long */
-  mpz_t *S, *ptoj;
-  mpfr_prec_t *log2_nb_terms;
-  mpfr_exp_t diff, expo;
-  mpfr_prec_t precy = MPFR_PREC(y), prec_i_have, prec_ptoj;
-  int k, l;
+  mpfr_exp_rational_data *d = (mpfr_exp_rational_data *) data;
 
-  MPFR_ASSERTN ((size_t) m < sizeof (long) * CHAR_BIT - 1);
+  (void) B; (void) T; /* no a(n) nor b(n) */
+  mpz_set (P, d->p);
+  mpz_set_ui (Q, n);
+  *f = d->r;
+}
 
-  S    = Q + (m+1);
-  ptoj = Q + 2*(m+1);                     /* ptoj[i] = mantissa^(2^i) */
-  log2_nb_terms = mult + (m+1);
+/* y <- exp(p/2^r) within 1 ulp, rounded toward zero.
+   Assume |p/2^r| < 1.
+   We sum the terms of index 1 to N-1 of the series by binary splitting
+   (mpfr_bsplit with MPFR_BSPLIT_POW, since p(n) = p for all n), which
+   gives T/(Q*2^e), then exp(p/2^r) ~ (Q*2^e + T)/(Q*2^e).
+   The term of index n is bounded by 2^(-n*(r - size(p)))/n!, with
+   n! >= 2^(floor(log2(2)) + ... + floor(log2(n))), thus we choose N so
+   that the first neglected term is less than 2^(-precy-3): since
+   |p/2^r| < 1, the neglected terms sum to less than 2^(-precy-2), which
+   is less than 1/2 ulp(y) since y > 1/4.
+   bs is used as temporary storage.
+*/
+static void
+mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, mpfr_bsplit_ptr bs)
+{
+  mp_bitcnt_t n;  /* unsigned type, which is >= unsigned long */
+  unsigned long N, lg;
+  mpz_ptr S, Q;
+  mpfr_exp_rational_data data;
+  mpfr_exp_t diff, expo, d, b;
+  mpfr_prec_t precy = MPFR_PREC(y), prec_i_have;
 
   /* Normalize p */
   MPFR_ASSERTD (mpz_cmp_ui (p, 0) != 0);
@@ -62,92 +70,47 @@ mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
   mpz_tdiv_q_2exp (p, p, n);
   r -= (long) n; /* since |p/2^r| < 1 and p >= 1, r >= 1 */
 
-  /* Set initial var */
-  mpz_set (ptoj[0], p);
-  for (k = 1; k < m; k++)
-    mpz_mul (ptoj[k], ptoj[k-1], ptoj[k-1]); /* ptoj[k] = p^(2^k) */
-  mpz_set_ui (Q[0], 1);
-  mpz_set_ui (S[0], 1);
-  k = 0;
-  mult[0] = 0; /* the multiplier P[k]/Q[k] for the remaining terms
-                  satisfies P[k]/Q[k] <= 2^(-mult[k]) */
-  log2_nb_terms[0] = 0; /* log2(#terms) [exact in 1st loop where 2^k] */
-  prec_i_have = 0;
-
-  /* Main Loop */
-  n = 1UL << m;
-  MPFR_ASSERTN (n != 0);  /* no overflow */
-  for (i = 1; (prec_i_have < precy) && (i < n); i++)
+  /* number of terms: b = N*d + floor(log2(2)) + ... + floor(log2(N)) */
+  d = (mpfr_exp_t) r - (mpfr_exp_t) mpz_sizeinbase (p, 2);
+  MPFR_ASSERTD (d >= 1);
+  for (N = 1, lg = 0, b = d; N < 2 || b < (mpfr_exp_t) precy + 3; )
     {
-      /* invariant: Q[0]*Q[1]*...*Q[k] equals i! */
-      k++;
-      log2_nb_terms[k] = 0; /* 1 term */
-      mpz_set_ui (Q[k], i + 1);
-      mpz_set_ui (S[k], i + 1);
-      j = i + 1; /* we have computed j = i+1 terms so far */
-      l = 0;
-      while ((j & 1) == 0) /* combine and reduce */
-        {
-          /* invariant: S[k] corresponds to 2^l consecutive terms */
-          mpz_mul (S[k], S[k], ptoj[l]);
-          mpz_mul (S[k-1], S[k-1], Q[k]);
-          /* Q[k] corresponds to 2^l consecutive terms too.
-             Since it does not contains the factor 2^(r*2^l),
-             when going from l to l+1 we need to multiply
-             by 2^(r*2^(l+1))/2^(r*2^l) = 2^(r*2^l) */
-          mpz_mul_2exp (S[k-1], S[k-1], r << l);
-          mpz_add (S[k-1], S[k-1], S[k]);
-          mpz_mul (Q[k-1], Q[k-1], Q[k]);
-          log2_nb_terms[k-1] ++; /* number of terms in S[k-1]
-                                    is a power of 2 by construction */
-          MPFR_MPZ_SIZEINBASE2 (prec_i_have, Q[k]);
-          MPFR_MPZ_SIZEINBASE2 (prec_ptoj, ptoj[l]);
-          mult[k-1] += prec_i_have + (r << l) - prec_ptoj - 1;
-          prec_i_have = mult[k] = mult[k-1];
-          /* since mult[k] >= mult[k-1] + nbits(Q[k]),
-             we have Q[0]*...*Q[k] <= 2^mult[k] = 2^prec_i_have */
-          l ++;
-          j >>= 1;
-          k --;
-        }
+      N++;
+      if ((N & (N - 1)) == 0)
+        lg++;  /* lg = floor(log2(N)) */
+      b += d + (mpfr_exp_t) lg;
     }
 
-  /* accumulate all products in S[0] and Q[0]. Warning: contrary to above,
-     here we do not have log2_nb_terms[k-1] = log2_nb_terms[k]+1. */
-  h = 0; /* number of accumulated terms in the right part S[k]/Q[k] */
-  while (k > 0)
-    {
-      j = log2_nb_terms[k-1];
-      mpz_mul (S[k], S[k], ptoj[j]);
-      mpz_mul (S[k-1], S[k-1], Q[k]);
-      h += (mp_bitcnt_t) 1 << log2_nb_terms[k];
-      mpz_mul_2exp (S[k-1], S[k-1], r * h);
-      mpz_add (S[k-1], S[k-1], S[k]);
-      mpz_mul (Q[k-1], Q[k-1], Q[k]);
-      k--;
-    }
+  data.p = p;
+  data.r = r;
+  mpfr_bsplit (bs, mpfr_exp_rational_term, &data, MPFR_BSPLIT_POW, 1, N, 0);
 
-  /* Q[0] now equals i! */
-  MPFR_MPZ_SIZEINBASE2 (prec_i_have, S[0]);
+  /* S <- Q*2^e + T, using P (not needed here) as temporary storage */
+  S = MPFR_BSPLIT_P (bs);
+  Q = MPFR_BSPLIT_Q (bs);
+  mpz_mul_2exp (S, Q, MPFR_BSPLIT_E (bs));
+  mpz_add (S, S, MPFR_BSPLIT_T (bs));
+
+  MPFR_MPZ_SIZEINBASE2 (prec_i_have, S);
   diff = (mpfr_exp_t) prec_i_have - 2 * (mpfr_exp_t) precy;
   expo = diff;
   if (diff >= 0)
-    mpz_fdiv_q_2exp (S[0], S[0], diff);
+    mpz_fdiv_q_2exp (S, S, diff);
   else
-    mpz_mul_2exp (S[0], S[0], -diff);
+    mpz_mul_2exp (S, S, -diff);
 
-  MPFR_MPZ_SIZEINBASE2 (prec_i_have, Q[0]);
+  MPFR_MPZ_SIZEINBASE2 (prec_i_have, Q);
   diff = (mpfr_exp_t) prec_i_have - (mpfr_prec_t) precy;
   expo -= diff;
   if (diff > 0)
-    mpz_fdiv_q_2exp (Q[0], Q[0], diff);
+    mpz_fdiv_q_2exp (Q, Q, diff);
   else
-    mpz_mul_2exp (Q[0], Q[0], -diff);
+    mpz_mul_2exp (Q, Q, -diff);
 
-  mpz_tdiv_q (S[0], S[0], Q[0]);
-  mpfr_set_z (y, S[0], MPFR_RNDD);
+  mpz_tdiv_q (S, S, Q);
+  mpfr_set_z (y, S, MPFR_RNDD);
   /* TODO: Check/prove that the following expression doesn't overflow. */
-  expo = MPFR_GET_EXP (y) + expo - r * (i - 1);
+  expo = MPFR_GET_EXP (y) + expo - (mpfr_exp_t) MPFR_BSPLIT_E (bs);
   MPFR_SET_EXP (y, expo);
 }
 
@@ -160,8 +123,7 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpz_t uk;
   mpfr_exp_t ttt, shift_x;
   unsigned long twopoweri;
-  mpz_t *P;
-  mpfr_prec_t *mult;
+  mpfr_bsplit_t bs;
   int i, k, loop;
   int prec_x;
   mpfr_prec_t realprec, Prec;
@@ -205,6 +167,7 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_init2 (t, Prec);
   mpfr_init2 (tmp, Prec);
   mpz_init (uk);
+  mpfr_bsplit_init (bs);
 
   /* Main loop */
   MPFR_ZIV_INIT (ziv_loop, realprec);
@@ -218,16 +181,10 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       /* now we have to extract */
       twopoweri = GMP_NUMB_BITS;
 
-      /* Allocate tables */
-      P    = (mpz_t*) (*__gmp_allocate_func) (3*(k+2)*sizeof(mpz_t));
-      for (i = 0; i < 3*(k+2); i++)
-        mpz_init (P[i]);
-      mult = (mpfr_prec_t*) (*__gmp_allocate_func) (2*(k+2)*sizeof(mpfr_prec_t));
-
       /* Particular case for i==0 */
       mpfr_extract (uk, x_copy, 0);
       MPFR_ASSERTD (mpz_cmp_ui (uk, 0) != 0);
-      mpfr_exp_rational (tmp, uk, shift + twopoweri - ttt, k + 1, P, mult);
+      mpfr_exp_rational (tmp, uk, shift + twopoweri - ttt, bs);
       for (loop = 0; loop < shift; loop++)
         mpfr_sqr (tmp, tmp, MPFR_RNDD);
       twopoweri *= 2;
@@ -239,19 +196,13 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
           mpfr_extract (uk, x_copy, i);
           if (MPFR_LIKELY (mpz_cmp_ui (uk, 0) != 0))
             {
-              mpfr_exp_rational (t, uk, twopoweri - ttt, k  - i + 1, P, mult);
+              mpfr_exp_rational (t, uk, twopoweri - ttt, bs);
               mpfr_mul (tmp, tmp, t, MPFR_RNDD);
             }
           MPFR_ASSERTN (twopoweri <= LONG_MAX/2);
           twopoweri *=2;
         }
 
-      /* Clear tables */
-      for (i = 0; i < 3*(k+2); i++)
-        mpz_clear (P[i]);
-      (*__gmp_free_func) (P, 3*(k+2)*sizeof(mpz_t));
-      (*__gmp_free_func) (mult, 2*(k+2)*sizeof(mpfr_prec_t));
-
       if (shift_x > 0)
         {
           MPFR_BLOCK (flags, {
@@ -330,6 +281,7 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
     }
   MPFR_ZIV_FREE (ziv_loop);
 
+  mpfr_bsplit_clear (bs);
   mpz_clear (uk);
   mpfr_clear (tmp);
   mpfr_clear (t);
@@ -26,14 +26,129 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #include "mpfr-impl.h"
 
 static unsigned long
-mpfr_exp2_aux (mpz_t, mpfr_srcptr, mpfr_prec_t, mpfr_exp_t *);
+mpfr_exp2_aux (mpz_t, mpfr_srcptr, mpfr_prec_t, mpfr_exp_t *, int);
 static unsigned long
-mpfr_exp2_aux2 (mpz_t, mpfr_srcptr, mpfr_prec_t, mpfr_exp_t *);
+mpfr_exp2_aux2 (mpz_t, mpfr_srcptr, mpfr_prec_t, mpfr_exp_t *, int);
+static unsigned long
+mpfr_exp2_sinh (mpz_t, mpfr_srcptr, mpfr_prec_t, mpfr_exp_t *, int);
 static mpfr_exp_t
 mpz_normalize  (mpz_t, mpz_t, mpfr_exp_t);
 static mpfr_exp_t
 mpz_normalize2 (mpz_t, mpz_t, mpfr_exp_t, mpfr_exp_t);
 
+/* Maximal size (in limbs) of the per-thread cache of mpfr_exp_2 below;
+   0 disables the cache. */
+#ifndef MPFR_EXP_2_CACHE_LIMBS
+# define MPFR_EXP_2_CACHE_LIMBS 4096
+#endif
+
+#if MPFR_EXP_2_CACHE_LIMBS
+
+/* Per-thread cache of the argument reduction data of mpfr_exp_2, keyed by
+   the target precision precy:
+   * exp_2_cache_log2[0] <= log(2) <= exp_2_cache_log2[1], both with
+     precision exp_2_cache_q + GMP_NUMB_BITS + 1;
+   * exp_2_cache_tab[k] = exp(k/2^m) for 0 <= k < exp_2_cache_size, with
+     precision exp_2_cache_q and relative error less than 2^(1-exp_2_cache_q).
+   The table allows to replace the last m squarings by one multiplication.
+   It is only built when mpfr_exp_2 is called twice in a row with the same
+   target precision, so that isolated calls do not pay for it. */
+static MPFR_THREAD_ATTR mpfr_prec_t exp_2_cache_last = 0;
+static MPFR_THREAD_ATTR mpfr_prec_t exp_2_cache_precy = 0; /* 0: empty */
+static MPFR_THREAD_ATTR mpfr_prec_t exp_2_cache_q = 0;
+static MPFR_THREAD_ATTR int exp_2_cache_m = 0;
+static MPFR_THREAD_ATTR unsigned long exp_2_cache_size = 0;
+static MPFR_THREAD_ATTR mpfr_t exp_2_cache_log2[2];
+static MPFR_THREAD_ATTR mpfr_t *exp_2_cache_tab = NULL;
+static MPFR_THREAD_ATTR int exp_2_cache_busy = 0;
+
+void
+mpfr_exp_2_freecache (void)
+{
+  unsigned long i;
+
+  if (exp_2_cache_precy != 0)
+    {
+      mpfr_clear (exp_2_cache_log2[0]);
+      mpfr_clear (exp_2_cache_log2[1]);
+      for (i = 0; i < exp_2_cache_size; i++)
+        mpfr_clear (exp_2_cache_tab[i]);
+      (*__gmp_free_func) (exp_2_cache_tab, exp_2_cache_size * sizeof (mpfr_t));
+      exp_2_cache_tab = NULL;
+      exp_2_cache_size = 0;
+      exp_2_cache_precy = 0;
+    }
+  exp_2_cache_last = 0;
+}
+
+/* Fill the cache for the target precision precy, where q is the working
+   precision of mpfr_exp_2 for |x| < 1, and K the number of squarings. */
+static void
+mpfr_exp_2_cache_build (mpfr_prec_t precy, mpfr_prec_t q, unsigned long K)
+{
+  mpfr_prec_t p = q + GMP_NUMB_BITS;
+  mp_size_t limbs;
+  unsigned long size, i;
+  int m;
+  mpfr_t e, t;
+
+  /* the table has (3/4)*2^m+1 entries, which is enough since the reduced
+     argument r satisfies 0 <= r < log(2) + epsilon */
+  limbs = MPFR_PREC2LIMBS (p);
+  for (m = (int) MIN (K - 1, 8); m > 0; m--)
+    {
+      size = (3UL << m) / 4 + 1;
+      if (size * limbs + 2 * MPFR_PREC2LIMBS (p + GMP_NUMB_BITS + 1)
+          <= MPFR_EXP_2_CACHE_LIMBS)
+        break;
+    }
+  if (m <= 0)
+    return;
+
+  mpfr_exp_2_freecache ();
+  exp_2_cache_busy = 1;
+
+  mpfr_init2 (exp_2_cache_log2[0], p + GMP_NUMB_BITS + 1);
+  mpfr_init2 (exp_2_cache_log2[1], p + GMP_NUMB_BITS + 1);
+  mpfr_const_log2 (exp_2_cache_log2[0], MPFR_RNDD);
+  mpfr_const_log2 (exp_2_cache_log2[1], MPFR_RNDU);
+
+  /* e = exp(2^(-m)) and t = e^i with m+2 guard bits: each product adds
+     a relative error of at most 2^(-p-m-1), thus after i < 2^m products
+     the relative error is less than 2^(-p-1), and less than 2^(1-p) after
+     the final rounding to p bits */
+  exp_2_cache_tab = (mpfr_t *) (*__gmp_allocate_func) (size * sizeof (mpfr_t));
+  mpfr_init2 (e, p + m + 2);
+  mpfr_init2 (t, p + m + 2);
+  mpfr_set_ui_2exp (t, 1, -m, MPFR_RNDN);
+  mpfr_exp (e, t, MPFR_RNDN);
+  mpfr_set_ui (t, 1, MPFR_RNDN);
+  for (i = 0; i < size; i++)
+    {
+      if (i > 0)
+        mpfr_mul (t, t, e, MPFR_RNDN);
+      mpfr_init2 (exp_2_cache_tab[i], p);
+      mpfr_set (exp_2_cache_tab[i], t, MPFR_RNDN);
+    }
+  mpfr_clear (e);
+  mpfr_clear (t);
+
+  exp_2_cache_precy = precy;
+  exp_2_cache_q = p;
+  exp_2_cache_m = m;
+  exp_2_cache_size = size;
+  exp_2_cache_busy = 0;
+}
+
+#else
+
+void
+mpfr_exp_2_freecache (void)
+{
+}
+
+#endif
+
 /* if k = the number of bits of z > q, divides z by 2^(k-q) and returns k-q.
    Otherwise do nothing and return 0.
  */
@@ -71,6 +186,9 @@ mpz_normalize2 (mpz_t rop, mpz_t z, mpfr_exp_t expz, mpfr_exp_t target)
    where x = n*log(2)+(2^K)*r
    together with the Paterson-Stockmeyer O(t^(1/2)) algorithm for the
    evaluation of power series. The resulting complexity is O(n^(1/3)*M(n)).
+   For precy >= MPFR_EXP_2_SINH_THRESHOLD, the power series of exp(r) is
+   replaced by the one of sinh(r), which has only half the terms, and we
+   use exp(r) = sinh(r) + sqrt(1+sinh(r)^2) (see mpfr_exp2_sinh).
    This function returns with the exact flags due to exp.
 */
 int
@@ -82,6 +200,10 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_exp_t exps, expx;
   mpfr_prec_t q, precy;
   int inexact;
+#if MPFR_EXP_2_CACHE_LIMBS
+  int cached;
+  unsigned long kt; /* index in the cache table */
+#endif
   mpfr_t s, r;
   mpz_t ss;
   MPFR_GROUP_DECL(group);
@@ -155,6 +277,14 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   err = K + MPFR_INT_CEIL_LOG2 (2 * l + 18);
   /* add K extra bits, i.e. failure probability <= 1/2^K = O(1/precy) */
   q = precy + err + K + 8;
+
+#if MPFR_EXP_2_CACHE_LIMBS
+  if (precy == exp_2_cache_last && precy != exp_2_cache_precy
+      && ! exp_2_cache_busy)
+    mpfr_exp_2_cache_build (precy, q, K);
+  exp_2_cache_last = precy;
+#endif
+
   /* if |x| >> 1, take into account the cancelled bits */
   if (expx > 0)
     q += expx;
@@ -174,13 +304,31 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       MPFR_LOG_MSG (("n=%ld K=%lu l=%lu q=%lu error_r=%d\n",
                      n, K, l, (unsigned long) q, error_r));
 
+      /* The cache can only be used if its data have enough precision,
+         which is always the case in the first iteration (|x| < 2^62*log(2)
+         implies expx <= GMP_NUMB_BITS), and error_r <= GMP_NUMB_BITS. */
+#if MPFR_EXP_2_CACHE_LIMBS
+      cached = precy == exp_2_cache_precy && q <= exp_2_cache_q
+        && ! exp_2_cache_busy;
+      kt = 0;
+#endif
+
       /* First reduce the argument to r = x - n * log(2),
          so that r is small in absolute value. We want an upper
          bound on r to get an upper bound on exp(x). */
 
       /* if n<0, we have to get an upper bound of log(2)
          in order to get an upper bound of r = x-n*log(2) */
-      mpfr_const_log2 (s, (n >= 0) ? MPFR_RNDZ : MPFR_RNDU);
+#if MPFR_EXP_2_CACHE_LIMBS
+      if (cached)
+        /* the cached bound has at least one more bit than s, thus s is
+           within 3/2 ulp(s) of log(2); the extra error of 1/2 ulp(s) is
+           taken into account below */
+        mpfr_set (s, exp_2_cache_log2[n < 0],
+                  (n >= 0) ? MPFR_RNDZ : MPFR_RNDU);
+      else
+#endif
+        mpfr_const_log2 (s, (n >= 0) ? MPFR_RNDZ : MPFR_RNDU);
       /* s is within 1 ulp(s) of log(2) */
 
       mpfr_mul_ui (r, s, (n < 0) ? -n : n, (n >= 0) ? MPFR_RNDZ : MPFR_RNDU);
@@ -216,18 +364,59 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
              and 1 + 3/2 if error_r > 0) */
           MPFR_LOG_VAR (r);
           MPFR_ASSERTD (MPFR_IS_POS (r));
-          mpfr_div_2ui (r, r, K, MPFR_RNDU); /* r = (x-n*log(2))/2^K, exact */
+
+#if MPFR_EXP_2_CACHE_LIMBS
+          if (cached)
+            {
+              mpfr_exp_t er = MPFR_GET_EXP (r) + exp_2_cache_m;
+
+              /* kt = floor(r*2^m), then r <- r - kt/2^m (exact), so that
+                 0 < r <= 2^(-m), and exp(x) = 2^n*exp(kt/2^m)*exp(r):
+                 only K-m squarings are needed */
+              MPFR_ASSERTD (er <= GMP_NUMB_BITS);
+              if (er > 0)
+                kt = MPFR_MANT(r)[MPFR_LAST_LIMB(r)] >> (GMP_NUMB_BITS - er);
+              if (kt < exp_2_cache_size)
+                {
+                  mpfr_mul_2ui (r, r, exp_2_cache_m, MPFR_RNDU);
+                  mpfr_sub_ui (r, r, kt, MPFR_RNDU);   /* exact */
+                  if (MPFR_IS_ZERO (r))
+                    {
+                      kt--;
+                      mpfr_set_ui (r, 1, MPFR_RNDU);
+                    }
+                  mpfr_div_2ui (r, r, K, MPFR_RNDU); /* exact */
+                }
+              else /* cannot happen, but be careful */
+                {
+                  cached = 0;
+                  kt = 0;
+                  mpfr_div_2ui (r, r, K, MPFR_RNDU);
+                }
+            }
+          else
+#endif
+            mpfr_div_2ui (r, r, K, MPFR_RNDU); /* r = (x-n*log(2))/2^K, exact */
 
           /* s <- 1 + r/1! + r^2/2! + ... + r^l/l! */
           MPFR_ASSERTD (MPFR_IS_PURE_FP (r) && MPFR_EXP (r) < 0);
-          l = (precy < MPFR_EXP_2_THRESHOLD)
-            ? mpfr_exp2_aux (ss, r, q, &exps)   /* naive method */
-            : mpfr_exp2_aux2 (ss, r, q, &exps); /* Paterson/Stockmeyer meth */
+          if (precy >= MPFR_EXP_2_SINH_THRESHOLD)
+            l = mpfr_exp2_sinh (ss, r, q, &exps,
+                                precy < MPFR_EXP_2_THRESHOLD);
+          else
+            l = (precy < MPFR_EXP_2_THRESHOLD)
+              ? mpfr_exp2_aux (ss, r, q, &exps, 0)   /* naive method */
+              : mpfr_exp2_aux2 (ss, r, q, &exps, 0); /* Paterson/Stockmeyer */
 
           MPFR_LOG_MSG (("l=%lu q=%lu (K+l)*q^2=%1.3e\n",
                          l, (unsigned long) q, (K + l) * (double) q * q));
 
-          for (k = 0; k < K; k++)
+          k = 0;
+#if MPFR_EXP_2_CACHE_LIMBS
+          if (cached)
+            k = exp_2_cache_m;
+#endif
+          for (; k < K; k++)
             {
               mpz_mul (ss, ss, ss);
               exps *= 2;
@@ -239,6 +428,19 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
              the error of 3 ulps on r */
           err = K + MPFR_INT_CEIL_LOG2 (l) + 2;
 
+#if MPFR_EXP_2_CACHE_LIMBS
+          if (cached)
+            {
+              /* r had an error of at most 4 ulps instead of 3, we did m
+                 fewer squarings, and multiplying by exp(kt/2^m), which has
+                 a relative error less than 2^(1-q), adds at most 2 ulps:
+                 one more bit covers all this */
+              if (kt > 0)
+                mpfr_mul (s, s, exp_2_cache_tab[kt], MPFR_RNDN);
+              err = err - exp_2_cache_m + 1;
+            }
+#endif
+
           MPFR_LOG_MSG (("before mult. by 2^n:\n", 0));
           MPFR_LOG_VAR (s);
           MPFR_LOG_MSG (("err=%lu bits\n", K));
@@ -263,13 +465,17 @@ mpfr_exp_2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
 /* s <- 1 + r/1! + r^2/2! + ... + r^l/l! while MPFR_EXP(r^l/l!)+MPFR_EXPR(r)>-q
    using naive method with O(l) multiplications.
+   If odd is non-zero, computes instead s <- 1 + r/3! + r^2/5! + ... +
+   r^l/(2l+1)!, i.e., sinh(sqrt(r))/sqrt(r).
    Return the number of iterations l.
-   The absolute error on s is less than 3*l*(l+1)*2^(-q).
+   The absolute error on s is less than 3*l*(l+1)*2^(-q) (4*l*(l+1)*2^(-q)
+   if odd is non-zero, since there are two divisions per term).
    Version using fixed-point arithmetic with mpz instead
    of mpfr for internal computations.
 */
 static unsigned long
-mpfr_exp2_aux (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
+mpfr_exp2_aux (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps,
+               int odd)
 {
   unsigned long l;
   mpfr_exp_t dif, expt, expr;
@@ -299,7 +505,14 @@ mpfr_exp2_aux (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
       /* truncates the bits of t which are < ulp(s) = 2^(1-q) */
       expt += mpz_normalize (t, t, (mpfr_exp_t) q - dif);
       /* error at most 2^(1-q) */
-      if (l > 1)
+      if (odd)
+        {
+          /* divide by (2l)*(2l+1), in two steps to avoid an overflow */
+          mpz_fdiv_q_ui (t, t, 2 * l);          /* error at most 2^(1-q) */
+          mpz_fdiv_q_ui (t, t, 2 * l + 1);      /* error at most 2^(1-q) */
+          MPFR_ASSERTD (expt == *exps);
+        }
+      else if (l > 1)
         {
           /* GMP doesn't optimize the case of power of 2 */
           if (IS_POW2(l))
@@ -326,7 +539,7 @@ mpfr_exp2_aux (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
   mpz_clear (t);
   mpz_clear (rr);
 
-  return 3 * l * (l + 1);
+  return (odd ? 4 : 3) * l * (l + 1);
 }
 
 /* s <- 1 + r/1! + r^2/2! + ... + r^l/l! while MPFR_EXP(r^l/l!)+MPFR_EXPR(r)>-q
@@ -338,10 +551,15 @@ mpfr_exp2_aux (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
    NOTE[VL]: The following sentence seems to be obsolete since MY_INIT_MPZ
    is no longer used (r6919); sizer was the number of limbs of r.
    Version using mpz. ss must have at least (sizer+1) limbs.
-   The error is bounded by (l^2+4*l) ulps where l is the return value.
+   If odd is non-zero, computes instead s <- 1 + r/3! + ... + r^l/(2l+1)!,
+   i.e., sinh(sqrt(r))/sqrt(r).
+   The error is bounded by (l^2+4*l) ulps where l is the return value
+   ((l^2+5*l) ulps if odd is non-zero: each step of Horner's scheme then
+   does two divisions, i.e., adds 2 ulps instead of 1).
 */
 static unsigned long
-mpfr_exp2_aux2 (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
+mpfr_exp2_aux2 (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps,
+                int odd)
 {
   mpfr_exp_t expr, *expR, expt;
   mpfr_prec_t ql;
@@ -402,10 +620,17 @@ mpfr_exp2_aux2 (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
       expt = mpz_normalize2 (t, R[m-1], expR[m-1], 1 - ql);
       /* err(t) <= 2*m-1 ulps */
       /* computes t = 1 + r/(l+1) + ... + r^(m-1)*l!/(l+m-1)!
-         using Horner's scheme */
+         using Horner's scheme (in the odd case, the divisor l+i+1 is
+         replaced by (2(l+i)+2)*(2(l+i)+3)) */
       for (i = m-1 ; i-- != 0 ; )
         {
-          mpz_fdiv_q_ui (t, t, l+i+1); /* err(t) += 1 ulp */
+          if (odd)
+            {
+              mpz_fdiv_q_ui (t, t, 2 * (l + i) + 2); /* err(t) += 1 ulp */
+              mpz_fdiv_q_ui (t, t, 2 * (l + i) + 3); /* err(t) += 1 ulp */
+            }
+          else
+            mpz_fdiv_q_ui (t, t, l+i+1); /* err(t) += 1 ulp */
           mpz_add (t, t, R[i]);
         }
       /* now err(t) <= (3m-2) ulps */
@@ -424,7 +649,13 @@ mpfr_exp2_aux2 (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
       expr += expR[m];
       mpz_set_ui (tmp, 1);
       for (i = 1 ; i <= m ; i++)
-        mpz_mul_ui (tmp, tmp, l + i);
+        if (odd)
+          {
+            mpz_mul_ui (tmp, tmp, 2 * (l + i));
+            mpz_mul_ui (tmp, tmp, 2 * (l + i) + 1);
+          }
+        else
+          mpz_mul_ui (tmp, tmp, l + i);
       mpz_fdiv_q (t, t, tmp); /* err(t) <= err(rr) + 2m */
       l += m;
       if (MPFR_UNLIKELY (mpz_sgn (t) == 0))
@@ -448,5 +679,62 @@ mpfr_exp2_aux2 (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps)
   mpz_clear (t);
   mpz_clear (tmp);
 
-  return l * (l + 4);
+  return l * (l + (odd ? 5 : 4));
+}
+
+/* s <- exp(r) using exp(r) = t + sqrt(1+t^2) where t = sinh(r), see
+   MCA, Exercise 4.11. The power series of sinh(r)/r has only half the
+   terms of the one of exp(r), since it is a series in r^2: it is computed
+   by mpfr_exp2_aux (if naive is non-zero) or mpfr_exp2_aux2.
+   Assumes 0 < r < 1.
+   Return a bound on the error on s, in ulps (1 ulp = 2^(1-q)).
+
+   Error analysis (u = 2^(1-q)): y = r^2 is exact. If S approximates
+   sinh(r)/r >= 1 with an absolute error at most E*u, then t = o(r*S)
+   approximates sinh(r) < 1 with an error at most (E+1)*u. Since the
+   derivative of t + sqrt(1+t^2) is at most 2 for t >= 0, this gives an
+   error at most 2*(E+1)*u on exp(r). The rounding errors on t^2 (< u/4),
+   1+t^2 (<= u/2), the square root (u/2 + the propagated error <= u/2) and
+   the final addition (<= u, since the sum is < 4) add at most 2*u.
+   Hence the bound 2*E+4. */
+static unsigned long
+mpfr_exp2_sinh (mpz_t s, mpfr_srcptr r, mpfr_prec_t q, mpfr_exp_t *exps,
+                int naive)
+{
+  mpfr_t y, t, u;
+  mpfr_exp_t expt;
+  unsigned long err;
+  int inex;
+
+  MPFR_ASSERTD (MPFR_IS_POS (r) && MPFR_GET_EXP (r) <= 0);
+
+  mpfr_init2 (y, 2 * MPFR_PREC (r));
+  mpfr_init2 (t, q);
+  mpfr_init2 (u, q);
+
+  inex = mpfr_sqr (y, r, MPFR_RNDN);
+  MPFR_ASSERTD (inex == 0);
+  (void) inex; /* avoid a warning when assertions are disabled */
+
+  /* s*2^expt approximates sinh(r)/r = 1 + y/3! + y^2/5! + ... */
+  err = naive ? mpfr_exp2_aux (s, y, q, &expt, 1)
+    : mpfr_exp2_aux2 (s, y, q, &expt, 1);
+  /* mpfr_exp2_aux bounds its error in units 2^(-q) */
+  if (naive)
+    err = (err + 1) / 2;
+
+  mpfr_set_z_2exp (t, s, expt, MPFR_RNDN); /* exact since s < 2^q */
+  mpfr_mul (t, t, r, MPFR_RNDN);           /* t ~ sinh(r) */
+  mpfr_sqr (u, t, MPFR_RNDN);
+  mpfr_add_ui (u, u, 1, MPFR_RNDN);
+  mpfr_sqrt (u, u, MPFR_RNDN);
+  mpfr_add (t, t, u, MPFR_RNDN);           /* t ~ exp(r) */
+
+  *exps = mpfr_get_z_2exp (s, t);
+
+  mpfr_clear (y);
+  mpfr_clear (t);
+  mpfr_clear (u);
+
+  return 2 * err + 4;
 }
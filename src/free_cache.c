@@ -86,6 +86,7 @@ mpfr_free_const_caches (void)
 #endif
   mpfr_clear_cache (__gmpfr_cache_const_euler);
   mpfr_clear_cache (__gmpfr_cache_const_catalan);
+  mpfr_clear_cache (__gmpfr_cache_const_2_over_pi);
 }
 
 /* Theses caches are always local to a thread */
@@ -94,6 +95,12 @@ mpfr_free_local_cache (void)
 {
   /* Before mpz caching */
   mpfr_bernoulli_freecache();
+  mpfr_exp_2_freecache ();
+  mpfr_atan_freecache ();
+  mpfr_zeta_freecache ();
+  mpfr_latency_freecache ();
+  mpfr_alloc_stats_freecache ();
+  mpfr_trace_freecache ();
 
 #if MPFR_MY_MPZ_INIT
   { /* Avoid mixed declarations and code for ISO C90 support. */
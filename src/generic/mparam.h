@@ -47,14 +47,37 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # define MPFR_EXP_2_THRESHOLD 100 /* bits */
 #endif
 
+#ifndef MPFR_EXP_2_SINH_THRESHOLD
+# define MPFR_EXP_2_SINH_THRESHOLD 1000 /* bits */
+#endif
+
 #ifndef MPFR_EXP_THRESHOLD
 # define MPFR_EXP_THRESHOLD 25000 /* bits */
 #endif
 
+#ifndef MPFR_EXP_SPARSE_THRESHOLD
+# define MPFR_EXP_SPARSE_THRESHOLD 2000 /* bits, mpfr_exp_3 for sparse x */
+#endif
+
+#ifndef MPFR_EXP_SPARSE_RATIO
+# define MPFR_EXP_SPARSE_RATIO 32 /* minimal precy/min_prec(x) ratio, idem */
+#endif
+
+#ifndef MPFR_LOG_ATANH_THRESHOLD
+# define MPFR_LOG_ATANH_THRESHOLD 1200 /* bits */
+#endif
+
 #ifndef MPFR_SINCOS_THRESHOLD
 # define MPFR_SINCOS_THRESHOLD 30000 /* bits */
 #endif
 
+#ifndef MPFR_TRANS_Q_THRESHOLD
+# define MPFR_TRANS_Q_THRESHOLD 2000 /* bits, binary splitting in exp_q... */
+#endif
+#ifndef MPFR_TRANS_Q_RATIO
+# define MPFR_TRANS_Q_RATIO 64 /* minimal precision/size ratio, idem */
+#endif
+
 #ifndef MPFR_AI_THRESHOLD1
 # define MPFR_AI_THRESHOLD1 -13107 /* threshold for negative input of mpfr_ai */
 #endif
@@ -67,3 +90,47 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # define MPFR_AI_THRESHOLD3 19661
 #endif
 
+#ifndef MPFR_AI_ASYMPT_THRESHOLD
+# define MPFR_AI_ASYMPT_THRESHOLD 838861 /* asymptotic expansion of mpfr_ai */
+#endif
+
+/* Tables of MPFR_PREC_TAB_SIZE values, one per precision range (see
+   MPFR_PREC_TAB_INDEX in mpfr-impl.h), in units of 1/1024 unless said
+   otherwise. The comments give the minimal correct value. */
+
+#ifndef MPFR_ERFC_ASYMPT_TAB /* asymptotic expansion iff x^2 >= c*p, 710 */
+# define MPFR_ERFC_ASYMPT_TAB 717,717,717,717,717,717,717,717
+#endif
+
+#ifndef MPFR_EINT_ASYMPT_TAB /* c times the convergence bound of x, 1024 */
+# define MPFR_EINT_ASYMPT_TAB 1024,1024,1024,1024,1024,1024,1024,1024
+#endif
+
+#ifndef MPFR_JN_ASYMPT_TAB /* asymptotic expansion iff |z| > c*p + 3, 355 */
+# define MPFR_JN_ASYMPT_TAB 512,512,512,512,512,512,512,512
+#endif
+
+#ifndef MPFR_YN_ASYMPT_TAB /* idem for mpfr_yn */
+# define MPFR_YN_ASYMPT_TAB 512,512,512,512,512,512,512,512
+#endif
+
+#ifndef MPFR_LNGAMMA_ALPHA_TAB /* argument reduction k = c*p - x, 128 */
+# define MPFR_LNGAMMA_ALPHA_TAB 256,256,256,256,256,256,256,256
+#endif
+
+#ifndef MPFR_GAMMA_ALPHA_TAB /* same for mpfr_gamma, 128 */
+# define MPFR_GAMMA_ALPHA_TAB 256,256,256,256,256,256,256,256
+#endif
+
+#ifndef MPFR_ZETA_DIRECT_TAB /* direct sum for s >= c*p, 128, or 0 (never) */
+# define MPFR_ZETA_DIRECT_TAB 0,0,0,0,0,0,0,0
+#endif
+
+#ifndef MPFR_ATAN_LARGE_TAB /* number of terms of the series of atan(1/x) */
+# define MPFR_ATAN_LARGE_TAB 12,12,12,12,12,12,12,12
+#endif
+
+#ifndef MPFR_POW_Z_TAB /* pow_z iff EXP(y) <= c, y integer, MPFR_PREC_BITS */
+# define MPFR_POW_Z_TAB 256,256,256,256,256,256,256,256
+#endif
+
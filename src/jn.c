@@ -79,13 +79,16 @@ mpfr_jn_k0 (unsigned long n, mpfr_srcptr z)
   return k0;
 }
 
+/* crossover of the asymptotic expansion, see mpfr_jn */
+static MPFR_TUNE_TAB_CONST short jn_asympt_tab[] = { MPFR_JN_ASYMPT_TAB };
+
 int
 mpfr_jn (mpfr_ptr res, long n, mpfr_srcptr z, mpfr_rnd_t r)
 {
   int inex;
   int exception = 0;
   unsigned long absn;
-  mpfr_prec_t prec, pbound, err;
+  mpfr_prec_t prec, pbound, err, c;
   mpfr_uprec_t uprec;
   mpfr_exp_t exps, expT, diffexp;
   mpfr_t y, s, t, absz;
@@ -176,8 +179,12 @@ mpfr_jn (mpfr_ptr res, long n, mpfr_srcptr z, mpfr_rnd_t r)
     }
 
   /* we can use the asymptotic expansion as soon as |z| > p log(2)/2,
-     but to get some margin we use it for |z| > p/2 */
-  pbound = MPFR_PREC (res) / 2 + 3;
+     but to get some margin we use it for |z| > c*p + 3, where c is given
+     by MPFR_JN_ASYMPT_TAB (1/2 by default) */
+  MPFR_STAT_STATIC_ASSERT (numberof (jn_asympt_tab) == MPFR_PREC_TAB_SIZE);
+  c = jn_asympt_tab[MPFR_PREC_TAB_INDEX (MPFR_PREC (res))];
+  pbound = MPFR_PREC (res) / 1024 * c + MPFR_PREC (res) % 1024 * c / 1024
+    + 3;
   MPFR_ASSERTN (pbound <= ULONG_MAX);
   MPFR_ALIAS (absz, z, 1, MPFR_EXP (z));
   if (mpfr_cmp_ui (absz, pbound) > 0)
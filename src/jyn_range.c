@@ -0,0 +1,237 @@
+/* mpfr_jn_range, mpfr_yn_range -- Bessel functions of several consecutive
+   integer orders
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Both J_k(x) and Y_k(x) satisfy the three-term recurrence
+
+     f(k-1) + f(k+1) = (2k/x) f(k).
+
+   For J we compute J_{n-1}(x) and J_{n-2}(x) with mpfr_jn, and the lower
+   orders with the backward recurrence (J_k is the minimal solution, thus
+   the backward recurrence is stable); for Y we compute Y_0(x) and Y_1(x)
+   with mpfr_yn, and the higher orders with the forward recurrence.
+
+   Error analysis: let v_k be the computed value of f(k), and E_k a bound
+   on |v_k - f(k)|. For the starting values E_k = 1/2 ulp(v_k). Each step
+   computes (with rounding to nearest, w being the working precision)
+   c = o(2k/x), t = o(c * v_k) and v_new = o(t - v_old), thus
+
+     |v_new - f(new)| <= 1/2 ulp(v_new) + 1/2 ulp(t) + |c - 2k/x| |v_k|
+                         + |2k/x| E_k + E_old
+                      <= 2^(EXP(v_new)-w-1) + 2^(EXP(c)+EXP(v_k)-w)
+                         + |c| (1 + 2^(-w)) E_k + E_old
+
+   since |t| < 2^(EXP(c)+EXP(v_k)), |c - 2k/x| <= 2^(EXP(c)-w-1) and
+   |2k/x| <= |c| (1 + 2^(-w)). The bound E_new is evaluated with rounding
+   upward (the term |c| E_k 2^(-w) is bounded by 2^(EXP(|c| E_k)-w)).
+   This bound does not take into account the cancellations, thus it can
+   grow faster than the actual error (for k < |x|): the Ziv loop below then
+   retries with the number of lost bits observed at the previous iteration,
+   and after that the remaining orders are computed separately. */
+
+/* e <- e + 2^ex, rounded upward */
+#define ADD_POW2(e, ex)                                 \
+  do                                                    \
+    {                                                   \
+      mpfr_set_ui_2exp (tmp, 1, (ex), MPFR_RNDU);       \
+      mpfr_add (e, e, tmp, MPFR_RNDU);                  \
+    }                                                   \
+  while (0)
+
+/* Try to set tab[k] from v with error at most e, and update *lost with the
+   number of bits lost in v (w minus the number of correct bits). */
+static void
+mpfr_jyn_range_round (mpfr_ptr *const tab, int *tv, unsigned long k,
+                      mpfr_srcptr v, mpfr_srcptr e, mpfr_prec_t w,
+                      mpfr_prec_t *lost, mpfr_rnd_t r)
+{
+  mpfr_exp_t err;
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (v)))
+    {
+      *lost = w; /* no information */
+      return;
+    }
+  err = MPFR_GET_EXP (v) - (MPFR_IS_ZERO (e) ? MPFR_GET_EXP (v) - w
+                            : MPFR_GET_EXP (e));
+  if (err < w && w - err > *lost)
+    *lost = w - err;
+  if (tv[k] == 2 && err > 0 &&
+      MPFR_CAN_ROUND (v, err, MPFR_PREC (tab[k]), r))
+    tv[k] = mpfr_set (tab[k], v, r);
+}
+
+static void
+mpfr_jyn_range (mpfr_ptr *const tab, int *tern, unsigned long n,
+                mpfr_srcptr x, mpfr_rnd_t r, int yn)
+{
+  mpfr_prec_t w, pmax, lost;
+  unsigned long i, k, m, o, nfail;
+  mpfr_t c, t, v[3], e[3], tmp;
+  int *tv, inex, iter, giveup;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_TMP_DECL (marker);
+
+  /* the recurrence is not worth for less than 3 orders, and the special
+     cases are handled by mpfr_jn and mpfr_yn */
+  if (n < 3 || MPFR_IS_SINGULAR (x) || (yn && MPFR_IS_NEG (x)))
+    {
+      for (i = 0; i < n; i++)
+        {
+          inex = yn ? mpfr_yn (tab[i], i, x, r) : mpfr_jn (tab[i], i, x, r);
+          if (tern != NULL)
+            tern[i] = inex;
+        }
+      return;
+    }
+
+  MPFR_TMP_MARK (marker);
+  /* tv[k] is the ternary value of tab[k], or 2 if not yet computed */
+  tv = (int *) MPFR_TMP_ALLOC (n * sizeof (int));
+  pmax = MPFR_PREC_MIN;
+  for (k = 0; k < n; k++)
+    {
+      tv[k] = 2;
+      if (MPFR_PREC (tab[k]) > pmax)
+        pmax = MPFR_PREC (tab[k]);
+    }
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  mpfr_init2 (tmp, 32);
+  for (i = 0; i < 3; i++)
+    mpfr_init2 (e[i], 32);
+  w = pmax + MPFR_INT_CEIL_LOG2 (pmax) + MPFR_INT_CEIL_LOG2 (n) + 10;
+  mpfr_init2 (c, w);
+  mpfr_init2 (t, w);
+  for (i = 0; i < 3; i++)
+    mpfr_init2 (v[i], w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (iter = 0; ; iter++)
+    {
+      lost = 0;
+      giveup = 0;
+      /* v[k % 3] and e[k % 3] hold the value of order k and its error */
+      k = yn ? 0 : n - 1;
+      for (i = 0; i < 2; i++, k = yn ? k + 1 : k - 1)
+        {
+          if (yn)
+            mpfr_yn (v[k % 3], k, x, MPFR_RNDN);
+          else
+            mpfr_jn (v[k % 3], k, x, MPFR_RNDN);
+          if (MPFR_IS_SINGULAR (v[k % 3]))
+            mpfr_set_ui (e[k % 3], 0, MPFR_RNDN);
+          else
+            mpfr_set_ui_2exp (e[k % 3], 1, MPFR_GET_EXP (v[k % 3]) - w - 1,
+                              MPFR_RNDU);
+          mpfr_jyn_range_round (tab, tv, k, v[k % 3], e[k % 3], w, &lost, r);
+        }
+      /* now k is the next order to compute, from the orders m = k -/+ 1
+         and o = k -/+ 2: f(k) = (2m/x) f(m) - f(o) */
+      for (; yn ? k < n : k != (unsigned long) -1; k = yn ? k + 1 : k - 1)
+        {
+          mpfr_ptr vk, vm, vo, ek, em, eo;
+
+          m = yn ? k - 1 : k + 1;
+          o = yn ? k - 2 : k + 2;
+          vk = v[k % 3]; vm = v[m % 3]; vo = v[o % 3];
+          ek = e[k % 3]; em = e[m % 3]; eo = e[o % 3];
+          if (MPFR_IS_SINGULAR (vm) || MPFR_IS_SINGULAR (vo))
+            {
+              /* an overflow or underflow occurred, or the value is zero:
+                 give up the recurrence */
+              giveup = 1;
+              break;
+            }
+          mpfr_ui_div (c, m, x, MPFR_RNDN);
+          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
+          mpfr_mul (t, c, vm, MPFR_RNDN);
+          mpfr_sub (vk, t, vo, MPFR_RNDN);
+          /* ek = |c| em (1 + 2^(-w)) + eo + 2^(EXP(c)+EXP(vm)-w)
+                  + 2^(EXP(vk)-w-1) */
+          mpfr_abs (tmp, c, MPFR_RNDU);
+          mpfr_mul (ek, em, tmp, MPFR_RNDU);
+          if (! MPFR_IS_ZERO (ek))
+            ADD_POW2 (ek, MPFR_GET_EXP (ek) - w);
+          mpfr_add (ek, ek, eo, MPFR_RNDU);
+          ADD_POW2 (ek, MPFR_GET_EXP (c) + MPFR_GET_EXP (vm) - w);
+          if (! MPFR_IS_ZERO (vk))
+            ADD_POW2 (ek, MPFR_GET_EXP (vk) - w - 1);
+          mpfr_jyn_range_round (tab, tv, k, vk, ek, w, &lost, r);
+        }
+
+      for (nfail = 0, k = 0; k < n; k++)
+        nfail += tv[k] == 2;
+      if (nfail == 0 || iter == 1 || giveup)
+        break;
+      /* retry with the number of lost bits observed */
+      w = pmax + lost + MPFR_INT_CEIL_LOG2 (pmax) + 10;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (c, w);
+      mpfr_set_prec (t, w);
+      for (i = 0; i < 3; i++)
+        mpfr_set_prec (v[i], w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  mpfr_clear (c);
+  mpfr_clear (t);
+  mpfr_clear (tmp);
+  for (i = 0; i < 3; i++)
+    {
+      mpfr_clear (v[i]);
+      mpfr_clear (e[i]);
+    }
+
+  MPFR_SAVE_EXPO_FREE (expo);
+
+  for (k = 0; k < n; k++)
+    {
+      if (tv[k] != 2)
+        inex = mpfr_check_range (tab[k], tv[k], r);
+      else /* the recurrence was not accurate enough for this order */
+        inex = yn ? mpfr_yn (tab[k], k, x, r) : mpfr_jn (tab[k], k, x, r);
+      if (tern != NULL)
+        tern[k] = inex;
+    }
+
+  MPFR_TMP_FREE (marker);
+}
+
+void
+mpfr_jn_range (mpfr_ptr *const tab, int *tern, unsigned long n,
+               mpfr_srcptr x, mpfr_rnd_t r)
+{
+  mpfr_jyn_range (tab, tern, n, x, r, 0);
+}
+
+void
+mpfr_yn_range (mpfr_ptr *const tab, int *tern, unsigned long n,
+               mpfr_srcptr x, mpfr_rnd_t r)
+{
+  mpfr_jyn_range (tab, tern, n, x, r, 1);
+}
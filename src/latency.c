@@ -0,0 +1,179 @@
+/* mpfr_latency_enable, mpfr_latency_export, mpfr_latency_reset --
+   latency histograms of the MPFR functions
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+#ifdef MPFR_HAVE_CLOCK_GETTIME
+# include <time.h>
+# ifndef CLOCK_MONOTONIC
+#  define CLOCK_MONOTONIC CLOCK_REALTIME
+# endif
+#elif defined (HAVE_GETTIMEOFDAY) && defined (HAVE_SYS_TIME_H)
+# include <sys/time.h>
+#else
+# include <time.h>
+#endif
+
+/* Like for the Ziv loop statistics (see ziv_stats.c), each instrumented
+   function has a per-thread record, declared by MPFR_LATENCY_FUNC (see
+   mpfr-impl.h), and the records are linked in a per-thread list. The
+   histogram of a record is only allocated the first time it is updated,
+   and it is freed by mpfr_free_cache, like the other per-thread caches.
+   Thus no locking is needed, and mpfr_latency_export is used to merge
+   the histograms of the different threads. */
+
+#define HIST_SIZE (MPFR_LATENCY_PREC_BUCKETS * MPFR_LATENCY_BINS)
+
+static MPFR_THREAD_ATTR mpfr_latency_rec_ptr latency_list = NULL;
+
+/* Return the current time in nanoseconds, from an arbitrary origin.
+   A monotonic clock is used if available; clock_gettime is only used
+   if it is in the C library, so that -lrt is not needed. */
+double
+mpfr_latency_now (void)
+{
+#ifdef MPFR_HAVE_CLOCK_GETTIME
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+#elif defined (HAVE_GETTIMEOFDAY) && defined (HAVE_SYS_TIME_H)
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (double) tv.tv_sec * 1e9 + (double) tv.tv_usec * 1e3;
+#else
+  return (double) clock () * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* Called at the entry of a timed call (see MPFR_LATENCY_FUNC); return
+   the start time. */
+double
+mpfr_latency_start (mpfr_latency_rec_ptr r, mpfr_prec_t prec)
+{
+  if (__gmpfr_instr & MPFR_INSTR_TRACE)
+    mpfr_trace_event (&r->trace_id, r->name, MPFR_TRACE_ENTER, 0, prec);
+  if (__gmpfr_instr & MPFR_INSTR_ALLOC)
+    mpfr_alloc_stats_start ();
+  return mpfr_latency_now ();
+}
+
+/* Called at the return of a timed call (see mpfr_latency_cleanup). */
+void
+mpfr_latency_stop (mpfr_latency_timer_t *t)
+{
+  mpfr_latency_rec_ptr r = t->rec;
+  double d = mpfr_latency_now () - t->start;
+  mpfr_prec_t q;
+  int k, j;
+
+  if (__gmpfr_instr & MPFR_INSTR_TRACE)
+    mpfr_trace_event (&r->trace_id, r->name, MPFR_TRACE_EXIT, 0, t->prec);
+  if (__gmpfr_instr & MPFR_INSTR_ALLOC)
+    mpfr_alloc_stats_stop (r);
+  if (!(__gmpfr_instr & MPFR_INSTR_LATENCY))
+    return;
+  if (MPFR_UNLIKELY (r->hist == NULL))
+    {
+      r->hist = (unsigned long *)
+        (*__gmp_allocate_func) (HIST_SIZE * sizeof (unsigned long));
+      memset (r->hist, 0, HIST_SIZE * sizeof (unsigned long));
+      r->next = latency_list;
+      latency_list = r;
+    }
+  for (k = 0, q = 64; k < MPFR_LATENCY_PREC_BUCKETS - 1 && t->prec > q;
+       k++, q *= 2);
+  for (j = 0; j < MPFR_LATENCY_BINS - 1 && d >= 2.0; j++)
+    d *= 0.5;
+  r->hist[k * MPFR_LATENCY_BINS + j] ++;
+}
+
+int
+mpfr_latency_enable (int enable)
+{
+  int old = (__gmpfr_instr & MPFR_INSTR_LATENCY) != 0;
+
+  if (enable)
+    __gmpfr_instr |= MPFR_INSTR_LATENCY;
+  else
+    __gmpfr_instr &= ~MPFR_INSTR_LATENCY;
+  return old;
+}
+
+/* Add the histograms of the current thread to those of tab[0..n-1],
+   where the entries with a NULL name are free. Return 0 if all the
+   histograms could be merged, non-zero if tab was too small. */
+int
+mpfr_latency_export (mpfr_latency_hist_t *tab, size_t n)
+{
+  mpfr_latency_rec_ptr r;
+  int lost = 0;
+
+  for (r = latency_list; r != NULL; r = r->next)
+    {
+      size_t i;
+      int k, j;
+
+      for (i = 0; i < n && tab[i].name != NULL &&
+             strcmp (tab[i].name, r->name) != 0; i++);
+      if (i == n)
+        {
+          lost = 1;
+          continue;
+        }
+      if (tab[i].name == NULL)
+        {
+          tab[i].name = r->name;
+          memset (tab[i].count, 0, sizeof (tab[i].count));
+        }
+      for (k = 0; k < MPFR_LATENCY_PREC_BUCKETS; k++)
+        for (j = 0; j < MPFR_LATENCY_BINS; j++)
+          tab[i].count[k][j] += r->hist[k * MPFR_LATENCY_BINS + j];
+    }
+  return lost;
+}
+
+void
+mpfr_latency_reset (void)
+{
+  mpfr_latency_rec_ptr r;
+
+  for (r = latency_list; r != NULL; r = r->next)
+    memset (r->hist, 0, HIST_SIZE * sizeof (unsigned long));
+}
+
+void
+mpfr_latency_freecache (void)
+{
+  mpfr_latency_rec_ptr r, next;
+
+  for (r = latency_list; r != NULL; r = next)
+    {
+      next = r->next;
+      (*__gmp_free_func) (r->hist, HIST_SIZE * sizeof (unsigned long));
+      r->hist = NULL;
+      r->next = NULL;
+    }
+  latency_list = NULL;
+}
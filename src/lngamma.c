@@ -23,35 +23,24 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
-/* given a precision p, return alpha, such that the argument reduction
-   will use k = alpha*p*log(2).
+/* alpha*1024 for the working precision p, where the argument reduction
+   uses k = alpha*p - z0, see below.
 
    Warning: we should always have alpha >= log(2)/(2Pi) ~ 0.11,
    and the smallest value of alpha multiplied by the smallest working
    precision should be >= 4.
+   Since gamma.c includes this file, mpfr_gamma has its own table, which
+   can be tuned separately from the one of mpfr_lngamma.
 */
-static void
-mpfr_gamma_alpha (mpfr_t s, mpfr_prec_t p)
-{
-  MPFR_LOG_FUNC
-    (("p=%Pu", p),
-     ("s[%Pu]=%.*Rg", mpfr_get_prec (s), mpfr_log_prec, s));
-
-  if (p <= 100)
-    mpfr_set_ui_2exp (s, 614, -10, MPFR_RNDN); /* about 0.6 */
-  else if (p <= 500)
-    mpfr_set_ui_2exp (s, 819, -10, MPFR_RNDN); /* about 0.8 */
-  else if (p <= 1000)
-    mpfr_set_ui_2exp (s, 1331, -10, MPFR_RNDN); /* about 1.3 */
-  else if (p <= 2000)
-    mpfr_set_ui_2exp (s, 1741, -10, MPFR_RNDN); /* about 1.7 */
-  else if (p <= 5000)
-    mpfr_set_ui_2exp (s, 2253, -10, MPFR_RNDN); /* about 2.2 */
-  else if (p <= 10000)
-    mpfr_set_ui_2exp (s, 3482, -10, MPFR_RNDN); /* about 3.4 */
-  else
-    mpfr_set_ui_2exp (s, 9, -1, MPFR_RNDN); /* 4.5 */
-}
+#ifdef IS_GAMMA
+static MPFR_TUNE_TAB_CONST short gamma_alpha_tab[] =
+  { MPFR_GAMMA_ALPHA_TAB };
+#define ALPHA_TAB gamma_alpha_tab
+#else
+static MPFR_TUNE_TAB_CONST short lngamma_alpha_tab[] =
+  { MPFR_LNGAMMA_ALPHA_TAB };
+#define ALPHA_TAB lngamma_alpha_tab
+#endif
 
 #ifdef IS_GAMMA
 
@@ -169,11 +158,11 @@ unit_bit (mpfr_srcptr x)
 static int
 GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
 {
-  mpfr_prec_t precy, w; /* working precision */
+  mpfr_prec_t precy, w, wm, g; /* working precision */
   mpfr_t s, t, u, v, z;
   unsigned long m, k, maxm, l;
   int compared, inexact;
-  mpfr_exp_t err_s, err_t;
+  mpfr_exp_t err_s, err_t, err_v;
   double d;
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
@@ -436,12 +425,15 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
          k ~ w*log(2)/2/log(Pi*e) ~ 0.1616 * w.
          However, since the series is slightly more expensive to compute,
          the optimal value seems to be k ~ 0.25 * w experimentally (with
-         caching of Bernoulli numbers).
+         caching of Bernoulli numbers), which is the default value of
+         alpha in MPFR_LNGAMMA_ALPHA_TAB and MPFR_GAMMA_ALPHA_TAB.
          For only one computation of gamma with large precision, it is better
          to set k to a larger value, say k ~ w. */
+      MPFR_STAT_STATIC_ASSERT (numberof (ALPHA_TAB)
+                               == MPFR_PREC_TAB_SIZE);
       mpfr_set_prec (s, 53);
-      mpfr_gamma_alpha (s, w);
-      mpfr_set_ui_2exp (s, 4, -4, MPFR_RNDU);
+      mpfr_set_ui_2exp (s, ALPHA_TAB[MPFR_PREC_TAB_INDEX (w)], -10,
+                        MPFR_RNDU);
       mpfr_mul_ui (s, s, w, MPFR_RNDU);
       if (mpfr_cmp (z0, s) < 0)
         {
@@ -494,8 +486,38 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
 
       /* s:(1+u)^15, t:(1+u)^2, t <= 3/128 */
 
+      /* The terms v[m] decrease quickly, thus they can be computed with a
+         lower precision as the summation goes on. Since t is multiplied by
+         u and by a factor less than 1, we have |v[m]| <= 2^e with
+         e = EXP(t) + EXP(u) + nbits(B[m]) before the update of t, thus we
+         round t (and v) to wm = w + g + e - EXP(s) bits, with
+         g = 2*ceil(log2(w)) + 6 guard bits (and wm >= g).
+         The precision of t never increases, thus all the roundings on t so
+         far are bounded by 2^(-PREC(t)), and with the error count below,
+         counting one more (1+u) for each change of precision, the error on
+         v[m] is bounded by 1.02*11m*2^(-PREC(t))*|v[m]| since PREC(t) >= g
+         and m < w/2 (the loop only goes on while |v[m-1]| >= 2^(-w-1), and
+         |v[m-1]| < 2^(-2m-1)). If PREC(t) >= wm, this is at most
+         11.3m*2^(EXP(s)-w-g) <= 11.3m/64/w^2*2^(EXP(s)-w), thus the sum over
+         m < w/2 is bounded by 2^(-4)*ulp(final_s) (the different values of s
+         differ by at most one binade, see below). Otherwise, we get a factor
+         2^(wm-PREC(t)) on that bound, and err_v records the maximum of
+         wm-PREC(t). */
+      g = 2 * MPFR_INT_CEIL_LOG2 (w) + 6;
+      err_v = 0;
       for (m = 2; MPFR_GET_EXP(v) + (mpfr_exp_t) w >= MPFR_GET_EXP(s); m++)
         {
+          wm = mpz_sizeinbase (mpfr_bernoulli_cache(m), 2);
+          wm += w + g + MPFR_GET_EXP(t) + MPFR_GET_EXP(u) - MPFR_GET_EXP(s);
+          if (wm < g)
+            wm = g;
+          if (wm < MPFR_PREC(t))
+            {
+              mpfr_prec_round (t, wm, MPFR_RNDN);
+              mpfr_set_prec (v, wm);
+            }
+          else if (wm - MPFR_PREC(t) > err_v)
+            err_v = wm - MPFR_PREC(t);
           mpfr_mul (t, t, u, MPFR_RNDN); /* (1+u)^(10m-14) */
           if (m <= maxm)
             {
@@ -518,22 +540,26 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
           MPFR_ASSERTD(MPFR_GET_EXP(v) <= - (2 * m + 3));
           mpfr_add (s, s, v, MPFR_RNDN);
         }
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (v, w);
       /* m <= 1/2*Pi*e*z ensures that |v[m]| < 1/2^(2m+3) */
       MPFR_ASSERTD ((double) m <= 4.26 * mpfr_get_d (z, MPFR_RNDZ));
 
-      /* We have sum([(1+u)^(10m-7)-1]*1/2^(2m+3), m=2..infinity)
-         <= 1.46*u for u <= 2^(-3).
-         We have 0 < lngamma(z) - [(z - 1/2) ln(z) - z + 1/2 ln(2 Pi)] < 0.021
+      /* We have 0 < lngamma(z) - [(z - 1/2) ln(z) - z + 1/2 ln(2 Pi)] < 0.021
          for z >= 4, thus since the initial s >= 0.85, the different values of
          s differ by at most one binade, and the total rounding error on s
          in the for-loop is bounded by 2*(m-1)*ulp(final_s).
          The error coming from the v's is bounded by
-         1.46*2^(-w) <= 2*ulp(final_s).
+         2^(err_v-4)*ulp(final_s) (see above), which is at most 2*ulp(final_s)
+         if err_v <= 5.
          Thus the total error so far is bounded by [(1+u)^15-1]*s+2m*ulp(s)
          <= (2m+47)*ulp(s).
          Taking into account the truncation error (which is bounded by the last
          term v[] according to 6.1.42 in A&S), the bound is (2m+48)*ulp(s).
+         If err_v > 5, this bound becomes (2m+48)*2^(err_v-5)*ulp(s), thus
+         we set err_v to the exponent of that extra factor.
       */
+      err_v = (err_v > 5) ? err_v - 5 : 0;
 
       /* add 1/2*log(2*Pi) and subtract log(z0*(z0+1)*...*(z0+k-1)) */
       mpfr_const_pi (v, MPFR_RNDN); /* v = Pi*(1+u) */
@@ -546,7 +572,13 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
 #if 1
 
       /* We multiply by (z0+1)*(z0+2)*...*(z0+k-1) by blocks of j consecutive
-         terms where j ~ sqrt(k).
+         terms. Each block costs j-1 multiplications by the integers c[i],
+         whose size grows like j*log2(k), and one multiplication in full
+         precision, besides the j-1 products needed to compute Z[2..j].
+         We take j ~ min(sqrt(k), sqrt(w/32)), which balances these costs:
+         the experimental optimum is about 6 for w = 1000, 10 for w = 3000,
+         18 for w = 10000 and 32 for w = 30000 (for k ~ w/4, j ~ sqrt(k)
+         would be about 2.8 times larger). The last block may be shorter.
          If we multiply naively by z0+1, then by z0+2, ..., then by z0+j,
          the multiplicative term for the rounding error is (1+u)^(2j).
          The multiplicative term is not larger when we multiply by
@@ -560,10 +592,12 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
          and Z[j] + c[j-1]*Z[j-1] + ... + c[1]*z0 + c[0] to (1+u)^(j+1).
          With the accumulation in t, we get (1+u)^(j+2) and j+2 <= 2j. */
       {
-        unsigned long j, i, p;
+        unsigned long j, jmax, i, p;
         mpfr_t *Z;
         mpz_t *c;
-        for (j = 2; (j + 1) * (j + 1) < k; j++);
+        for (j = 2; (j + 1) * (j + 1) < k && 32 * (j + 1) * (j + 1) <= (mpfr_uprec_t) w;
+             j++);
+        jmax = j;
         /* Z[i] stores z0^i for i <= j */
         Z = (mpfr_t *) (*__gmp_allocate_func) ((j + 1) * sizeof (mpfr_t));
         for (i = 2; i <= j; i++)
@@ -577,8 +611,10 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
         c = (mpz_t *) (*__gmp_allocate_func) ((j + 1) * sizeof (mpz_t));
         for (i = 0; i <= j; i++)
           mpz_init (c[i]);
-        for (; l + j <= k; l += j)
+        for (; l + 1 < k; l += j)
           {
+            if (l + j > k)
+              j = k - l; /* last block */
             /* c[i] is the coefficient of x^i in (x+l)*...*(x+l+j-1) */
             mpz_set_ui (c[0], 1);
             for (i = 0; i < j; i++)
@@ -604,12 +640,12 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
               }
             mpfr_mul (t, t, u, MPFR_RNDN);
           }
-        for (i = 0; i <= j; i++)
+        for (i = 0; i <= jmax; i++)
           mpz_clear (c[i]);
-        (*__gmp_free_func) (c, (j + 1) * sizeof (mpz_t));
-        for (i = 2; i <= j; i++)
+        (*__gmp_free_func) (c, (jmax + 1) * sizeof (mpz_t));
+        for (i = 2; i <= jmax; i++)
           mpfr_clear (Z[i]);
-        (*__gmp_free_func) (Z, (j + 1) * sizeof (mpfr_t));
+        (*__gmp_free_func) (Z, (jmax + 1) * sizeof (mpfr_t));
       }
 #endif /* end of fast argument reconstruction */
 
@@ -625,7 +661,7 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
       mpfr_div (v, v, t, MPFR_RNDN);
       /* 2*Pi/(z0*...*(z0+k-1))^2 (1+u)^(4k+1) */
 #ifdef IS_GAMMA
-      err_s = MPFR_GET_EXP(s);
+      err_s = MPFR_GET_EXP(s) + err_v;
       mpfr_exp (s, s, MPFR_RNDN);
       /* If s is +Inf, we compute exp(lngamma(z0)). */
       if (mpfr_inf_p (s))
@@ -637,9 +673,9 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
             goto ziv_next;
         }
       /* before the exponential, we have s = s0 + h where
-         |h| <= (2m+48)*ulp(s), thus exp(s0) = exp(s) * exp(-h).
+         |h| <= (2m+48)*2^err_v*ulp(s), thus exp(s0) = exp(s) * exp(-h).
          For |h| <= 1/4, we have |exp(h)-1| <= 1.2*|h| thus
-         |exp(s) - exp(s0)| <= 1.2 * exp(s) * (2m+48)* 2^(EXP(s)-w). */
+         |exp(s) - exp(s0)| <= 1.2 * exp(s) * (2m+48) * 2^(err_v+EXP(s)-w). */
       d = 1.2 * (2.0 * (double) m + 48.0);
       /* the error on s is bounded by d*2^err_s * 2^(-w) */
       mpfr_sqrt (t, v, MPFR_RNDN);
@@ -666,7 +702,7 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
       err_t = MPFR_GET_EXP(t) + (mpfr_exp_t)
         __gmpfr_ceil_log2 (2.2 * (double) k + 1.6);
       err_s = MPFR_GET_EXP(s) + (mpfr_exp_t)
-        __gmpfr_ceil_log2 (2.0 * (double) m + 48.0);
+        __gmpfr_ceil_log2 (2.0 * (double) m + 48.0) + err_v;
       mpfr_add (s, s, t, MPFR_RNDN); /* this is a subtraction in fact */
       /* the final error in ulp(s) is
          <= 1 + 2^(err_t-EXP(s)) + 2^(err_s-EXP(s))
@@ -708,6 +744,7 @@ int
 mpfr_lngamma (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
 {
   int inex;
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd),
@@ -748,6 +785,7 @@ int
 mpfr_lgamma (mpfr_ptr y, int *signp, mpfr_srcptr x, mpfr_rnd_t rnd)
 {
   int inex;
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd),
@@ -36,8 +36,185 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
      then for s>=1.26 we have log(s) < F(4/s) < log(s)*(1+4/s^2)
      from which we deduce pi/2/AG(1,4/s)*(1-4/s^2) < log(s) < pi/2/AG(1,4/s)
      so the relative error 4/s^2 is < 4/2^p i.e. 4 ulps.
+
+   For a target precision below MPFR_LOG_ATANH_THRESHOLD, we use instead
+   the formula log(m) = 2 atanh((m-1)/(m+1)), see mpfr_log_atanh below.
 */
 
+/* Compute log(a) for a > 0, a <> 1, as follows:
+   (1) write a = m*2^e with 3/4 <= m < 3/2, so that log(a) = log(m)+e*log(2);
+   (2) if |m-1| is not already small, replace m by t = m^(1/2^j) using j
+       square roots, so that |t-1| < 2^(-k) where k ~ sqrt(q/8), and
+       log(m) = 2^j*log(t);
+   (3) log(t) = 2 atanh(z) with z = (t-1)/(t+1), and atanh(z) = z*A where
+       A = 1 + z^2/3 + z^4/5 + ... is a series in y = z^2 with only half
+       the terms of the one of log(1+x). It is evaluated in fixed point
+       with mpz, with the same truncation scheme as mpfr_exp2_aux.
+
+   Error analysis, with w the working precision:
+   * the j square roots give t with a relative error <= 2^(1-w), thus
+     t-1 (exact by Sterbenz's lemma) has a relative error <= 2^(k+3-w)
+     since |t-1| >= 2^(-k-2); if j = 0, m-1 is only rounded, with a
+     relative error <= 2^(-w). Then z has a relative error <= 2^(k+4-w)
+     (respectively 4*2^(-w));
+   * in fixed point with unit 2^(-w), Y has an error <= 1, each term
+     T_i = T_{i-1}*Y has an error <= 4 since y < 1/16 (the truncation of
+     Y to the size of T_{i-1} and the final division add 1 unit each),
+     and each term T_i/(2i+1) adds an error <= 3. With N terms after the
+     first one, and the truncated tail (< 2), A has an absolute error
+     <= 3N+3 units, thus a relative error <= (3N+3)*2^(-w) since A >= 1;
+   * the conversion of A and the multiplication by z add 2^(-w) each.
+   Hence the relative error on L1 = 2^(j+1)*z*A is at most
+   2^(err1-w) with err1 = ceil(log2(rho + 3N + 5)) + 1 (the +1 accounts
+   for the second order terms) where rho = 2^(k+4) or 4 (the conversion
+   and the multiplication are done at once by mpfr_mul_z).
+   * L2 = o(o(log(2))*e) has an absolute error <= 2^(EXP(L2)+1-w);
+   * the final addition adds 1/2 ulp(L).
+   Thus the absolute error on L = L1 + L2 is bounded by
+   2^(max(EXP(L1)+err1, EXP(L2)+1, EXP(L)-1)+2-w). */
+static int
+mpfr_log_atanh (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
+{
+  mpfr_prec_t q, w;
+  mpfr_exp_t e, d, err, err1, exps;
+  mpfr_t m, t, u, y;
+  mpz_t S, T, U, Y;
+  unsigned long j, k, i;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+
+  MPFR_LOG_FUNC
+    (("a[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (a), mpfr_log_prec, a, rnd_mode),
+     ("r[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (r), mpfr_log_prec, r,
+      inexact));
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (a) && MPFR_IS_POS (a));
+
+  /* (1) a = m*2^e with 3/4 <= m < 3/2 */
+  e = MPFR_GET_EXP (a);
+  if (mpfr_cmp_ui_2exp (a, 3, e - 2) < 0)
+    e --;
+  MPFR_ALIAS (m, a, MPFR_SIGN_POS, MPFR_GET_EXP (a) - e);
+
+  q = MPFR_PREC (r);
+  k = __gmpfr_isqrt (q / 8) + 1;
+  w = q + k + MPFR_INT_CEIL_LOG2 (q) + 10;
+
+  mpfr_init2 (t, w);
+  mpfr_init2 (u, w);
+  mpfr_init2 (y, 2 * w);
+  mpz_init (S);
+  mpz_init (T);
+  mpz_init (U);
+  mpz_init (Y);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      if (mpfr_cmp_ui (m, 1) == 0)
+        {
+          /* log(m) = 0, and e <> 0 since a <> 1 */
+          MPFR_ASSERTD (e != 0);
+          mpfr_const_log2 (u, MPFR_RNDN);
+          mpfr_mul_si (t, u, (long) e, MPFR_RNDN);
+          err = MPFR_GET_EXP (t) + 1;
+        }
+      else
+        {
+          /* (2) reduce m */
+          mpfr_sub_ui (t, m, 1, MPFR_RNDN);
+          d = MPFR_GET_EXP (t); /* |m-1| < 2^d */
+          j = (d + (mpfr_exp_t) k > 0) ? d + k : 0;
+          if (j > 0)
+            {
+              mpfr_set (t, m, MPFR_RNDN);
+              for (i = 0; i < j; i++)
+                mpfr_sqrt (t, t, MPFR_RNDN);
+              mpfr_add_ui (u, t, 1, MPFR_RNDN);
+              mpfr_sub_ui (t, t, 1, MPFR_RNDN); /* exact */
+            }
+          else
+            mpfr_add_ui (u, m, 1, MPFR_RNDN);
+          mpfr_div (t, t, u, MPFR_RNDN); /* z = (t-1)/(t+1) */
+          MPFR_ASSERTD (MPFR_GET_EXP (t) <= -2);
+
+          /* (3) A = 1 + y/3 + y^2/5 + ... in fixed point, with y = z^2 */
+          inexact = mpfr_sqr (y, t, MPFR_RNDN);
+          MPFR_ASSERTD (inexact == 0);
+          exps = mpfr_get_z_2exp (Y, y);
+          if (exps + w >= 0)
+            mpz_mul_2exp (Y, Y, exps + w);
+          else
+            mpz_fdiv_q_2exp (Y, Y, - (exps + w));
+          mpz_set_ui (T, 1);
+          mpz_mul_2exp (T, T, w);
+          mpz_set (S, T);
+          for (i = 1; ; i++)
+            {
+              mpfr_prec_t tbit;
+
+              /* Since T < 2^tbit, the low w-tbit bits of Y contribute
+                 less than 1 unit to T*Y/2^w: truncate them. */
+              MPFR_MPZ_SIZEINBASE2 (tbit, T);
+              if (tbit < w)
+                {
+                  mpz_fdiv_q_2exp (U, Y, w - tbit);
+                  mpz_mul (T, T, U);
+                  mpz_fdiv_q_2exp (T, T, tbit);
+                }
+              else
+                {
+                  mpz_mul (T, T, Y);
+                  mpz_fdiv_q_2exp (T, T, w);
+                }
+              if (mpz_sgn (T) == 0)
+                break;
+              mpz_fdiv_q_ui (U, T, 2 * i + 1);
+              mpz_add (S, S, U);
+            }
+          /* i-1 terms after the first one, and rho <= 2^(k+4) */
+          err1 = (j > 0) ? MAX ((mpfr_exp_t) k + 4,
+                                MPFR_INT_CEIL_LOG2 (3 * (i - 1) + 5)) + 2
+            : MPFR_INT_CEIL_LOG2 (3 * (i - 1) + 9) + 1;
+
+          mpfr_mul_z (t, t, S, MPFR_RNDN);
+          mpfr_mul_2si (t, t, (long) j + 1 - w, MPFR_RNDN); /* L1 */
+          err = MPFR_GET_EXP (t) + err1;
+          if (e != 0)
+            {
+              mpfr_const_log2 (u, MPFR_RNDN);
+              mpfr_mul_si (u, u, (long) e, MPFR_RNDN); /* L2 */
+              err = MAX (err, MPFR_GET_EXP (u) + 1);
+              mpfr_add (t, t, u, MPFR_RNDN);
+              err = MAX (err, MPFR_GET_EXP (t) - 1) + 2;
+            }
+          else
+            err = MAX (err, MPFR_GET_EXP (t) - 1) + 2;
+        }
+      /* the error on t is at most 2^(err-w) */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - err + MPFR_GET_EXP (t),
+                                       q, rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (u, w);
+      mpfr_set_prec (y, 2 * w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (r, t, rnd_mode);
+
+  mpfr_clear (t);
+  mpfr_clear (u);
+  mpfr_clear (y);
+  mpz_clear (S);
+  mpz_clear (T);
+  mpz_clear (U);
+  mpz_clear (Y);
+
+  return inexact;
+}
+
 int
 mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
 {
@@ -47,6 +224,7 @@ mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
   MPFR_GROUP_DECL(group);
+  MPFR_LATENCY_FUNC (MPFR_PREC (r));
 
   MPFR_LOG_FUNC
     (("a[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (a), mpfr_log_prec, a, rnd_mode),
@@ -103,6 +281,14 @@ mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
 
   q = MPFR_PREC (r);
 
+  if (q < MPFR_LOG_ATANH_THRESHOLD)
+    {
+      MPFR_SAVE_EXPO_MARK (expo);
+      inexact = mpfr_log_atanh (r, a, rnd_mode);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (r, inexact, rnd_mode);
+    }
+
   /* use initial precision about q+lg(q)+5 */
   p = q + 5 + 2 * MPFR_INT_CEIL_LOG2 (q);
   /* % ~(mpfr_prec_t)GMP_NUMB_BITS  ;
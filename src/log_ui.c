@@ -33,55 +33,29 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
    truncate the rationals inside the algorithm, but then the error analysis
    should be redone. */
 
-/* Cf http://www.ginac.de/CLN/binsplit.pdf: the Taylor series of log(1+x)
-   up to order N for x=p/2^k is T/(B*Q).
-   P[0] <- (-p)^(n2-n1) [with opposite sign when n1=1]
-   q <- k*(n2-n1) [corresponding to Q[0] = 2^q]
-   B[0] <- n1 * (n1+1) * ... * (n2-1)
-   T[0] <- B[0]*Q[0] * S(n1,n2)
-   where S(n1,n2) = -sum((-x)^(i-n1+1)/i, i=n1..n2-1)
-   Assumes p is odd or zero, and -1/3 <= x = p/2^k <= 1/3.
-*/
+/* The Taylor series of log(1+x) for x=p/2^k is
+   log(1+x) = -sum((-x)^i/i, i=1..infinity), where the terms of the sum
+   correspond to a(i) = 1, b(i) = i, p(i) = -p and q(i) = 2^k, see
+   mpfr_bsplit. Since p(i) does not depend on i, we use MPFR_BSPLIT_POW.
+   Assumes p is odd or zero, and -1/3 <= x = p/2^k <= 1/3. */
+typedef struct {
+  long p;
+  unsigned long k;
+} log_ui_data;
+
 static void
-S (mpz_t *P, unsigned long *q, mpz_t *B, mpz_t *T, unsigned long n1,
-   unsigned long n2, long p, unsigned long k, int need_P)
+log_ui_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T, mp_bitcnt_t *f,
+             unsigned long n, void *data)
 {
-  MPFR_ASSERTD (n1 < n2);
-  MPFR_ASSERTD (p == 0 || ((unsigned long) p & 1) != 0);
-  if (n2 == n1 + 1)
-    {
-      mpz_set_si (P[0], (n1 == 1) ? p : -p);
-      *q = k;
-      mpz_set_ui (B[0], n1);
-      /* T = B*Q*S where S = P/(B*Q) thus T = P */
-      mpz_set (T[0], P[0]);
-      /* since p is odd (or zero), there is no common factor 2 between
-         P and Q, or T and B */
-    }
-  else
-    {
-      unsigned long m = (n1 / 2) + (n2 / 2) + (n1 & 1UL & n2), q1;
-      /* m = floor((n1+n2)/2) */
-
-      MPFR_ASSERTD (n1 < m && m < n2);
-      S (P, q, B, T, n1, m, p, k, 1);
-      S (P + 1, &q1, B + 1, T + 1, m, n2, p, k, need_P);
-
-      /* T0 <- T0*B1*Q1 + P0*B0*T1 */
-      mpz_mul (T[1], T[1], P[0]);
-      mpz_mul (T[1], T[1], B[0]);
-      mpz_mul (T[0], T[0], B[1]);
-      /* Q[1] = 2^q1 */
-      mpz_mul_2exp (T[0], T[0], q1); /* mpz_mul (T[0], T[0], Q[1]) */
-      mpz_add (T[0], T[0], T[1]);
-      if (need_P)
-        mpz_mul (P[0], P[0], P[1]);
-      *q += q1; /* mpz_mul (Q[0], Q[0], Q[1]) */
-      mpz_mul (B[0], B[0], B[1]);
-
-      /* there should be no common factors 2 between P, Q and T,
-         since P is odd (or zero) */
-    }
+  log_ui_data *d = (log_ui_data *) data;
+
+  (void) T; /* no a(n) */
+  MPFR_ASSERTD (d->p == 0 || ((unsigned long) d->p & 1) != 0);
+  mpz_set_si (P, d->p);
+  mpz_neg (P, P);
+  mpz_set_ui (Q, 1);
+  *f = d->k;
+  mpz_set_ui (B, n);
 }
 
 int
@@ -89,13 +63,14 @@ mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
 {
   unsigned long k;
   mpfr_prec_t w; /* working precision */
-  mpz_t three_n, *P, *B, *T;
+  mpz_t three_n;
   mpfr_t t, q;
   int inexact;
-  unsigned long N, lgN, i, kk;
+  unsigned long N, kk;
   long p;
+  log_ui_data d;
+  mpfr_bsplit_t bs;
   MPFR_GROUP_DECL(group);
-  MPFR_TMP_DECL(marker);
   MPFR_ZIV_DECL(loop);
   MPFR_SAVE_EXPO_DECL (expo);
 
@@ -145,9 +120,9 @@ mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
   /* n is now the value of p mod ULONG_MAX+1 */
   p = n > LONG_MAX ? - (long) - n : (long) n;
 
-  MPFR_TMP_MARK(marker);
   w = MPFR_PREC(x) + MPFR_INT_CEIL_LOG2 (MPFR_PREC(x)) + 10;
   MPFR_GROUP_INIT_2(group, w, t, q);
+  mpfr_bsplit_init (bs);
   MPFR_SAVE_EXPO_MARK (expo);
 
   kk = k;
@@ -163,7 +138,6 @@ mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
     {
       mpfr_t tmp;
       unsigned int err;
-      unsigned long q0;
 
       /* we need at most w/log2(2^kk/|p|) terms for an accuracy of w bits */
       mpfr_init2 (tmp, 32);
@@ -175,39 +149,26 @@ mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
       N = mpfr_get_ui (tmp, MPFR_RNDU);
       if (N < 2)
         N = 2;
-      lgN = MPFR_INT_CEIL_LOG2 (N) + 1;
       mpfr_clear (tmp);
-      P = (mpz_t *) MPFR_TMP_ALLOC (3 * lgN * sizeof (mpz_t));
-      B = P + lgN;
-      T = B + lgN;
-      for (i = 0; i < lgN; i++)
-        {
-          mpz_init (P[i]);
-          mpz_init (B[i]);
-          mpz_init (T[i]);
-        }
 
-      S (P, &q0, B, T, 1, N, p, kk, 0);
-      /* mpz_mul (Q[0], B[0], Q[0]); */
-      /* mpz_mul_2exp (B[0], B[0], q0); */
-
-      mpfr_set_z (t, T[0], MPFR_RNDN); /* t = P[0] * (1 + theta_1) */
-      mpfr_set_z (q, B[0], MPFR_RNDN); /* q = B[0] * (1 + theta_2) */
-      mpfr_mul_2exp (q, q, q0, MPFR_RNDN); /* B[0]*Q[0] */
-      mpfr_div (t, t, q, MPFR_RNDN);   /* t = T[0]/(B[0]*Q[0])*(1 + theta_3)^3
-                                            = log(n/2^k) * (1 + theta_4)^4
+      d.p = p;
+      d.k = kk;
+      mpfr_bsplit (bs, log_ui_term, &d, MPFR_BSPLIT_WITH_B | MPFR_BSPLIT_POW,
+                   1, N, 0);
+
+      /* here Q = 1 since q(i) = 2^k */
+      mpfr_set_z (t, MPFR_BSPLIT_T (bs), MPFR_RNDN); /* t = T*(1 + theta_1) */
+      mpfr_set_z (q, MPFR_BSPLIT_B (bs), MPFR_RNDN); /* q = B*(1 + theta_2) */
+      mpfr_mul_2exp (q, q, MPFR_BSPLIT_E (bs), MPFR_RNDN); /* B*2^e */
+      mpfr_div (t, t, q, MPFR_RNDN);   /* t = T/(B*2^e)*(1 + theta_3)^3
+                                            = -log(n/2^k) * (1 + theta_4)^4
                                             for |theta_i| < 2^(-w) */
+      mpfr_neg (t, t, MPFR_RNDN);
 
       /* argument reconstruction: add k*log(2) */
       mpfr_const_log2 (q, MPFR_RNDN);
       mpfr_mul_ui (q, q, k, MPFR_RNDN);
       mpfr_add (t, t, q, MPFR_RNDN);
-      for (i = 0; i < lgN; i++)
-        {
-          mpz_clear (P[i]);
-          mpz_clear (B[i]);
-          mpz_clear (T[i]);
-        }
       /* The maximal error is 5 ulps for P/Q, since |(1+/-u)^4 - 1| < 5*u
          for u < 2^(-12), k ulps for k*log(2), and 1 ulp for the addition,
          thus at most k+6 ulps.
@@ -226,8 +187,8 @@ mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
 
   inexact = mpfr_set (x, t, rnd_mode);
 
+  mpfr_bsplit_clear (bs);
   MPFR_GROUP_CLEAR(group);
-  MPFR_TMP_FREE(marker);
 
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (x, inexact, rnd_mode);
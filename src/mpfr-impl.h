@@ -228,8 +228,10 @@ extern MPFR_THREAD_ATTR mpfr_exp_t   __gmpfr_emin;
 extern MPFR_THREAD_ATTR mpfr_exp_t   __gmpfr_emax;
 extern MPFR_THREAD_ATTR mpfr_prec_t  __gmpfr_default_fp_bit_precision;
 extern MPFR_THREAD_ATTR mpfr_rnd_t   __gmpfr_default_rounding_mode;
+extern MPFR_THREAD_ATTR int          __gmpfr_instr;
 extern MPFR_CACHE_ATTR  mpfr_cache_t __gmpfr_cache_const_euler;
 extern MPFR_CACHE_ATTR  mpfr_cache_t __gmpfr_cache_const_catalan;
+extern MPFR_CACHE_ATTR  mpfr_cache_t __gmpfr_cache_const_2_over_pi;
 # ifndef MPFR_USE_LOGGING
 extern MPFR_CACHE_ATTR  mpfr_cache_t __gmpfr_cache_const_pi;
 extern MPFR_CACHE_ATTR  mpfr_cache_t __gmpfr_cache_const_log2;
@@ -1171,6 +1173,21 @@ typedef union { mp_size_t s; mp_limb_t l; } mpfr_size_limb_t;
 
 #include "mparam.h"
 
+/* Some crossovers depend both on the precision and on the magnitude of
+   the input (e.g., series versus asymptotic expansion). They are given
+   in mparam.h by tables of MPFR_PREC_TAB_SIZE values, the value for the
+   precision p being at index MPFR_PREC_TAB_INDEX(p): index 0 is for
+   p <= 64, index i for 2^(i+5) < p <= 2^(i+6), and the last index for
+   p > 4096. These tables are constant, except in tuneup, which defines
+   MPFR_TUNE_TAB_CONST to nothing before including the source files. */
+#define MPFR_PREC_TAB_SIZE 8
+#define MPFR_PREC_TAB_INDEX(p)                                          \
+  ((p) <= 64 ? 0 : (p) > 4096 ? MPFR_PREC_TAB_SIZE - 1                  \
+   : MPFR_INT_CEIL_LOG2 (p) - 6)
+#ifndef MPFR_TUNE_TAB_CONST
+# define MPFR_TUNE_TAB_CONST const
+#endif
+
 
 /******************************************************
  ******************  Useful macros  *******************
@@ -1741,11 +1758,76 @@ typedef struct {
 #define MPFR_ADD_PREC(P,X) \
   (MPFR_ASSERTN ((X) <= MPFR_PREC_MAX - (P)), (P) + (X))
 
+/* Bits of __gmpfr_instr, the per-thread switches of the instrumentation:
+   statistics on the Ziv loops (see ziv_stats.c), latency histograms (see
+   latency.c), binary trace (see trace.c) and allocation accounting (see
+   alloc_stats.c). */
+#define MPFR_INSTR_ZIV_STATS 1
+#define MPFR_INSTR_LATENCY   2
+#define MPFR_INSTR_TRACE     4
+#define MPFR_INSTR_ALLOC     8
+
+/* Kinds of trace events */
+#define MPFR_TRACE_ENTER 1 /* entry of a function, with the target prec */
+#define MPFR_TRACE_EXIT  2 /* exit of a function, with the target prec */
+#define MPFR_TRACE_ZIV   3 /* Ziv iteration, with the working precision */
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+__MPFR_DECLSPEC void mpfr_trace_event (unsigned int *, const char *, int,
+                                       int, mpfr_prec_t);
+#if defined (__cplusplus)
+}
+#endif
+
+/* Each Ziv loop has a static per-thread record, which is updated at each
+   iteration when the statistics or the trace are enabled for the current
+   thread. */
+
+typedef struct __mpfr_ziv_rec {
+  mpfr_ziv_stats_t       st;
+  struct __mpfr_ziv_rec *next;     /* next record of the thread */
+  int                    linked;   /* non-zero when in the list */
+  unsigned int           trace_id; /* see mpfr_trace_event */
+} mpfr_ziv_rec_t;
+typedef mpfr_ziv_rec_t *mpfr_ziv_rec_ptr;
+
+/* __func__ is C99; GCC also provides it in C89 mode. */
+#if (defined (__STDC_VERSION__) && __STDC_VERSION__ >= 199901L) || \
+  defined (__GNUC__) || defined (__cplusplus)
+# define MPFR_FUNC_NAME __func__
+#else
+# define MPFR_FUNC_NAME "?"
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+__MPFR_DECLSPEC void mpfr_ziv_update (mpfr_ziv_rec_ptr, int, mpfr_prec_t);
+#if defined (__cplusplus)
+}
+#endif
+
+#define MPFR_ZIV_INSTR_DECL(_x)                                         \
+  int _x ## _cpt;                                                       \
+  static MPFR_THREAD_ATTR mpfr_ziv_rec_t _x ## _rec =                   \
+    { { MPFR_FUNC_NAME, 0, 0, 0, 0 }, NULL, 0, 0 }
+
+#define MPFR_ZIV_INSTR_UPDATE(_x, _p)                                   \
+  (MPFR_UNLIKELY (__gmpfr_instr &                                       \
+                  (MPFR_INSTR_ZIV_STATS | MPFR_INSTR_TRACE)) ?          \
+   mpfr_ziv_update (&_x ## _rec, _x ## _cpt, (mpfr_prec_t) (_p))        \
+   : (void) 0)
+
 #ifndef MPFR_USE_LOGGING
 
-#define MPFR_ZIV_DECL(_x) mpfr_prec_t _x
-#define MPFR_ZIV_INIT(_x, _p) (_x) = GMP_NUMB_BITS
-#define MPFR_ZIV_NEXT(_x, _p) ((_p) = MPFR_ADD_PREC (_p, _x), (_x) = (_p)/2)
+#define MPFR_ZIV_DECL(_x) mpfr_prec_t _x; MPFR_ZIV_INSTR_DECL (_x)
+#define MPFR_ZIV_INIT(_x, _p)                                           \
+  ((_x) = GMP_NUMB_BITS, _x ## _cpt = 1, MPFR_ZIV_INSTR_UPDATE (_x, _p))
+#define MPFR_ZIV_NEXT(_x, _p)                                           \
+  ((_p) = MPFR_ADD_PREC (_p, _x), (_x) = (_p)/2, _x ## _cpt ++,         \
+   MPFR_ZIV_INSTR_UPDATE (_x, _p))
 #define MPFR_ZIV_FREE(x)
 
 #else
@@ -1766,7 +1848,7 @@ typedef struct {
 
 #define MPFR_ZIV_DECL(_x)                                               \
   mpfr_prec_t _x;                                                       \
-  int _x ## _cpt = 1;                                                   \
+  MPFR_ZIV_INSTR_DECL (_x);                                             \
   static unsigned long  _x ## _loop = 0, _x ## _bad = 0;                \
   static const char *_x ## _fname = __func__;                           \
   auto void __attribute__ ((destructor)) x ## _f  (void);               \
@@ -1785,6 +1867,8 @@ typedef struct {
   do                                                                    \
     {                                                                   \
       (_x) = GMP_NUMB_BITS;                                             \
+      _x ## _cpt = 1;                                                   \
+      MPFR_ZIV_INSTR_UPDATE (_x, _p);                                   \
       if (mpfr_log_level >= 0)                                          \
         _x ## _loop ++;                                                 \
       LOG_PRINT (MPFR_LOG_BADCASE_F, "%s:ZIV 1st prec=%Pd\n",           \
@@ -1800,6 +1884,7 @@ typedef struct {
       if (mpfr_log_level >= 0)                                          \
         _x ## _bad += (_x ## _cpt == 1);                                \
       _x ## _cpt ++;                                                    \
+      MPFR_ZIV_INSTR_UPDATE (_x, _p);                                   \
       LOG_PRINT (MPFR_LOG_BADCASE_F, "%s:ZIV new prec=%Pd\n",           \
                  __func__, (mpfr_prec_t) (_p));                         \
     }                                                                   \
@@ -1815,6 +1900,74 @@ typedef struct {
 #endif
 
 
+/******************************************************
+ ***************  Latency histograms  *****************
+ ******************************************************/
+
+/* The functions containing MPFR_LATENCY_FUNC (p) have a static per-thread
+   record, which accumulates a histogram of their latency (see latency.c)
+   when the histograms are enabled for the current thread; p is the
+   precision used to select the bucket, normally the one of the result.
+   When the trace is enabled, the entry and the exit are also traced, and
+   when the allocation accounting is enabled, the allocations done by the
+   outermost such call are attributed to its record (see alloc_stats.c).
+   MPFR_LATENCY_FUNC must be the last declaration of the function, and it
+   uses the cleanup attribute so that all the returns are taken into
+   account; with other compilers, it expands to nothing. */
+
+typedef struct __mpfr_latency_rec {
+  const char                *name;
+  unsigned long             *hist;     /* NULL until the first record */
+  struct __mpfr_latency_rec *next;     /* next record of the thread */
+  unsigned int               trace_id; /* see mpfr_trace_event */
+  mpfr_alloc_stats_t        *alloc;    /* NULL until the first count */
+  struct __mpfr_latency_rec *alloc_next; /* next record with alloc */
+} mpfr_latency_rec_t;
+typedef mpfr_latency_rec_t *mpfr_latency_rec_ptr;
+
+typedef struct {
+  mpfr_latency_rec_ptr rec;   /* NULL if the call is not timed */
+  mpfr_prec_t          prec;
+  double               start; /* in nanoseconds */
+} mpfr_latency_timer_t;
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+__MPFR_DECLSPEC double mpfr_latency_now (void);
+__MPFR_DECLSPEC double mpfr_latency_start (mpfr_latency_rec_ptr,
+                                          mpfr_prec_t);
+__MPFR_DECLSPEC void mpfr_latency_stop (mpfr_latency_timer_t *);
+__MPFR_DECLSPEC void mpfr_alloc_stats_start (void);
+__MPFR_DECLSPEC void mpfr_alloc_stats_stop (mpfr_latency_rec_ptr);
+#if defined (__cplusplus)
+}
+#endif
+
+#define MPFR_LATENCY_ON                                                 \
+  MPFR_UNLIKELY (__gmpfr_instr &                                        \
+                 (MPFR_INSTR_LATENCY | MPFR_INSTR_TRACE | MPFR_INSTR_ALLOC))
+
+#if __MPFR_GNUC(3,3) && !defined (__cplusplus)
+static __inline__ void
+mpfr_latency_cleanup (mpfr_latency_timer_t *t)
+{
+  if (MPFR_UNLIKELY (t->rec != NULL))
+    mpfr_latency_stop (t);
+}
+# define MPFR_LATENCY_FUNC(_p)                                          \
+  static MPFR_THREAD_ATTR mpfr_latency_rec_t __mpfr_latency_rec =      \
+    { MPFR_FUNC_NAME, NULL, NULL, 0, NULL, NULL };                      \
+  mpfr_latency_timer_t __mpfr_latency_timer                             \
+    __attribute__ ((cleanup (mpfr_latency_cleanup))) =                  \
+    { MPFR_LATENCY_ON ? &__mpfr_latency_rec : NULL, (_p),               \
+      MPFR_LATENCY_ON ? mpfr_latency_start (&__mpfr_latency_rec, (_p))  \
+      : 0.0 }
+#else
+# define MPFR_LATENCY_FUNC(_p)
+#endif
+
+
 /******************************************************
  ******************  Logging macros  ******************
  ******************************************************/
@@ -2125,6 +2278,7 @@ __MPFR_DECLSPEC int mpfr_const_pi_internal (mpfr_ptr,mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_const_log2_internal (mpfr_ptr,mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_const_euler_internal (mpfr_ptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_const_catalan_internal (mpfr_ptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_const_2_over_pi_internal (mpfr_ptr, mpfr_rnd_t);
 
 #if 0
 __MPFR_DECLSPEC void mpfr_init_cache (mpfr_cache_t,
@@ -2133,6 +2287,8 @@ __MPFR_DECLSPEC void mpfr_init_cache (mpfr_cache_t,
 __MPFR_DECLSPEC void mpfr_clear_cache (mpfr_cache_t);
 __MPFR_DECLSPEC int  mpfr_cache (mpfr_ptr, mpfr_cache_t,
                                  mpfr_rnd_t);
+__MPFR_DECLSPEC void mpfr_cache_window (mpz_ptr, mpfr_cache_t, mpfr_exp_t,
+                                       mpfr_prec_t);
 
 __MPFR_DECLSPEC void mpfr_mulhigh_n (mpfr_limb_ptr,
                         mpfr_limb_srcptr, mpfr_limb_srcptr, mp_size_t);
@@ -2158,9 +2314,20 @@ __MPFR_DECLSPEC void mpfr_rand_raw (mpfr_limb_ptr, gmp_randstate_t,
 __MPFR_DECLSPEC mpz_srcptr mpfr_bernoulli_cache (unsigned long);
 __MPFR_DECLSPEC void mpfr_bernoulli_freecache (void);
 
+__MPFR_DECLSPEC void mpfr_exp_2_freecache (void);
+__MPFR_DECLSPEC void mpfr_atan_freecache (void);
+__MPFR_DECLSPEC void mpfr_zeta_freecache (void);
+__MPFR_DECLSPEC void mpfr_latency_freecache (void);
+__MPFR_DECLSPEC void mpfr_alloc_stats_freecache (void);
+__MPFR_DECLSPEC void mpfr_trace_freecache (void);
+
 __MPFR_DECLSPEC int mpfr_sincos_fast (mpfr_t, mpfr_t,
                                       mpfr_srcptr, mpfr_rnd_t);
 
+__MPFR_DECLSPEC int mpfr_reduce_pi (mpfr_ptr, mpfr_srcptr, int);
+__MPFR_DECLSPEC mpfr_exp_t mpfr_sin_reduced (mpfr_ptr, mpfr_srcptr);
+__MPFR_DECLSPEC mpfr_exp_t mpfr_cos_reduced (mpfr_ptr, mpfr_srcptr);
+
 __MPFR_DECLSPEC double mpfr_scale2 (double, int);
 
 __MPFR_DECLSPEC void mpfr_div_ui2 (mpfr_ptr, mpfr_srcptr,
@@ -2266,6 +2433,54 @@ __MPFR_DECLSPEC extern int __gmpfr_cov_sum_tmd[MPFR_RND_MAX][2][2][3][2][2];
 #endif /* MPFR_COV_CHECK */
 
 
+/******************************************************
+ ***************  Binary splitting  *******************
+ ******************************************************/
+
+/* See bsplit.c */
+
+#define MPFR_BSPLIT_WITH_A 1 /* the terms have a factor a(n) */
+#define MPFR_BSPLIT_WITH_B 2 /* the terms have a factor 1/b(n) */
+#define MPFR_BSPLIT_POW    4 /* p(n) does not depend on n */
+
+typedef void (*mpfr_bsplit_term_t) (mpz_ptr, mpz_ptr, mpz_ptr, mpz_ptr,
+                                    mp_bitcnt_t *, unsigned long, void *);
+
+typedef struct {
+  int            alloc;  /* number of levels of the tables */
+  mpz_t         *tab;    /* P, Q, B, T of each level */
+  mp_bitcnt_t   *e;      /* power of two of Q of each level */
+  mpz_t         *pow;    /* powers of p, with MPFR_BSPLIT_POW */
+  unsigned long *powlen; /* corresponding exponents */
+  int            npow;
+  mpfr_bsplit_term_t term;
+  void          *data;
+  int            flags;
+} __mpfr_bsplit_struct;
+
+typedef __mpfr_bsplit_struct mpfr_bsplit_t[1];
+typedef __mpfr_bsplit_struct *mpfr_bsplit_ptr;
+
+#define MPFR_BSPLIT_P(bs) ((bs)->tab[0])
+#define MPFR_BSPLIT_Q(bs) ((bs)->tab[1])
+#define MPFR_BSPLIT_B(bs) ((bs)->tab[2])
+#define MPFR_BSPLIT_T(bs) ((bs)->tab[3])
+#define MPFR_BSPLIT_E(bs) ((bs)->e[0])
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+__MPFR_DECLSPEC void mpfr_bsplit_init (mpfr_bsplit_ptr);
+__MPFR_DECLSPEC void mpfr_bsplit_clear (mpfr_bsplit_ptr);
+__MPFR_DECLSPEC void mpfr_bsplit (mpfr_bsplit_ptr, mpfr_bsplit_term_t,
+                                  void *, int, unsigned long, unsigned long,
+                                  int);
+
+#if defined (__cplusplus)
+}
+#endif
+
 /******************************************************
  *****************  Unbounded Floats  *****************
  ******************************************************/
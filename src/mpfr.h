@@ -253,6 +253,36 @@ typedef enum {
   MPFR_FREE_GLOBAL_CACHE = 2
 } mpfr_free_cache_t;
 
+/* Statistics on a Ziv loop, see mpfr_ziv_stats_get */
+typedef struct {
+  const char    *name;     /* function containing the loop */
+  unsigned long  calls;    /* number of times the loop was entered */
+  unsigned long  failures; /* number of times the first iteration failed */
+  unsigned long  max_iter; /* maximal number of iterations */
+  mpfr_prec_t    max_prec; /* maximal working precision */
+} mpfr_ziv_stats_t;
+
+/* Latency histogram of a function, see mpfr_latency_export: count[k][j]
+   is the number of calls with a precision in bucket k (k = 0 for at most
+   64 bits, otherwise 2^(k+5) < prec <= 2^(k+6), the last bucket being
+   unbounded) that took between 2^j and 2^(j+1) nanoseconds (j = 0 for
+   less than 2 ns, the last bin being unbounded) */
+#define MPFR_LATENCY_PREC_BUCKETS 16
+#define MPFR_LATENCY_BINS 40
+typedef struct {
+  const char    *name;
+  unsigned long  count[MPFR_LATENCY_PREC_BUCKETS][MPFR_LATENCY_BINS];
+} mpfr_latency_hist_t;
+
+/* Allocations of a function, see mpfr_alloc_stats_export */
+typedef struct {
+  const char    *name;
+  unsigned long  calls;   /* number of outermost calls */
+  unsigned long  mallocs; /* number of allocations and reallocations */
+  size_t         bytes;   /* total number of allocated bytes */
+  size_t         peak;    /* maximal memory allocated by a call and live */
+} mpfr_alloc_stats_t;
+
 /* GMP defines:
     + size_t:                Standard size_t
     + __GMP_NOTHROW          For C++: can't throw .
@@ -467,6 +497,11 @@ __MPFR_DECLSPEC int mpfr_add_q (mpfr_ptr, mpfr_srcptr,
 __MPFR_DECLSPEC int mpfr_sub_q (mpfr_ptr, mpfr_srcptr,
                                 mpq_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_cmp_q (mpfr_srcptr, mpq_srcptr);
+__MPFR_DECLSPEC int mpfr_exp_q (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_log_q (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_atan_q (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_sin_q (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_cos_q (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
 #endif
 __MPFR_DECLSPEC int
   mpfr_set_str (mpfr_ptr, const char *, int, mpfr_rnd_t);
@@ -752,6 +787,8 @@ __MPFR_DECLSPEC int mpfr_hypot (mpfr_ptr, mpfr_srcptr,
                                 mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_erf (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_erfc (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC int mpfr_erf_erfc (mpfr_ptr, mpfr_ptr, mpfr_srcptr,
+                                   mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_cbrt (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_root (mpfr_ptr, mpfr_srcptr, unsigned long,
                                mpfr_rnd_t);
@@ -763,6 +800,9 @@ __MPFR_DECLSPEC int mpfr_lgamma (mpfr_ptr, int *, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_digamma (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_zeta (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_zeta_ui (mpfr_ptr, unsigned long, mpfr_rnd_t);
+__MPFR_DECLSPEC void mpfr_zeta_ui_range (mpfr_ptr *const, int *,
+                                         unsigned long, unsigned long,
+                                         mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_fac_ui (mpfr_ptr, unsigned long int,
                                  mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_j0 (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
@@ -773,6 +813,10 @@ __MPFR_DECLSPEC int mpfr_y0 (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_y1 (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 __MPFR_DECLSPEC int mpfr_yn (mpfr_ptr, long, mpfr_srcptr,
                              mpfr_rnd_t);
+__MPFR_DECLSPEC void mpfr_jn_range (mpfr_ptr *const, int *, unsigned long,
+                                    mpfr_srcptr, mpfr_rnd_t);
+__MPFR_DECLSPEC void mpfr_yn_range (mpfr_ptr *const, int *, unsigned long,
+                                    mpfr_srcptr, mpfr_rnd_t);
 
 __MPFR_DECLSPEC int mpfr_ai (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
 
@@ -811,6 +855,17 @@ __MPFR_DECLSPEC int mpfr_sum (mpfr_ptr, mpfr_ptr *const,
 __MPFR_DECLSPEC void mpfr_free_cache (void);
 __MPFR_DECLSPEC void mpfr_free_cache2 (mpfr_free_cache_t);
 
+__MPFR_DECLSPEC int  mpfr_ziv_stats_enable (int);
+__MPFR_DECLSPEC int  mpfr_ziv_stats_get (mpfr_ziv_stats_t *, unsigned long);
+__MPFR_DECLSPEC void mpfr_ziv_stats_reset (void);
+__MPFR_DECLSPEC int  mpfr_latency_enable (int);
+__MPFR_DECLSPEC int  mpfr_latency_export (mpfr_latency_hist_t *, size_t);
+__MPFR_DECLSPEC void mpfr_latency_reset (void);
+__MPFR_DECLSPEC int  mpfr_alloc_stats_enable (int);
+__MPFR_DECLSPEC int  mpfr_alloc_stats_export (mpfr_alloc_stats_t *, size_t);
+__MPFR_DECLSPEC void mpfr_alloc_stats_reset (void);
+__MPFR_DECLSPEC int  mpfr_trace_enable (size_t);
+
 __MPFR_DECLSPEC int  mpfr_subnormalize (mpfr_ptr, int,
                                         mpfr_rnd_t);
 
@@ -1167,6 +1222,8 @@ __MPFR_DECLSPEC int mpfr_fprintf (FILE*, const char*,
 #define mpfr_fpif_import __gmpfr_fpif_import
 __MPFR_DECLSPEC int    mpfr_fpif_export (FILE*, mpfr_ptr);
 __MPFR_DECLSPEC int    mpfr_fpif_import (mpfr_ptr, FILE*);
+#define mpfr_trace_dump __gmpfr_trace_dump
+__MPFR_DECLSPEC int    mpfr_trace_dump (FILE*);
 
 #if defined (__cplusplus)
 }
@@ -402,6 +402,9 @@ mpfr_pow_general (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y,
   return inexact;
 }
 
+/* maximal exponent of an integer y for which mpfr_pow uses mpfr_pow_z */
+static MPFR_TUNE_TAB_CONST short pow_z_tab[] = { MPFR_POW_Z_TAB };
+
 /* The computation of z = pow(x,y) is done by
    z = exp(y * log(x)) = x^y
    For the special cases, see Section F.9.4.4 of the C standard:
@@ -430,6 +433,7 @@ mpfr_pow (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y, mpfr_rnd_t rnd_mode)
   int cmp_x_1;
   int y_is_integer;
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (z));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg y[%Pu]=%.*Rg rnd=%d",
@@ -637,14 +641,17 @@ mpfr_pow (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y, mpfr_rnd_t rnd_mode)
     }
 
   /* If y is an integer, we can use mpfr_pow_z (based on multiplications),
-     but if y is very large (I'm not sure about the best threshold -- VL),
-     we shouldn't use it, as it can be very slow and take a lot of memory
-     (and even crash or make other programs crash, as several hundred of
-     MBs may be necessary). Note that in such a case, either x = +/-2^b
+     but if y is very large, we shouldn't use it, as it can be very slow
+     and take a lot of memory (and even crash or make other programs crash,
+     as several hundred of MBs may be necessary). The threshold on EXP(y)
+     is given by MPFR_POW_Z_TAB for the target precision. It should be at
+     least MPFR_PREC_BITS: then for EXP(y) above it, either x = +/-2^b
      (this case is handled below) or x^y cannot be represented exactly in
      any precision supported by MPFR (the general case uses this property).
   */
-  if (y_is_integer && (MPFR_GET_EXP (y) <= 256))
+  MPFR_STAT_STATIC_ASSERT (numberof (pow_z_tab) == MPFR_PREC_TAB_SIZE);
+  if (y_is_integer && MPFR_GET_EXP (y)
+      <= pow_z_tab[MPFR_PREC_TAB_INDEX (MPFR_PREC (z))])
     {
       mpz_t zi;
 
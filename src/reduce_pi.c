@@ -0,0 +1,143 @@
+/* mpfr_reduce_pi -- Payne-Hanek argument reduction for huge arguments
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Declare the cache of 2/Pi (internal constant, cleared by
+   mpfr_free_cache like the other constants) */
+MPFR_DECL_INIT_CACHE(__gmpfr_cache_const_2_over_pi,
+                     mpfr_const_2_over_pi_internal);
+
+/* Don't need to save/restore exponent range: the cache does it */
+int
+mpfr_const_2_over_pi_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t;
+  mpfr_prec_t px, w;
+  int inex;
+  MPFR_ZIV_DECL (loop);
+
+  px = MPFR_PREC (x);
+  w = px + MPFR_INT_CEIL_LOG2 (px) + 10;
+  mpfr_init2 (t, w);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      mpfr_const_pi (t, MPFR_RNDN);  /* relative error <= 2^(-w) */
+      mpfr_ui_div (t, 2, t, MPFR_RNDN);
+      /* the relative error is at most (1+2^(-w))^2 - 1 <= 2^(2-w),
+         thus the error is at most 4 ulps since 1/2 <= 2/Pi < 1 */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 2, px, rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+  inex = mpfr_set (x, t, rnd_mode);
+  mpfr_clear (t);
+  return inex;
+}
+
+/* Payne-Hanek argument reduction of the regular number x modulo
+   P = 2*Pi/2^j, with j = 0 (reduction modulo 2*Pi) or j = 2 (reduction
+   modulo Pi/2). Set r to an approximation of x - q*P, where q is an
+   integer nearest to x/P, thus |r| <= P/2 + epsilon, and return q mod 4.
+   The error satisfies |r - (x - q*P)| <= 2^(2-j-PREC(r)) (r may be 0).
+
+   Write x = M*2^F with M an integer of PREC(x) bits, and let C = 2/Pi.
+   We have x/P = M*C*2^(F+j-2), and since M*2^(F+j-2) times any bit of C
+   of weight >= 2^(4-F-j) is a multiple of 4, only the bits of C of weight
+   2^(3-F-j) to 2^(4-F-j-n) are needed to get x/P mod 4 with n-PREC(x)-2
+   correct bits after the binary point. They are read from the cache of
+   2/Pi (see mpfr_cache_window), thus the cost is O(M(PREC(x)+PREC(r)))
+   once the cache has enough precision, whatever the exponent of x.
+
+   Error analysis, with p = PREC(r): if F < -p-8, we first truncate M so
+   that F = -p-8, which changes x by less than 2^(-p-8), thus x/P by less
+   than 2^(-p-8) too, since 2^j/(2*Pi) < 1; now let k <= PREC(x) be the
+   number of bits of M, n = k + p + 9, and z the integer formed by the n
+   bits of C as above. Both the truncation of C and the error of at most 1
+   on z yield an error less than 2^(k+2-n) on u = M*z*2^(2-n) mod 4, thus
+   t = u - q in [-1/2, 1/2] has an error less than
+   2^(k+3-n) + 2^(-p-8) < 2^(-p-5). Then:
+   (a) t is rounded to p+4 bits: error <= 2^(-p-5);
+   (b) the error on Pi rounded to p+4 bits is at most 2^(-p-3);
+   (c) the product t*Pi*2^(1-j) is rounded to p bits, with |t*Pi| < 2:
+       error <= 2^(1-j-p).
+   Since P <= 8*2^(-j) and |t| <= 1/2, the total error is at most
+   2^(-j-p) * (1/4 + 1/4 + 1/8 + 2) <= 2^(2-j-p). */
+int
+mpfr_reduce_pi (mpfr_ptr r, mpfr_srcptr x, int j)
+{
+  mpz_t M, z;
+  mpfr_t t, pi;
+  mpfr_exp_t F;
+  mpfr_prec_t p, n;
+  int q;
+
+  MPFR_LOG_FUNC
+    (("x[%Pu]=%.*Rg j=%d", mpfr_get_prec (x), mpfr_log_prec, x, j),
+     ("r[%Pu]=%.*Rg", mpfr_get_prec (r), mpfr_log_prec, r));
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+  MPFR_ASSERTD (j == 0 || j == 2);
+
+  p = MPFR_PREC (r);
+
+  mpz_init (M);
+  mpz_init (z);
+  F = mpfr_get_z_2exp (M, x);  /* x = M*2^F, exact */
+  if (F < - (mpfr_exp_t) p - 8)
+    {
+      /* the bits of x of weight < 2^(-p-8) are not significant */
+      mpz_tdiv_q_2exp (M, M, - (mpfr_exp_t) p - 8 - F);
+      F = - (mpfr_exp_t) p - 8;
+    }
+  MPFR_MPZ_SIZEINBASE2 (n, M);
+  n += p + 9;
+  mpfr_cache_window (z, __gmpfr_cache_const_2_over_pi, 4 - F - j, n);
+  mpz_mul (z, z, M);
+  mpz_fdiv_r_2exp (z, z, n);  /* z*2^(2-n) = x/P mod 4 */
+
+  /* q = round(z*2^(2-n)) mod 4, and z <- z - q*2^(n-2) */
+  mpz_set_ui (M, 1);
+  mpz_mul_2exp (M, M, n - 3);  /* 1/2 */
+  mpz_add (z, z, M);
+  q = mpz_tstbit (z, n - 2) + 2 * mpz_tstbit (z, n - 1);
+  mpz_fdiv_r_2exp (z, z, n - 2);
+  mpz_sub (z, z, M);
+
+  mpfr_init2 (t, p + 4);
+  mpfr_init2 (pi, p + 4);
+  mpfr_set_z_2exp (t, z, 2 - n, MPFR_RNDN);
+  mpfr_const_pi (pi, MPFR_RNDN);
+  mpfr_mul (r, t, pi, MPFR_RNDN);
+  mpfr_mul_2si (r, r, 1 - j, MPFR_RNDN);  /* exact */
+
+  mpfr_clear (t);
+  mpfr_clear (pi);
+  mpz_clear (M);
+  mpz_clear (z);
+
+  return q;
+}
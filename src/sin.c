@@ -38,11 +38,12 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
   mpfr_t c, xr;
   mpfr_srcptr xx;
-  mpfr_exp_t expx, err;
+  mpfr_exp_t expx, err, k;
   mpfr_prec_t precy, m;
-  int inexact, sign, reduce;
+  int inexact, reduce, q;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
@@ -80,96 +81,62 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       goto end;
     }
 
-  m = precy + MPFR_INT_CEIL_LOG2 (precy) + 13;
+  /* the cosine kernel loses about 2*sqrt(m/3) bits in the doublings,
+     the sine kernel less */
+  m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * __gmpfr_isqrt (precy / 3);
   expx = MPFR_GET_EXP (x);
+  reduce = expx >= 1;
 
-  mpfr_init (c);
-  mpfr_init (xr);
+  mpfr_init2 (c, m);
+  if (reduce)
+    mpfr_init2 (xr, m);
 
   MPFR_ZIV_INIT (loop, m);
   for (;;)
     {
-      /* first perform argument reduction modulo 2*Pi (if needed),
-         also helps to determine the sign of sin(x) */
-      if (expx >= 2) /* If Pi < x < 4, we need to reduce too, to determine
-                        the sign of sin(x). For 2 <= |x| < Pi, we could avoid
-                        the reduction. */
+      /* If |x| >= 1, first reduce x modulo Pi/2 into xr, with
+         |xr| <= Pi/4 + 2^(-m) < 1, using the Payne-Hanek reduction:
+         |xr - (x - (q+4n)*Pi/2)| <= 2^(-m), where m is the precision
+         of xr. Then sin(x) = sin(xr), cos(xr), -sin(xr) or -cos(xr) for
+         q = 0, 1, 2, 3, with an additional error of at most 2^(-m).
+         Contrary to the computation of sin(x) from cos(x), there is no
+         cancellation near multiples of Pi (besides in the reduction). */
+      if (reduce)
         {
-          reduce = 1;
-          /* As expx + m - 1 will silently be converted into mpfr_prec_t
-             in the mpfr_set_prec call, the assert below may be useful to
-             avoid undefined behavior. */
-          MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
-          mpfr_set_prec (c, expx + m - 1);
-          mpfr_set_prec (xr, m);
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          /* The analysis is similar to that of cos.c:
-             |xr - x - 2kPi| <= 2^(2-m). Thus we can decide the sign
-             of sin(x) if xr is at distance at least 2^(2-m) of both
-             0 and +/-Pi. */
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
-          /* Since c approximates Pi with an error <= 2^(2-expx-m) <= 2^(-m),
-             it suffices to check that c - |xr| >= 2^(2-m). */
-          if (MPFR_IS_POS (xr))
-            mpfr_sub (c, c, xr, MPFR_RNDZ);
-          else
-            mpfr_add (c, c, xr, MPFR_RNDZ);
-          if (MPFR_IS_ZERO(xr)
-              || MPFR_GET_EXP(xr) < (mpfr_exp_t) 3 - (mpfr_exp_t) m
-              || MPFR_IS_ZERO(c)
-              || MPFR_GET_EXP(c) < (mpfr_exp_t) 3 - (mpfr_exp_t) m)
+          q = mpfr_reduce_pi (xr, x, 2);
+          /* |xr| >= 1 may only happen for a tiny working precision */
+          if (MPFR_IS_ZERO (xr) || MPFR_GET_EXP (xr) > 0)
             goto ziv_next;
-
-          /* |xr - x - 2kPi| <= 2^(2-m), thus |sin(xr) - sin(x)| <= 2^(2-m) */
           xx = xr;
         }
       else /* the input argument is already reduced */
         {
-          reduce = 0;
+          q = 0;
           xx = x;
         }
 
-      sign = MPFR_SIGN(xx);
-      /* now that the argument is reduced, precision m is enough */
-      mpfr_set_prec (c, m);
-      mpfr_cos (c, xx, MPFR_RNDZ);    /* can't be exact */
-      mpfr_nexttoinf (c);           /* now c = cos(x) rounded away */
-      mpfr_mul (c, c, c, MPFR_RNDU); /* away */
-      mpfr_ui_sub (c, 1, c, MPFR_RNDZ);
-      mpfr_sqrt (c, c, MPFR_RNDZ);
-      if (MPFR_IS_NEG_SIGN(sign))
-        MPFR_CHANGE_SIGN(c);
-
-      /* Warning: c may be 0! */
-      if (MPFR_UNLIKELY (MPFR_IS_ZERO (c)))
-        {
-          /* Huge cancellation: increase prec a lot! */
-          m = MAX (m, MPFR_PREC (x));
-          m = 2 * m;
-        }
-      else
-        {
-          /* the absolute error on c is at most 2^(3-m-EXP(c)),
-             plus 2^(2-m) if there was an argument reduction.
-             Since EXP(c) <= 1, 3-m-EXP(c) >= 2-m, thus the error
-             is at most 2^(3-m-EXP(c)) in case of argument reduction. */
-          err = 2 * MPFR_GET_EXP (c) + (mpfr_exp_t) m - 3 - (reduce != 0);
-          if (MPFR_CAN_ROUND (c, err, precy, rnd_mode))
-            break;
-
-          /* check for huge cancellation (Near 0) */
-          if (err < (mpfr_exp_t) MPFR_PREC (y))
-            m += MPFR_PREC (y) - err;
-          /* Check if near 1 */
-          if (MPFR_GET_EXP (c) == 1)
-            m += m;
-        }
+      k = (q & 1) ? mpfr_cos_reduced (c, xx) : mpfr_sin_reduced (c, xx);
+      if (q >= 2)
+        MPFR_CHANGE_SIGN (c);
+
+      /* the error on c is bounded by 2^(EXP(c)+k-m), plus 2^(-m) if there
+         was an argument reduction: in all cases it is at most 2^(k-m) with
+         the following value of k */
+      k = reduce ? MAX (MPFR_GET_EXP (c) + k, 0) + 1 : MPFR_GET_EXP (c) + k;
+      err = MPFR_GET_EXP (c) + (mpfr_exp_t) m - k;
+      if (MPFR_CAN_ROUND (c, err, precy, rnd_mode))
+        break;
+
+      /* check for huge cancellation (x near a multiple of Pi) */
+      if (err < (mpfr_exp_t) precy)
+        m += precy - err;
 
     ziv_next:
       /* Else generic increase */
       MPFR_ZIV_NEXT (loop, m);
+      mpfr_set_prec (c, m);
+      if (reduce)
+        mpfr_set_prec (xr, m);
     }
   MPFR_ZIV_FREE (loop);
 
@@ -178,7 +145,8 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
      within the target precision, but in that case mpfr_can_round will fail */
 
   mpfr_clear (c);
-  mpfr_clear (xr);
+  if (reduce)
+    mpfr_clear (xr);
 
  end:
   MPFR_SAVE_EXPO_FREE (expo);
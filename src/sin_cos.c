@@ -36,6 +36,7 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   int inexy, inexz;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MAX (MPFR_PREC (y), MPFR_PREC (z)));
 
   MPFR_ASSERTN (y != z);
 
@@ -141,12 +142,10 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       if (expx >= 2) /* reduce the argument */
         {
           reduce = 1;
-          mpfr_set_prec (c, expx + m - 1);
+          mpfr_set_prec (c, m + 2);
           mpfr_set_prec (xr, m);
+          mpfr_reduce_pi (xr, x, 0);
           mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
           if (MPFR_IS_POS (xr))
             mpfr_sub (c, c, xr, MPFR_RNDZ);
           else
@@ -262,36 +261,54 @@ reduce2 (mpz_t S, mpz_t C, mpfr_prec_t prec)
   return l;
 }
 
+typedef struct {
+  mpz_srcptr pp;
+  unsigned long r;
+} sin_bs_data;
+
+/* Term of index n >= 1 of the series of sin(X)/X, see mpfr_bsplit */
+static void
+sin_bs_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T, mp_bitcnt_t *f,
+             unsigned long n, void *data)
+{
+  sin_bs_data *d = (sin_bs_data *) data;
+
+  (void) B; (void) T; /* no a(n) nor b(n) */
+  mpz_neg (P, d->pp);
+  mpz_set_ui (Q, 2 * n);
+  mpz_mul_ui (Q, Q, 2 * n + 1);
+  *f = d->r;
+}
+
 /* return in S0/Q0 a rational approximation of sin(X) with absolute error
                      bounded by 9*2^(-prec), where 0 <= X=p/2^r <= 1/2,
    and in    C0/Q0 a rational approximation of cos(X), with relative error
                      bounded by 9*2^(-prec) (and also absolute error, since
                      |cos(X)| <= 1).
    We have sin(X)/X = sum((-1)^i*(p/2^r)^i/(2i+1)!, i=0..infinity).
-   We use the following binary splitting formula:
-   P(a,b) = (-p)^(b-a)
-   Q(a,b) = (2a)*(2a+1)*2^r if a+1=b [except Q(0,1)=1], Q(a,c)*Q(c,b) otherwise
-   T(a,b) = 1 if a+1=b, Q(c,b)*T(a,c)+P(a,c)*T(c,b) otherwise.
-
-   Since we use P(a,b) for b-a=2^k only, we compute only p^(2^k).
-   We do not store the factor 2^r in Q().
-
-   Then sin(X)/X ~ T(0,i)/Q(0,i) for i so that (p/2^r)^i/i! is small enough.
+   We write X^2 = pp/2^r' with pp odd, and we sum the terms of index 1 to
+   N-1 by binary splitting (mpfr_bsplit with MPFR_BSPLIT_POW, since
+   p(i) = -pp for all i), with q(i) = (2i)*(2i+1)*2^r'. This gives T/(Q*2^e),
+   thus sin(X)/X ~ (Q*2^e + T)/(Q*2^e).
+   The term of index i, multiplied by X, is bounded by
+   2^(-(r - size(p)) - i*(r' - size(pp)))/(2i+1)!, with
+   (2i+1)! >= 2^(floor(log2(2)) + ... + floor(log2(2i+1))): we choose N so
+   that the first neglected term is less than 2^(-prec).
 
    Return l such that Q0 has to be multiplied by 2^l.
+   bs is used as temporary storage.
 
    Assumes prec >= 10.
 */
 static unsigned long
 sin_bs_aux (mpz_t Q0, mpz_t S0, mpz_t C0, mpz_srcptr p, mpfr_prec_t r,
-            mpfr_prec_t prec)
+            mpfr_prec_t prec, mpfr_bsplit_ptr bs)
 {
-  mpz_t T[GMP_NUMB_BITS], Q[GMP_NUMB_BITS], ptoj[GMP_NUMB_BITS], pp;
-  mpfr_prec_t log2_nb_terms[GMP_NUMB_BITS], mult[GMP_NUMB_BITS];
-  mpfr_prec_t accu[GMP_NUMB_BITS], size_ptoj[GMP_NUMB_BITS];
-  mpfr_prec_t prec_i_have, h, r0 = r, pp_s, p_s;
-  unsigned long i, j, m;
-  int alloc, k, l;
+  mpz_t pp;
+  mpz_ptr T;
+  sin_bs_data data;
+  mpfr_prec_t h, r0 = r, d, b;
+  unsigned long i, lg, m;
 
   if (MPFR_UNLIKELY(mpz_cmp_ui (p, 0) == 0)) /* sin(x)/x -> 1 */
     {
@@ -312,118 +329,46 @@ sin_bs_aux (mpz_t Q0, mpz_t S0, mpz_t C0, mpz_srcptr p, mpfr_prec_t r,
   mpz_mul (pp, pp, pp);
   r = 2 * (r - h);            /* x^2 = (p/2^r0)^2 = pp / 2^r */
 
-  /* now p is odd */
-  alloc = 2;
-  mpz_init_set_ui (T[0], 6);
-  mpz_init_set_ui (Q[0], 6);
-  mpz_init_set (ptoj[0], pp); /* ptoj[i] = pp^(2^i) */
-  mpz_init (T[1]);
-  mpz_init (Q[1]);
-  mpz_init (ptoj[1]);
-  mpz_mul (ptoj[1], pp, pp);  /* ptoj[1] = pp^2 */
-  MPFR_MPZ_SIZEINBASE2(size_ptoj[1], ptoj[1]);
-
-  mpz_mul_2exp (T[0], T[0], r);
-  mpz_sub (T[0], T[0], pp);      /* 6*2^r - pp = 6*2^r*(1 - x^2/6) */
-  log2_nb_terms[0] = 1;
-
-  /* already take into account the factor x=p/2^r in sin(x) = x * (...) */
-  MPFR_MPZ_SIZEINBASE2(pp_s, pp);
-  MPFR_MPZ_SIZEINBASE2(p_s, p);
-  mult[0] = r - pp_s + r0 - p_s;
-  /* we have x^3 < 1/2^mult[0] */
-
-  for (i = 2, k = 0, prec_i_have = mult[0]; prec_i_have < prec; i += 2)
+  /* number of terms: b = (r0 - size(p)) + N*d + floor(log2(2)) + ...
+     + floor(log2(2N+1)), where x^2 < 1/2^d */
+  d = r - (mpfr_prec_t) mpz_sizeinbase (pp, 2);
+  b = r0 - (mpfr_prec_t) mpz_sizeinbase (p, 2) + d + 2;
+  for (i = 1, lg = 1; i < 2 || b < prec; )
     {
-      /* i is even here */
-      /* invariant: Q[0]*Q[1]*...*Q[k] equals (2i-1)!,
-         we have already summed terms of index < i
-         in S[0]/Q[0], ..., S[k]/Q[k] */
-      k ++;
-      if (k + 1 >= alloc) /* necessarily k + 1 = alloc */
-        {
-          alloc ++;
-          mpz_init (T[k+1]);
-          mpz_init (Q[k+1]);
-          mpz_init (ptoj[k+1]);
-          mpz_mul (ptoj[k+1], ptoj[k], ptoj[k]); /* pp^(2^(k+1)) */
-          MPFR_MPZ_SIZEINBASE2(size_ptoj[k+1], ptoj[k+1]);
-        }
-      /* for i even, we have Q[k] = (2*i)*(2*i+1), T[k] = 1,
-         then                Q[k+1] = (2*i+2)*(2*i+3), T[k+1] = 1,
-         which reduces to T[k] = (2*i+2)*(2*i+3)*2^r-pp,
-         Q[k] = (2*i)*(2*i+1)*(2*i+2)*(2*i+3). */
-      log2_nb_terms[k] = 1;
-      mpz_set_ui (Q[k], (2 * i + 2) * (2 * i + 3));
-      mpz_mul_2exp (T[k], Q[k], r);
-      mpz_sub (T[k], T[k], pp);
-      mpz_mul_ui (Q[k], Q[k], (2 * i) * (2 * i + 1));
-      /* the next term of the series is divided by Q[k] and multiplied
-         by pp^2/2^(2r), thus the mult. factor < 1/2^mult[k] */
-      MPFR_MPZ_SIZEINBASE2(mult[k], Q[k]);
-      mult[k] += 2 * r - size_ptoj[1] - 1;
-      /* the absolute contribution of the next term is 1/2^accu[k] */
-      accu[k] = (k == 0) ? mult[k] : mult[k] + accu[k-1];
-      prec_i_have = accu[k]; /* the current term is < 1/2^accu[k] */
-      j = (i + 2) / 2;
-      l = 1;
-      while ((j & 1) == 0) /* combine and reduce */
-        {
-          mpz_mul (T[k], T[k], ptoj[l]);
-          mpz_mul (T[k-1], T[k-1], Q[k]);
-          mpz_mul_2exp (T[k-1], T[k-1], r << l);
-          mpz_add (T[k-1], T[k-1], T[k]);
-          mpz_mul (Q[k-1], Q[k-1], Q[k]);
-          log2_nb_terms[k-1] ++; /* number of terms in S[k-1]
-                                    is a power of 2 by construction */
-          MPFR_MPZ_SIZEINBASE2(prec_i_have, Q[k]);
-          mult[k-1] += prec_i_have + (r << l) - size_ptoj[l] - 1;
-          accu[k-1] = (k == 1) ? mult[k-1] : mult[k-1] + accu[k-2];
-          prec_i_have = accu[k-1];
-          l ++;
-          j >>= 1;
-          k --;
-        }
+      i++;
+      /* add floor(log2(2i)) + floor(log2(2i+1)) */
+      if ((i & (i - 1)) == 0)
+        lg++;  /* lg = floor(log2(2i)) = floor(log2(2i+1)) */
+      b += d + 2 * (mpfr_prec_t) lg;
     }
 
-  /* accumulate all products in T[0] and Q[0]. Warning: contrary to above,
-     here we do not have log2_nb_terms[k-1] = log2_nb_terms[k]+1. */
-  h = 0; /* number of accumulated terms in the right part T[k]/Q[k] */
-  while (k > 0)
-    {
-      mpz_mul (T[k], T[k], ptoj[log2_nb_terms[k-1]]);
-      mpz_mul (T[k-1], T[k-1], Q[k]);
-      h += (mpfr_prec_t) 1 << log2_nb_terms[k];
-      mpz_mul_2exp (T[k-1], T[k-1], r * h);
-      mpz_add (T[k-1], T[k-1], T[k]);
-      mpz_mul (Q[k-1], Q[k-1], Q[k]);
-      k--;
-    }
+  data.pp = pp;
+  data.r = r;
+  mpfr_bsplit (bs, sin_bs_term, &data, MPFR_BSPLIT_POW, 1, i, 0);
+
+  /* T <- Q*2^e + T */
+  T = MPFR_BSPLIT_T (bs);
+  mpz_mul_2exp (S0, MPFR_BSPLIT_Q (bs), MPFR_BSPLIT_E (bs));
+  mpz_add (T, T, S0);
 
-  m = r0 + r * (i - 1); /* implicit multiplier 2^r for Q0 */
-  /* at this point T[0]/(2^m*Q[0]) is an approximation of sin(x) where the 1st
+  m = r0 + MPFR_BSPLIT_E (bs); /* implicit multiplier 2^r for Q0 */
+  /* at this point T/(2^m*Q) is an approximation of sin(x) where the 1st
      neglected term has contribution < 1/2^prec, thus since the series has
      alternate signs, the error is < 1/2^prec */
 
   /* we truncate Q0 to prec bits: the relative error is at most 2^(1-prec),
      which means that Q0 = Q[0] * (1+theta) with |theta| <= 2^(1-prec)
      [up to a power of two] */
-  m += reduce (Q0, Q[0], prec);
-  m -= reduce (T[0], T[0], prec);
+  m += reduce (Q0, MPFR_BSPLIT_Q (bs), prec);
+  m -= reduce (T, T, prec);
   /* multiply by x = p/2^m */
-  mpz_mul (S0, T[0], p);
+  mpz_mul (S0, T, p);
   m -= reduce (S0, S0, prec); /* S0 = T[0] * (1 + theta)^2 up to power of 2 */
   /* sin(X) ~ S0/Q0*(1 + theta)^3 + err with |theta| <= 2^(1-prec) and
               |err| <= 2^(-prec), thus since |S0/Q0| <= 1:
      |sin(X) - S0/Q0| <= 4*|theta*S0/Q0| + |err| <= 9*2^(-prec) */
 
   mpz_clear (pp);
-  for (k = 0; k < alloc; k ++)
-    {
-      mpz_clear (T[k]);
-      mpz_clear (Q[k]);
-      mpz_clear (ptoj[k]);
-    }
 
   /* compute cos(X) from sin(X): sqrt(1-(S/Q)^2) = sqrt(Q^2-S^2)/Q
      = sqrt(Q0^2*2^(2m)-S0^2)/Q0.
@@ -460,6 +405,7 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_prec_t prec_s, sh;
   mpz_t Q, S, C, Q2, S2, C2, y;
   mpfr_t x2;
+  mpfr_bsplit_t bs;
   unsigned long l, l2, j, err;
 
   MPFR_ASSERTD(MPFR_PREC(s) == MPFR_PREC(c));
@@ -474,6 +420,7 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpz_init (S2);
   mpz_init (C2);
   mpz_init (y);
+  mpfr_bsplit_init (bs);
 
   mpfr_set (x2, x, MPFR_RNDN); /* exact */
   mpz_set_ui (Q, 1);
@@ -507,7 +454,7 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
           if (mpz_cmp_ui (y, 0) == 0)
             continue;
           mpfr_sub_z (x2, x2, y, MPFR_RNDN); /* should be exact */
-          l2 = sin_bs_aux (Q2, S2, C2, y, 2 * sh - 1, prec_s);
+          l2 = sin_bs_aux (Q2, S2, C2, y, 2 * sh - 1, prec_s, bs);
           /* we now have |S2/Q2/2^l2 - sin(X)| <= 9*2^(prec_s)
              and |C2/Q2/2^l2 - cos(X)| <= 6*2^(prec_s), with X=y/2^(2sh-1) */
         }
@@ -559,6 +506,7 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpz_clear (S2);
   mpz_clear (C2);
   mpz_clear (y);
+  mpfr_bsplit_clear (bs);
   mpfr_clear (x2);
   return err;
 }
@@ -606,22 +554,15 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
         }
       else /* argument reduction is needed */
         {
-          long q;
-          mpfr_t pi;
+          int q;
           int neg = 0;
 
           mpfr_init2 (x_red, w);
-          mpfr_init2 (pi, (MPFR_EXP(x) > 0) ? w + MPFR_EXP(x) : w);
-          mpfr_const_pi (pi, MPFR_RNDN);
-          mpfr_div_2exp (pi, pi, 1, MPFR_RNDN); /* Pi/2 */
-          mpfr_remquo (x_red, &q, x, pi, MPFR_RNDN);
-          /* x = q * (Pi/2 + eps1) + x_red + eps2,
-             where |eps1| <= 1/2*ulp(Pi/2) = 2^(-w-MAX(0,EXP(x))),
-             and eps2 <= 1/2*ulp(x_red) <= 1/2*ulp(Pi/2) = 2^(-w)
-             Since |q| <= x/(Pi/2) <= |x|, we have
-             q*|eps1| <= 2^(-w), thus
-             |x - q * Pi/2 - x_red| <= 2^(1-w) */
-          /* now -Pi/4 <= x_red <= Pi/4: if x_red < 0, consider -x_red */
+          q = mpfr_reduce_pi (x_red, x, 2);
+          /* x = q * Pi/2 + x_red + eps (up to multiples of 2*Pi),
+             where |eps| <= 2^(-w) by the analysis in reduce_pi.c */
+          /* now -Pi/4 <= x_red <= Pi/4 (up to 2^(-w)): if x_red < 0,
+             consider -x_red */
           if (MPFR_IS_NEG(x_red))
             {
               mpfr_neg (x_red, x_red, MPFR_RNDN);
@@ -642,7 +583,6 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
               mpfr_swap (ts, tc);
             }
           mpfr_clear (x_red);
-          mpfr_clear (pi);
         }
       /* adjust errors with respect to absolute values */
       errs = err - MPFR_EXP(ts);
@@ -0,0 +1,226 @@
+/* mpfr_trace_enable, mpfr_trace_dump -- binary trace of the MPFR functions
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Unlike the logging (see logging.c), which formats each event with
+   mpfr_fprintf, the trace stores compact fixed-size records in a per-thread
+   ring buffer, which is written in binary by mpfr_trace_dump. The events
+   are the entry and the exit of the functions instrumented by
+   MPFR_LATENCY_FUNC, and the iterations of the Ziv loops.
+
+   A function is identified by a small integer, which is cached in the
+   per-thread record of the corresponding instrumentation point: id i
+   refers to trace_names[i-1], and id 0 is used when the table is full.
+
+   Format of a dump, where all the integers are unsigned and little endian:
+     "MPFRTRC1"                     magic string (8 bytes)
+     n                              number of function names (4 bytes)
+     n times: l (2 bytes), name     name of function id 1, 2, ..., n
+                                    (l bytes, no terminating null byte)
+     lost                           number of overwritten events (4 bytes,
+                                    saturated)
+     m                              number of records (4 bytes)
+     m times, oldest first:
+       time                         nanoseconds since mpfr_trace_enable
+                                    (8 bytes)
+       prec                         precision (4 bytes, saturated)
+       func                         function id (2 bytes)
+       kind                         MPFR_TRACE_ENTER, MPFR_TRACE_EXIT or
+                                    MPFR_TRACE_ZIV (1 byte)
+       iter                         Ziv iteration, starting from 1, or 0
+                                    (1 byte, saturated)
+   tools/trace/mpfrtrace decodes this format. */
+
+typedef struct {
+  double         time;
+  unsigned int   prec;
+  unsigned short func;
+  unsigned char  kind;
+  unsigned char  iter;
+} mpfr_trace_rec_t;
+
+#define TRACE_MAX_NAMES 65535
+
+static MPFR_THREAD_ATTR mpfr_trace_rec_t *trace_buf = NULL;
+static MPFR_THREAD_ATTR size_t trace_size = 0;  /* number of records */
+static MPFR_THREAD_ATTR size_t trace_pos = 0;   /* next record */
+static MPFR_THREAD_ATTR size_t trace_count = 0; /* valid records */
+static MPFR_THREAD_ATTR unsigned long trace_lost = 0;
+static MPFR_THREAD_ATTR double trace_origin;
+
+static MPFR_THREAD_ATTR const char **trace_names = NULL;
+static MPFR_THREAD_ATTR unsigned int trace_nnames = 0;
+static MPFR_THREAD_ATTR unsigned int trace_names_alloc = 0;
+
+/* Return the id of the function name, adding it to the table if need be. */
+static unsigned int
+trace_id (const char *name)
+{
+  unsigned int i;
+
+  for (i = 0; i < trace_nnames; i++)
+    if (strcmp (trace_names[i], name) == 0)
+      return i + 1;
+  if (trace_nnames == TRACE_MAX_NAMES)
+    return 0;
+  if (trace_nnames == trace_names_alloc)
+    {
+      unsigned int n = trace_names_alloc == 0 ? 64 : 2 * trace_names_alloc;
+
+      trace_names = (const char **) (trace_names_alloc == 0 ?
+        (*__gmp_allocate_func) (n * sizeof (const char *)) :
+        (*__gmp_reallocate_func) (trace_names,
+                                  trace_names_alloc * sizeof (const char *),
+                                  n * sizeof (const char *)));
+      trace_names_alloc = n;
+    }
+  trace_names[trace_nnames] = name;
+  return ++trace_nnames;
+}
+
+/* Record an event of the given kind for the function name, where *id is
+   the cached id of name (0 if not known yet). */
+void
+mpfr_trace_event (unsigned int *id, const char *name, int kind, int iter,
+                  mpfr_prec_t prec)
+{
+  mpfr_trace_rec_t *e;
+
+  MPFR_ASSERTD (trace_size != 0);
+  /* the table of names may have been freed by mpfr_free_cache */
+  if (*id == 0 || *id > trace_nnames || trace_names[*id - 1] != name)
+    *id = trace_id (name);
+  e = trace_buf + trace_pos;
+  e->time = mpfr_latency_now () - trace_origin;
+  e->prec = (mpfr_uprec_t) prec > UINT_MAX ? UINT_MAX : (unsigned int) prec;
+  e->func = *id;
+  e->kind = kind;
+  e->iter = iter > UCHAR_MAX ? UCHAR_MAX : iter;
+  if (++trace_pos == trace_size)
+    trace_pos = 0;
+  if (trace_count < trace_size)
+    trace_count ++;
+  else if (trace_lost < ULONG_MAX)
+    trace_lost ++;
+}
+
+int
+mpfr_trace_enable (size_t n)
+{
+  int old = (__gmpfr_instr & MPFR_INSTR_TRACE) != 0;
+
+  if (n == 0)
+    {
+      __gmpfr_instr &= ~MPFR_INSTR_TRACE;
+      return old;
+    }
+  if (n != trace_size)
+    {
+      if (trace_size != 0)
+        (*__gmp_free_func) (trace_buf, trace_size * sizeof (mpfr_trace_rec_t));
+      trace_buf = (mpfr_trace_rec_t *)
+        (*__gmp_allocate_func) (n * sizeof (mpfr_trace_rec_t));
+      trace_size = n;
+    }
+  trace_pos = 0;
+  trace_count = 0;
+  trace_lost = 0;
+  trace_origin = mpfr_latency_now ();
+  __gmpfr_instr |= MPFR_INSTR_TRACE;
+  return old;
+}
+
+/* Put in buf the n low bytes of x, least significant first. */
+static void
+trace_put (unsigned char *buf, unsigned long x, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++, x >>= 8)
+    buf[i] = x & 0xff;
+}
+
+/* Write the trace of the current thread to f. Return 0 if successful,
+   non-zero otherwise. */
+int
+mpfr_trace_dump (FILE *f)
+{
+  unsigned char buf[16];
+  unsigned int i;
+  size_t j, k;
+
+  if (fwrite ("MPFRTRC1", 8, 1, f) != 1)
+    return 1;
+  trace_put (buf, trace_nnames, 4);
+  if (fwrite (buf, 4, 1, f) != 1)
+    return 1;
+  for (i = 0; i < trace_nnames; i++)
+    {
+      size_t l = strlen (trace_names[i]);
+
+      if (l > 0xffff)
+        l = 0xffff;
+      trace_put (buf, l, 2);
+      if (fwrite (buf, 2, 1, f) != 1 || fwrite (trace_names[i], l, 1, f) != 1)
+        return 1;
+    }
+  trace_put (buf, trace_lost > 0xffffffffUL ? 0xffffffffUL : trace_lost, 4);
+  trace_put (buf + 4, trace_count, 4);
+  if (fwrite (buf, 8, 1, f) != 1)
+    return 1;
+  k = trace_count < trace_size ? 0 : trace_pos;
+  for (j = 0; j < trace_count; j++)
+    {
+      mpfr_trace_rec_t *e = trace_buf + k;
+      /* split the time into two 32-bit halves, exact below 2^53 ns */
+      double hi = (double) (unsigned long) (e->time / 4294967296.0);
+
+      trace_put (buf, (unsigned long) (e->time - hi * 4294967296.0), 4);
+      trace_put (buf + 4, (unsigned long) hi, 4);
+      trace_put (buf + 8, e->prec, 4);
+      trace_put (buf + 12, e->func, 2);
+      buf[14] = e->kind;
+      buf[15] = e->iter;
+      if (fwrite (buf, 16, 1, f) != 1)
+        return 1;
+      if (++k == trace_size)
+        k = 0;
+    }
+  return 0;
+}
+
+void
+mpfr_trace_freecache (void)
+{
+  __gmpfr_instr &= ~MPFR_INSTR_TRACE;
+  if (trace_size != 0)
+    (*__gmp_free_func) (trace_buf, trace_size * sizeof (mpfr_trace_rec_t));
+  trace_buf = NULL;
+  trace_size = trace_pos = trace_count = 0;
+  trace_lost = 0;
+  if (trace_names_alloc != 0)
+    (*__gmp_free_func) (trace_names,
+                        trace_names_alloc * sizeof (const char *));
+  trace_names = NULL;
+  trace_nnames = trace_names_alloc = 0;
+}
@@ -0,0 +1,799 @@
+/* mpfr_exp_q, mpfr_log_q, mpfr_atan_q, mpfr_sin_q, mpfr_cos_q -- elementary
+   functions of a rational number
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+#ifndef MPFR_USE_MINI_GMP
+
+/* The argument x = a/b is reduced exactly to a rational y with |y| < 1/2,
+   and the Taylor series at y is evaluated by binary splitting (see also
+   log_ui.c), thus x is never rounded. All the series are written
+
+     S = sum(t[k], k = 0..N-1) with t[0] = 1 and t[k] = t[k-1] p(k)/q(k),
+
+   where (y = c/d with c and d integers)
+
+     MPFR_Q_EXP:   exp(y)   = S   with p(k) = c,           q(k) = d k
+     MPFR_Q_SIN:   sin(y)   = y S with p(k) = -c^2,        q(k) = d^2 2k(2k+1)
+     MPFR_Q_ATAN:  atan(y)  = y S with p(k) = -c^2 (2k-1), q(k) = d^2 (2k+1)
+     MPFR_Q_ATANH: atanh(y) = y S with p(k) = c^2 (2k-1),  q(k) = d^2 (2k+1)
+
+   The sums are computed by mpfr_bsplit. For exp and sin, p(k) does not
+   depend on k, thus MPFR_BSPLIT_POW applies.
+
+   The cost is quasi-linear in the working precision when a and b are small,
+   but the mpfr_t functions are faster in small precision or when a and b
+   are large: in that case we compute f(o(x)) instead, where o(x) is x
+   rounded to the working precision (see mpfr_q_fallback). */
+
+#define MPFR_Q_EXP   0
+#define MPFR_Q_SIN   1
+#define MPFR_Q_ATAN  2
+#define MPFR_Q_ATANH 3
+/* only for mpfr_q_fallback */
+#define MPFR_Q_LOG   4
+#define MPFR_Q_COS   5
+
+typedef struct {
+  mpz_srcptr A; /* c or c^2 */
+  mpz_srcptr B; /* d or d^2 */
+  int kind;
+} mpfr_q_data;
+
+/* Term of index n >= 1 of the series of the given kind, see mpfr_bsplit */
+static void
+mpfr_q_term (mpz_ptr P, mpz_ptr Q, mpz_ptr B, mpz_ptr T, mp_bitcnt_t *f,
+             unsigned long n, void *data)
+{
+  mpfr_q_data *d = (mpfr_q_data *) data;
+
+  (void) B; (void) T; (void) f; /* no a(n), b(n), nor power of two */
+  switch (d->kind)
+    {
+    case MPFR_Q_EXP:
+      mpz_set (P, d->A);
+      mpz_mul_ui (Q, d->B, n);
+      break;
+    case MPFR_Q_SIN:
+      mpz_neg (P, d->A);
+      mpz_mul_ui (Q, d->B, 2 * n);
+      mpz_mul_ui (Q, Q, 2 * n + 1);
+      break;
+    default:
+      MPFR_ASSERTD (d->kind == MPFR_Q_ATAN || d->kind == MPFR_Q_ATANH);
+      mpz_mul_ui (P, d->A, 2 * n - 1);
+      if (d->kind == MPFR_Q_ATAN)
+        mpz_neg (P, P);
+      mpz_mul_ui (Q, d->B, 2 * n + 1);
+    }
+}
+
+/* Return the number N of terms such that the neglected terms of the series
+   of the given kind are bounded by 2^(-w-2), for |y| < 2^e with e <= -1.
+   For exp, the neglected terms are bounded by 2 |y|^N/N!, and since
+   N! >= (N/e)^N, by 2^(1 + N (e + 2 - floor(log2(N)))); for sin, the same
+   holds with N replaced by 2N; for atan and atanh, they are bounded by
+   2 |y|^(2N) < 2^(1 + 2eN). */
+static unsigned long
+mpfr_q_terms (mpfr_prec_t w, mpfr_exp_t e, int kind)
+{
+  unsigned long lo, hi, mid;
+  long c;
+
+  MPFR_ASSERTD (e <= -1);
+  if (kind == MPFR_Q_ATAN || kind == MPFR_Q_ATANH)
+    return (unsigned long) (w + 3) / (unsigned long) (-2 * e) + 2;
+
+  /* the condition N (c + floor(log2(N))) >= w + 3 with c = -e-2 >= -1 is
+     true for N = hi, false for N = lo */
+  c = -e - 2;
+#define MPFR_Q_TERMS_OK(N)                                               \
+  ((long) (N) * (c + (long) MPFR_INT_CEIL_LOG2 ((N) + 1) - 1) >= (long) w + 3)
+  for (lo = 1, hi = 2; ! MPFR_Q_TERMS_OK (hi); hi *= 2)
+    lo = hi;
+  while (hi - lo > 1)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (MPFR_Q_TERMS_OK (mid))
+        hi = mid;
+      else
+        lo = mid;
+    }
+#undef MPFR_Q_TERMS_OK
+  return (kind == MPFR_Q_SIN) ? hi / 2 + 1 : hi;
+}
+
+/* Set s to the sum S of the first N terms of the series of the given kind
+   (see above). Since T/Q >= -1/2 in all cases, the rounding errors are
+   bounded by 4 ulps of s, thus if N = mpfr_q_terms (PREC(s), e, kind), the
+   relative error on s is less than 5 * 2^(-PREC(s)) (S >= 1/2). */
+static void
+mpfr_q_series (mpfr_ptr s, mpz_srcptr A, mpz_srcptr B, int kind,
+               unsigned long N)
+{
+  mpfr_bsplit_t bs;
+  mpfr_q_data d;
+  mpfr_t q;
+
+  if (N < 2)
+    {
+      mpfr_set_ui (s, 1, MPFR_RNDN);
+      return;
+    }
+
+  d.A = A;
+  d.B = B;
+  d.kind = kind;
+  mpfr_bsplit_init (bs);
+  mpfr_bsplit (bs, mpfr_q_term, &d, (kind == MPFR_Q_EXP || kind == MPFR_Q_SIN)
+               ? MPFR_BSPLIT_POW : 0, 1, N, 0);
+
+  mpfr_init2 (q, MPFR_PREC (s));
+  mpfr_set_z (s, MPFR_BSPLIT_T (bs), MPFR_RNDN);
+  mpfr_set_z_2exp (q, MPFR_BSPLIT_Q (bs), (mpfr_exp_t) MPFR_BSPLIT_E (bs),
+                   MPFR_RNDN);
+  mpfr_div (s, s, q, MPFR_RNDN);
+  mpfr_add_ui (s, s, 1, MPFR_RNDN);
+  mpfr_clear (q);
+  mpfr_bsplit_clear (bs);
+}
+
+/* Return e such that |c/d| < 2^e, assuming c and d non-zero */
+static mpfr_exp_t
+mpfr_q_exp_bound (mpz_srcptr c, mpz_srcptr d)
+{
+  return (mpfr_exp_t) mpz_sizeinbase (c, 2)
+    - (mpfr_exp_t) mpz_sizeinbase (d, 2) + 1;
+}
+
+/* Return non-zero if the binary splitting is worth for x in precision p:
+   the size of the integers involved grows like (log2|a| + log2(b)) times
+   the number of terms. */
+static int
+mpfr_q_bs_p (mpq_srcptr x, mpfr_prec_t p)
+{
+  return p >= MPFR_TRANS_Q_THRESHOLD &&
+    mpz_sizeinbase (mpq_numref (x), 2) + mpz_sizeinbase (mpq_denref (x), 2)
+    <= (size_t) p / MPFR_TRANS_Q_RATIO;
+}
+
+/* Return non-zero if the series of atan or atanh at y = c/g, with
+   |y| < 2^e, is worth compared to the mpfr_t function: it converges in
+   about p/(-2e) terms, each one multiplying the integers by about
+   size(c) - e bits, thus it needs e <= emax and size(c) small compared
+   to -e. */
+static int
+mpfr_q_series_p (mpz_srcptr c, mpfr_exp_t e, mpfr_exp_t emax)
+{
+  return e <= emax && (mpfr_exp_t) mpz_sizeinbase (c, 2) + 4 <= -4 * e;
+}
+
+/* Set y to c/d, with relative error at most 2 ulps */
+static void
+mpfr_q_set_zz (mpfr_ptr y, mpz_srcptr c, mpz_srcptr d)
+{
+  mpfr_set_z (y, c, MPFR_RNDN);
+  mpfr_div_z (y, y, d, MPFR_RNDN);
+}
+
+/* Compute f(x) for x non-zero (and positive for log) as f(t) with
+   t = o(x) rounded to nearest in the working precision w: with u = 2^(-w)
+   and |x| < 2^ex, we have |t - x| <= 2^ex u, and the error on o(f(t)) is
+   bounded by
+   - for exp: |exp(t-x) - 1| + u <= 2^(max(ex,0)+1) u relatively;
+   - for atan: |t - x|/(1 + x^2) + u <= 2^2 u relatively, since
+     |x|/(1 + x^2) <= |atan(x)|;
+   - for log: |log(t/x)| + 1/2 ulp <= 2u + 1/2 ulp absolutely;
+   - for sin and cos: |t - x| + 1/2 ulp <= 2^ex u + 1/2 ulp absolutely.
+   In the absolute cases, the error is bounded by 2^(max(a,EXP(v))+1-w) with
+   a = 1 for log and a = ex for sin and cos. */
+static int
+mpfr_q_fallback (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode, int kind)
+{
+  mpfr_t t, v;
+  mpfr_prec_t w;
+  mpfr_exp_t ex, a, err;
+  int inexact, rel;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  ex = mpfr_q_exp_bound (mpq_numref (x), mpq_denref (x));
+  rel = kind == MPFR_Q_EXP || kind == MPFR_Q_ATAN;
+  a = kind == MPFR_Q_EXP ? MAX (ex, 0) + 1
+    : kind == MPFR_Q_ATAN ? 2
+    : kind == MPFR_Q_LOG ? 1 : ex;
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + 10;
+  if (kind != MPFR_Q_ATAN && kind != MPFR_Q_LOG)
+    w += MAX (ex, 0);
+  mpfr_init2 (t, w);
+  mpfr_init2 (v, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      mpfr_set_q (t, x, MPFR_RNDN);
+      mpfr_clear_flags ();
+      switch (kind)
+        {
+        case MPFR_Q_EXP:
+          mpfr_exp (v, t, MPFR_RNDN);
+          break;
+        case MPFR_Q_LOG:
+          mpfr_log (v, t, MPFR_RNDN);
+          break;
+        case MPFR_Q_ATAN:
+          mpfr_atan (v, t, MPFR_RNDN);
+          break;
+        case MPFR_Q_SIN:
+          mpfr_sin (v, t, MPFR_RNDN);
+          break;
+        default:
+          MPFR_ASSERTD (kind == MPFR_Q_COS);
+          mpfr_cos (v, t, MPFR_RNDN);
+        }
+      if (MPFR_UNLIKELY (kind == MPFR_Q_EXP &&
+                         (MPFR_IS_INF (v) || mpfr_underflow_p ())))
+        {
+          /* overflow or underflow in the extended exponent range */
+          int pos = MPFR_IS_INF (v);
+
+          mpfr_clear (t);
+          mpfr_clear (v);
+          MPFR_ZIV_FREE (loop);
+          MPFR_SAVE_EXPO_FREE (expo);
+          return pos ? mpfr_overflow (y, rnd_mode, 1)
+            : mpfr_underflow (y, rnd_mode == MPFR_RNDN ? MPFR_RNDZ
+                              : rnd_mode, 1);
+        }
+      if (MPFR_LIKELY (! MPFR_IS_ZERO (v)))
+        {
+          err = rel ? w - a : w - 1 - MAX (a - MPFR_GET_EXP (v), 0);
+          if (MPFR_LIKELY (MPFR_CAN_ROUND (v, err, MPFR_PREC (y),
+                                           rnd_mode)))
+            break;
+          /* take into account the cancellation */
+          if (err < MPFR_PREC (y))
+            w += MPFR_PREC (y) - err;
+        }
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (v, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (y, v, rnd_mode);
+
+  mpfr_clear (t);
+  mpfr_clear (v);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+int
+mpfr_exp_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpz_t d;
+  mpfr_t s;
+  mpfr_prec_t w;
+  mpfr_exp_t e;
+  unsigned long K, r, i, N;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
+
+  MPFR_LOG_FUNC
+    (("x=%Qd rnd=%d", x, rnd_mode),
+     ("y[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (y), mpfr_log_prec, y,
+      inexact));
+
+  if (mpq_sgn (x) == 0)
+    return mpfr_set_ui (y, 1, rnd_mode);
+
+  /* If |x| >= 2^64, exp(x) overflows or underflows in any exponent range
+     (|x| > 2^62 > MPFR_EMAX_MAX log(2)). */
+  e = mpfr_q_exp_bound (mpq_numref (x), mpq_denref (x));
+  if (e - 2 >= 64)
+    return mpq_sgn (x) > 0 ? mpfr_overflow (y, rnd_mode, 1)
+      : mpfr_underflow (y, rnd_mode == MPFR_RNDN ? MPFR_RNDZ : rnd_mode, 1);
+
+  if (! mpfr_q_bs_p (x, MPFR_PREC (y)))
+    return mpfr_q_fallback (y, x, rnd_mode, MPFR_Q_EXP);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* exp(x) = exp(x/2^r)^(2^r) with |x/2^r| < 2^(-K). Since the binary
+     splitting is quasi-linear, only a few squarings are worth. */
+  K = MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) / 2 + 1;
+  e += (mpfr_exp_t) K;
+  r = e > 0 ? e : 0;
+  e -= (mpfr_exp_t) (r + K); /* |x/2^r| < 2^e */
+  mpz_init (d);
+  mpz_mul_2exp (d, mpq_denref (x), r);
+
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + r + 10;
+  mpfr_init2 (s, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      N = mpfr_q_terms (w, e, MPFR_Q_EXP);
+      mpfr_q_series (s, mpq_numref (x), d, MPFR_Q_EXP, N); /* error < 5u */
+      /* each squaring at most doubles the relative error plus 1u, thus
+         after r squarings it is less than 2^r (5u + u) < 2^(r+3) u */
+      mpfr_clear_flags ();
+      for (i = 0; i < r; i++)
+        mpfr_sqr (s, s, MPFR_RNDN);
+      if (MPFR_UNLIKELY (MPFR_IS_INF (s) || mpfr_underflow_p ()))
+        {
+          /* overflow or underflow in the extended exponent range */
+          int pos = MPFR_IS_INF (s);
+
+          mpfr_clear (s);
+          mpz_clear (d);
+          MPFR_ZIV_FREE (loop);
+          MPFR_SAVE_EXPO_FREE (expo);
+          return pos ? mpfr_overflow (y, rnd_mode, 1)
+            : mpfr_underflow (y, rnd_mode == MPFR_RNDN ? MPFR_RNDZ
+                              : rnd_mode, 1);
+        }
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, w - r - 3, MPFR_PREC (y),
+                                       rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (s, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (y, s, rnd_mode);
+
+  mpfr_clear (s);
+  mpz_clear (d);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+int
+mpfr_log_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpz_t c, d, g;
+  mpfr_t s, t;
+  mpfr_prec_t w;
+  mpfr_exp_t e, ez = 0; /* ez is only used when z <> 0, avoid a warning */
+  unsigned long N;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
+
+  MPFR_LOG_FUNC
+    (("x=%Qd rnd=%d", x, rnd_mode),
+     ("y[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (y), mpfr_log_prec, y,
+      inexact));
+
+  if (mpq_sgn (x) <= 0)
+    {
+      if (mpq_sgn (x) < 0)
+        {
+          MPFR_SET_NAN (y);
+          MPFR_RET_NAN;
+        }
+      MPFR_SET_INF (y);
+      MPFR_SET_NEG (y);
+      MPFR_SET_DIVBY0 ();
+      MPFR_RET (0); /* log(0) is an exact -infinity */
+    }
+  if (mpz_cmp (mpq_numref (x), mpq_denref (x)) == 0)
+    {
+      MPFR_SET_ZERO (y);
+      MPFR_SET_POS (y);
+      MPFR_RET (0); /* log(1) = +0 */
+    }
+
+  /* Argument reduction: x = 2^e m with 2/3 <= m < 4/3, and
+     log(m) = 2 atanh(z) with z = (m-1)/(m+1), thus -1/5 <= z < 1/7.
+     With m = c/d, z = (c-d)/(c+d). */
+  mpz_init (c);
+  mpz_init (d);
+  mpz_init (g);
+  e = (mpfr_exp_t) mpz_sizeinbase (mpq_numref (x), 2)
+    - (mpfr_exp_t) mpz_sizeinbase (mpq_denref (x), 2);
+  /* now 1/2 < x/2^e < 2 */
+  for (;;)
+    {
+      if (e >= 0)
+        {
+          mpz_set (c, mpq_numref (x));
+          mpz_mul_2exp (d, mpq_denref (x), e);
+        }
+      else
+        {
+          mpz_mul_2exp (c, mpq_numref (x), -e);
+          mpz_set (d, mpq_denref (x));
+        }
+      mpz_mul_ui (g, c, 3);
+      mpz_mul_2exp (d, d, 2);
+      if (mpz_cmp (g, d) >= 0) /* 3c >= 4d */
+        {
+          e ++;
+          continue;
+        }
+      mpz_tdiv_q_2exp (d, d, 1);
+      if (mpz_cmp (g, d) < 0) /* 3c < 2d */
+        {
+          e --;
+          continue;
+        }
+      mpz_tdiv_q_2exp (d, d, 1);
+      break;
+    }
+  mpz_add (g, c, d);
+  mpz_sub (c, c, d); /* c/g = z */
+  mpz_gcd (d, c, g);
+  mpz_divexact (c, c, d);
+  mpz_divexact (g, g, d);
+  /* now z = c/g, and d is free */
+
+  /* mpfr_log is faster unless x is close to a power of 2 */
+  if (mpz_sgn (c) != 0)
+    {
+      ez = mpfr_q_exp_bound (c, g);
+      ez = MIN (ez, -2); /* |z| <= 1/5 */
+      if (! mpfr_q_series_p (c, ez, -5))
+        {
+          mpz_clear (c);
+          mpz_clear (d);
+          mpz_clear (g);
+          return mpfr_q_fallback (y, x, rnd_mode, MPFR_Q_LOG);
+        }
+    }
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + 10;
+  mpfr_init2 (s, w);
+  mpfr_init2 (t, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      if (mpz_sgn (c) != 0)
+        {
+          mpz_t A, B;
+
+          N = mpfr_q_terms (w, ez, MPFR_Q_ATANH);
+          mpz_init (A);
+          mpz_init (B);
+          mpz_mul (A, c, c);
+          mpz_mul (B, g, g);
+          mpfr_q_series (s, A, B, MPFR_Q_ATANH, N); /* rel. error < 5u */
+          mpz_clear (A);
+          mpz_clear (B);
+          mpfr_q_set_zz (t, c, g);
+          mpfr_mul (s, s, t, MPFR_RNDN);
+          mpfr_mul_2ui (s, s, 1, MPFR_RNDN); /* log(m), rel. error < 9u */
+        }
+      else
+        MPFR_SET_ZERO (s);
+      if (e != 0)
+        {
+          mpfr_const_log2 (t, MPFR_RNDN);
+          mpfr_mul_si (t, t, e, MPFR_RNDN); /* rel. error < 3u */
+          mpfr_add (s, s, t, MPFR_RNDN);
+        }
+      /* If e = 0, the relative error is at most 9u. Otherwise
+         |log(m)| <= 0.406 and |e log(2)| >= 0.693, thus
+         |log(x)| >= 0.287 and |log(x)| >= 0.41 |e log(2)|, and the
+         relative error is at most 9u*0.406/0.287 + 3u/0.41 + u < 2^5 u. */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, w - 5, MPFR_PREC (y), rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (s, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (y, s, rnd_mode);
+
+  mpfr_clear (s);
+  mpfr_clear (t);
+  mpz_clear (c);
+  mpz_clear (d);
+  mpz_clear (g);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+int
+mpfr_atan_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpz_t c, d, g, h;
+  mpfr_t s, t;
+  mpfr_prec_t w;
+  mpfr_exp_t ez = 0; /* ez is only used when y <> 0, avoid a warning */
+  unsigned long N, pi4;
+  int inexact, neg, inv, refl;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
+
+  MPFR_LOG_FUNC
+    (("x=%Qd rnd=%d", x, rnd_mode),
+     ("y[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (y), mpfr_log_prec, y,
+      inexact));
+
+  if (mpq_sgn (x) == 0)
+    return mpfr_set_ui (y, 0, rnd_mode); /* atan(0) = +0 */
+
+  /* Argument reduction, with |x| = c/d:
+     - if c > d, atan(|x|) = Pi/2 - atan(d/c);
+     - then if c/d > 5/12, atan(c/d) = Pi/4 - atan(y) with
+       y = (d-c)/(d+c) < 7/17 (i.e., for c/d = 1, atan(c/d) = Pi/4);
+     so that atan(x) = sign(x) (pi4 Pi/4 +/- atan(y)) with 0 <= y < 1/2. */
+  neg = mpq_sgn (x) < 0;
+  mpz_init (c);
+  mpz_init (d);
+  mpz_init (g);
+  mpz_init (h);
+  mpz_abs (c, mpq_numref (x));
+  mpz_set (d, mpq_denref (x));
+  inv = mpz_cmp (c, d) > 0;
+  if (inv)
+    mpz_swap (c, d);
+  mpz_mul_ui (g, c, 12);
+  mpz_mul_ui (h, d, 5);
+  refl = mpz_cmp (g, h) > 0; /* 12c > 5d */
+  if (refl)
+    {
+      mpz_add (g, d, c);
+      mpz_sub (c, d, c);
+      mpz_gcd (d, c, g);
+      mpz_divexact (c, c, d);
+      mpz_divexact (g, g, d);
+    }
+  else
+    mpz_set (g, d);
+  /* now y = c/g, and the result is pi4 Pi/4 + atan(y) or pi4 Pi/4 - atan(y):
+     not inv, not refl: atan(y)
+     not inv, refl:     Pi/4 - atan(y)
+     inv, not refl:     Pi/2 - atan(y)
+     inv, refl:         Pi/4 + atan(y) */
+  pi4 = inv ? (refl ? 1 : 2) : (refl ? 1 : 0);
+
+  if (mpz_sgn (c) != 0)
+    {
+      ez = mpfr_q_exp_bound (c, g);
+      ez = MIN (ez, -1); /* y < 1/2 */
+      if (! mpfr_q_series_p (c, ez, -2))
+        {
+          mpz_clear (c);
+          mpz_clear (d);
+          mpz_clear (g);
+          mpz_clear (h);
+          return mpfr_q_fallback (y, x, rnd_mode, MPFR_Q_ATAN);
+        }
+    }
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + 10;
+  mpfr_init2 (s, w);
+  mpfr_init2 (t, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      if (mpz_sgn (c) != 0)
+        {
+          mpz_t A, B;
+
+          N = mpfr_q_terms (w, ez, MPFR_Q_ATAN);
+          mpz_init (A);
+          mpz_init (B);
+          mpz_mul (A, c, c);
+          mpz_mul (B, g, g);
+          mpfr_q_series (s, A, B, MPFR_Q_ATAN, N); /* rel. error < 5u */
+          mpz_clear (A);
+          mpz_clear (B);
+          mpfr_q_set_zz (t, c, g);
+          mpfr_mul (s, s, t, MPFR_RNDN); /* atan(y), rel. error < 9u */
+          if (inv != refl)
+            mpfr_neg (s, s, MPFR_RNDN);
+        }
+      else
+        MPFR_SET_ZERO (s);
+      if (pi4 != 0)
+        {
+          mpfr_const_pi (t, MPFR_RNDN);
+          mpfr_mul_2si (t, t, (pi4 == 1) ? -2 : -1, MPFR_RNDN);
+          mpfr_add (s, s, t, MPFR_RNDN);
+        }
+      /* When atan(y) is subtracted, the result is at least
+         atan(5/12) > 0.394, and |atan(y)| < atan(7/17) < 0.393, thus
+         the relative error is at most 9u*0.393/0.394 + u*1.571/0.394 + u
+         < 2^4 u. */
+      if (neg)
+        mpfr_neg (s, s, MPFR_RNDN);
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, w - 4, MPFR_PREC (y), rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (s, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (y, s, rnd_mode);
+
+  mpfr_clear (s);
+  mpfr_clear (t);
+  mpz_clear (c);
+  mpz_clear (d);
+  mpz_clear (g);
+  mpz_clear (h);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+/* Common code for mpfr_sin_q (is_cos = 0) and mpfr_cos_q (is_cos = 1).
+   With y = x/2^r and |y| < 1/2, sin(y) is computed with the series, and
+   cos(y) = sqrt(1 - sin(y)^2); then sin(2y) = 2 sin(y) cos(y) and
+   cos(2y) = (cos(y) - sin(y)) (cos(y) + sin(y)) are applied r times.
+   If E is a bound on the absolute errors on sin and cos, with
+   2u <= E <= 2^(-7), then the absolute errors after one step are bounded
+   by 4E + 2E^2 + 6u <= 8E, thus after r steps by 2^(3r+3) u since the
+   initial errors are bounded by 8u. */
+static int
+mpfr_sin_cos_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode, int is_cos)
+{
+  mpz_t A, B;
+  mpfr_t s, c, t, u;
+  mpfr_ptr v;
+  mpfr_prec_t w;
+  mpfr_exp_t e, err;
+  unsigned long r, i, N;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  if (mpq_sgn (x) == 0)
+    return mpfr_set_ui (y, is_cos ? 1 : 0, rnd_mode);
+
+  if (! mpfr_q_bs_p (x, MPFR_PREC (y)))
+    return mpfr_q_fallback (y, x, rnd_mode, is_cos ? MPFR_Q_COS : MPFR_Q_SIN);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* each doubling step costs 3 bits and two multiplications, thus it is
+     only used to get |y| < 1/2 */
+  e = mpfr_q_exp_bound (mpq_numref (x), mpq_denref (x)) + 1;
+  r = e > 0 ? e : 0;
+  e -= (mpfr_exp_t) r + 1; /* |x/2^r| < 2^e */
+  mpz_init (A);
+  mpz_init (B);
+  mpz_mul (A, mpq_numref (x), mpq_numref (x));
+  mpz_mul_2exp (B, mpq_denref (x), r);
+  mpz_mul (B, B, B);
+
+  w = MPFR_PREC (y) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (y)) + 3 * r + 10;
+  mpfr_init2 (s, w);
+  mpfr_init2 (c, w);
+  mpfr_init2 (t, w);
+  mpfr_init2 (u, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      N = mpfr_q_terms (w, e, MPFR_Q_SIN);
+      mpfr_q_series (s, A, B, MPFR_Q_SIN, N); /* rel. error < 5u */
+      mpfr_set_q (t, x, MPFR_RNDN);
+      mpfr_div_2ui (t, t, r, MPFR_RNDN);
+      mpfr_mul (s, s, t, MPFR_RNDN); /* sin(y), rel. error < 7u */
+      if (is_cos || r > 0)
+        {
+          /* the error on s^2 is at most 2 |s| 7u + u <= 8u, thus the error
+             on 1 - s^2 is at most 9u, and since 1 - s^2 >= 3/4 the error on
+             c = sqrt(1 - s^2) is at most 9u/sqrt(3) + u < 7u */
+          mpfr_sqr (c, s, MPFR_RNDN);
+          mpfr_ui_sub (c, 1, c, MPFR_RNDN);
+          mpfr_sqrt (c, c, MPFR_RNDN);
+        }
+      for (i = 0; i < r; i++)
+        {
+          mpfr_mul (t, s, c, MPFR_RNDN);
+          mpfr_sub (u, c, s, MPFR_RNDN);
+          mpfr_add (c, c, s, MPFR_RNDN);
+          mpfr_mul (c, c, u, MPFR_RNDN);
+          mpfr_mul_2ui (s, t, 1, MPFR_RNDN);
+        }
+      v = is_cos ? c : s;
+      if (r == 0)
+        {
+          /* relative error at most 7u */
+          if (MPFR_LIKELY (MPFR_CAN_ROUND (v, w - 3, MPFR_PREC (y),
+                                           rnd_mode)))
+            break;
+        }
+      else if (! MPFR_IS_ZERO (v))
+        {
+          /* absolute error at most 2^(3r+3) u */
+          err = MPFR_GET_EXP (v) + w - 3 * (mpfr_exp_t) r - 3;
+          if (err > 0 && MPFR_CAN_ROUND (v, err, MPFR_PREC (y), rnd_mode))
+            break;
+          /* take into account the cancellation for x near k Pi/2 */
+          if (err < MPFR_PREC (y))
+            w += MPFR_PREC (y) - err;
+        }
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (s, w);
+      mpfr_set_prec (c, w);
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (u, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (y, v, rnd_mode);
+
+  mpfr_clear (s);
+  mpfr_clear (c);
+  mpfr_clear (t);
+  mpfr_clear (u);
+  mpz_clear (A);
+  mpz_clear (B);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+int
+mpfr_sin_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
+
+  MPFR_LOG_FUNC
+    (("x=%Qd rnd=%d", x, rnd_mode),
+     ("y[%Pu]=%.*Rg", mpfr_get_prec (y), mpfr_log_prec, y));
+
+  return mpfr_sin_cos_q (y, x, rnd_mode, 0);
+}
+
+int
+mpfr_cos_q (mpfr_ptr y, mpq_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  MPFR_LATENCY_FUNC (MPFR_PREC (y));
+
+  MPFR_LOG_FUNC
+    (("x=%Qd rnd=%d", x, rnd_mode),
+     ("y[%Pu]=%.*Rg", mpfr_get_prec (y), mpfr_log_prec, y));
+
+  return mpfr_sin_cos_q (y, x, rnd_mode, 1);
+}
+
+#endif
@@ -146,11 +146,15 @@ mpfr_yn_s3 (mpfr_ptr s, mpfr_srcptr y, mpfr_srcptr c, unsigned long n)
   return 3 + 2 * MPFR_INT_CEIL_LOG2(k + 2) + exps;
 }
 
+/* crossover of the asymptotic expansion, see mpfr_yn */
+static MPFR_TUNE_TAB_CONST short yn_asympt_tab[] = { MPFR_YN_ASYMPT_TAB };
+
 int
 mpfr_yn (mpfr_ptr res, long n, mpfr_srcptr z, mpfr_rnd_t r)
 {
   int inex;
   unsigned long absn;
+  mpfr_prec_t c, pbound;
   MPFR_SAVE_EXPO_DECL (expo);
 
   MPFR_LOG_FUNC
@@ -309,8 +313,14 @@ mpfr_yn (mpfr_ptr res, long n, mpfr_srcptr z, mpfr_rnd_t r)
     }
 
   /* we can use the asymptotic expansion as soon as z > p log(2)/2,
-     but to get some margin we use it for z > p/2 */
-  if (mpfr_cmp_ui (z, MPFR_PREC(res) / 2 + 3) > 0)
+     but to get some margin we use it for z > c*p + 3, where c is given
+     by MPFR_YN_ASYMPT_TAB (1/2 by default) */
+  MPFR_STAT_STATIC_ASSERT (numberof (yn_asympt_tab) == MPFR_PREC_TAB_SIZE);
+  c = yn_asympt_tab[MPFR_PREC_TAB_INDEX (MPFR_PREC (res))];
+  pbound = MPFR_PREC (res) / 1024 * c + MPFR_PREC (res) % 1024 * c / 1024
+    + 3;
+  MPFR_ASSERTN ((mpfr_uprec_t) pbound <= ULONG_MAX);
+  if (mpfr_cmp_ui (z, pbound) > 0)
     {
       inex = mpfr_yn_asympt (res, n, z, r);
       if (inex != 0)
@@ -77,21 +77,23 @@ mpfr_zeta_part_b (mpfr_t b, mpfr_srcptr s, int n, int p, mpfr_t *tc)
   MPFR_GROUP_CLEAR (group);
 }
 
-/* Input: p - an integer
-   Output: fills tc[1..p], tc[i] = bernoulli(2i)/(2i)!
+/* Input: p, k0 - integers with 1 <= k0
+   Output: fills tc[k0..p], tc[i] = bernoulli(2i)/(2i)!, assuming tc[1..k0-1]
+   are already computed (with the same precision)
    tc[1]=1/12, tc[2]=-1/720, tc[3]=1/30240, ...
 */
 static void
-mpfr_zeta_c (int p, mpfr_t *tc)
+mpfr_zeta_c (int k0, int p, mpfr_t *tc)
 {
   mpfr_t d;
   int k, l;
 
-  if (p > 0)
+  if (p >= k0)
     {
-      mpfr_init2 (d, MPFR_PREC (tc[1]));
-      mpfr_div_ui (tc[1], __gmpfr_one, 12, MPFR_RNDN);
-      for (k = 2; k <= p; k++)
+      mpfr_init2 (d, MPFR_PREC (tc[k0]));
+      if (k0 == 1)
+        mpfr_div_ui (tc[1], __gmpfr_one, 12, MPFR_RNDN);
+      for (k = MAX (k0, 2); k <= p; k++)
         {
           mpfr_set_ui (d, k-1, MPFR_RNDN);
           mpfr_div_ui (d, d, 12*k+6, MPFR_RNDN);
@@ -107,6 +109,92 @@ mpfr_zeta_c (int p, mpfr_t *tc)
     }
 }
 
+/* Maximal size (in limbs) of the per-thread cache of the coefficients
+   tc[k] below; 0 disables the cache. This memory is kept by each thread
+   calling mpfr_zeta until mpfr_free_cache, thus the default is small, like
+   for mpfr_exp_2: 4096 limbs allow to cache the p ~ 0.35*d coefficients
+   up to a working precision d of about 800 bits with 64-bit limbs. It can
+   be changed at build time, e.g. with CFLAGS="-DMPFR_ZETA_CACHE_LIMBS=0"
+   to disable the cache. */
+#ifndef MPFR_ZETA_CACHE_LIMBS
+# define MPFR_ZETA_CACHE_LIMBS 4096
+#endif
+
+#if MPFR_ZETA_CACHE_LIMBS
+
+/* Per-thread cache of the coefficients tc[1..zeta_tc_size] computed by
+   mpfr_zeta_c, all with precision zeta_tc_prec (0 if the cache is empty).
+   They only depend on the working precision, whereas mpfr_zeta_c costs
+   O(p^2) operations, which dominates the computation of zeta(s) when
+   p is large, thus they are kept for the next call with the same working
+   precision (and extended if more coefficients are needed). */
+static MPFR_THREAD_ATTR mpfr_t *zeta_tc = NULL;
+static MPFR_THREAD_ATTR int zeta_tc_size = 0;
+static MPFR_THREAD_ATTR int zeta_tc_alloc = 0; /* number of entries */
+static MPFR_THREAD_ATTR mpfr_prec_t zeta_tc_prec = 0;
+
+void
+mpfr_zeta_freecache (void)
+{
+  int l;
+
+  if (zeta_tc != NULL)
+    {
+      for (l = 1; l <= zeta_tc_size; l++)
+        mpfr_clear (zeta_tc[l]);
+      (*__gmp_free_func) (zeta_tc, zeta_tc_alloc * sizeof (mpfr_t));
+      zeta_tc = NULL;
+      zeta_tc_size = 0;
+      zeta_tc_alloc = 0;
+    }
+  zeta_tc_prec = 0;
+}
+
+/* Return a table containing tc[1..p] with precision prec, or NULL if it
+   would exceed MPFR_ZETA_CACHE_LIMBS. */
+static mpfr_t *
+mpfr_zeta_c_cache (int p, mpfr_prec_t prec)
+{
+  int l;
+
+  if ((mp_size_t) p * MPFR_PREC2LIMBS (prec) > MPFR_ZETA_CACHE_LIMBS)
+    return NULL;
+  if (prec != zeta_tc_prec)
+    {
+      mpfr_zeta_freecache ();
+      zeta_tc_prec = prec;
+    }
+  if (p > zeta_tc_size)
+    {
+      if (p >= zeta_tc_alloc)
+        {
+          int alloc = MAX (16, p + p / 4);
+          if (zeta_tc == NULL)
+            zeta_tc = (mpfr_t *)
+              (*__gmp_allocate_func) (alloc * sizeof (mpfr_t));
+          else
+            zeta_tc = (mpfr_t *) (*__gmp_reallocate_func)
+              (zeta_tc, zeta_tc_alloc * sizeof (mpfr_t),
+               alloc * sizeof (mpfr_t));
+          zeta_tc_alloc = alloc;
+        }
+      for (l = zeta_tc_size + 1; l <= p; l++)
+        mpfr_init2 (zeta_tc[l], prec);
+      mpfr_zeta_c (zeta_tc_size + 1, p, zeta_tc);
+      zeta_tc_size = p;
+    }
+  return zeta_tc;
+}
+
+#else
+
+void
+mpfr_zeta_freecache (void)
+{
+}
+
+#endif
+
 /* Input: s - a floating-point number
           n - an integer
    Output: sum - a floating-point number approximating sum(1/i^s, i=1..n-1) */
@@ -138,6 +226,9 @@ mpfr_zeta_part_a (mpfr_t sum, mpfr_srcptr s, int n)
           Assumes s is neither NaN nor Infinite.
    Output: z - Zeta(s) rounded to the precision of z with direction rnd_mode
 */
+/* crossover of the direct sum (no correction term), see mpfr_zeta_pos */
+static MPFR_TUNE_TAB_CONST short zeta_direct_tab[] = { MPFR_ZETA_DIRECT_TAB };
+
 static int
 mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
 {
@@ -145,12 +236,13 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
   double beta, sd, dnep;
   mpfr_t *tc1;
   mpfr_prec_t precz, precs, d, dint;
-  int p, n, l, add;
+  int p, n, l, add, c_direct;
   int inex;
   MPFR_GROUP_DECL (group);
   MPFR_ZIV_DECL (loop);
 
   MPFR_ASSERTD (MPFR_IS_POS (s) && MPFR_GET_EXP (s) >= 0);
+  MPFR_STAT_STATIC_ASSERT (numberof (zeta_direct_tab) == MPFR_PREC_TAB_SIZE);
 
   precz = MPFR_PREC (z);
   precs = MPFR_PREC (s);
@@ -210,7 +302,8 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
         }
       else /* Branch 2 */
         {
-          size_t size;
+          size_t size = 0;
+          int cached = 0;
 
           MPFR_TRACE (printf ("branch 2\n"));
           /* Computation of parameters n, p and working precision */
@@ -221,7 +314,14 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
 #define LOG6dot2832 1.83787940484160805532
           beta = dnep + 0.61 + sd * (LOG6dot2832 - LOG2 *
                                      __gmpfr_floor_log2 (sd));
-          if (beta <= 0.0)
+          /* For beta <= 0, the Euler-Maclaurin formula needs no
+             correction term. Just above, the direct sum is still faster
+             than the computation of the p correction terms: it is used
+             for s >= c*d, where c is given by MPFR_ZETA_DIRECT_TAB (0 if
+             the direct sum is only used for beta <= 0). */
+          c_direct = zeta_direct_tab[MPFR_PREC_TAB_INDEX (d)];
+          if (beta <= 0.0 ||
+              (c_direct != 0 && 1024.0 * sd >= (double) d * c_direct))
             {
               p = 0;
               /* n = 1 + (int) (exp ((dnep - LOG2) / sd)); */
@@ -245,17 +345,24 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
           MPFR_TRACE (printf ("internal precision=%lu\n",
                               (unsigned long) dint));
 
-          size = (p + 1) * sizeof(mpfr_t);
-          tc1 = (mpfr_t*) (*__gmp_allocate_func) (size);
-          for (l=1; l<=p; l++)
-            mpfr_init2 (tc1[l], dint);
           MPFR_GROUP_REPREC_4 (group, dint, b, c, z_pre, f);
 
           MPFR_TRACE (printf ("precision of z = %lu\n",
                               (unsigned long) precz));
 
           /* Computation of the coefficients c_k */
-          mpfr_zeta_c (p, tc1);
+#if MPFR_ZETA_CACHE_LIMBS
+          tc1 = (p > 0) ? mpfr_zeta_c_cache (p, dint) : NULL;
+          cached = tc1 != NULL;
+#endif
+          if (! cached)
+            {
+              size = (p + 1) * sizeof(mpfr_t);
+              tc1 = (mpfr_t*) (*__gmp_allocate_func) (size);
+              for (l=1; l<=p; l++)
+                mpfr_init2 (tc1[l], dint);
+              mpfr_zeta_c (1, p, tc1);
+            }
           /* Computation of the 3 parts of the function Zeta. */
           mpfr_zeta_part_a (z_pre, s, n);
           mpfr_zeta_part_b (b, s, n, p, tc1);
@@ -266,9 +373,12 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
           MPFR_TRACE (MPFR_DUMP (c));
           mpfr_add (z_pre, z_pre, c, MPFR_RNDN);
           mpfr_add (z_pre, z_pre, b, MPFR_RNDN);
-          for (l=1; l<=p; l++)
-            mpfr_clear (tc1[l]);
-          (*__gmp_free_func) (tc1, size);
+          if (! cached)
+            {
+              for (l=1; l<=p; l++)
+                mpfr_clear (tc1[l]);
+              (*__gmp_free_func) (tc1, size);
+            }
           /* End branch 2 */
         }
 
@@ -298,6 +408,7 @@ mpfr_zeta (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
   MPFR_GROUP_DECL (group);
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_LATENCY_FUNC (MPFR_PREC (z));
 
   MPFR_LOG_FUNC (
     ("s[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (s), mpfr_log_prec, s, rnd_mode),
@@ -242,3 +242,171 @@ mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
       return mpfr_check_range (z, inex, r);
     }
 }
+
+/* Set tab[i] to zeta(m+i) for 0 <= i < n, rounded in the direction r to
+   the precision of tab[i], and tern[i] to the corresponding ternary value
+   (unless tern is NULL).
+
+   This uses the same algorithm as mpfr_zeta_ui, with a common working
+   precision for all arguments: the coefficients d[k] only depend on the
+   working precision, and floor(d[k]/k^(j+1)) = floor(floor(d[k]/k^j)/k),
+   thus the terms of zeta(j+1) are obtained from those of zeta(j) with one
+   division by k each (and fewer and fewer terms are nonzero). The results
+   that cannot be rounded, as well as the trivial cases, are computed with
+   mpfr_zeta_ui.
+
+   Note: the exact Bernoulli numbers are not used for even arguments, since
+   they are computed with mpfr_zeta_ui (see bernoulli.c), which costs much
+   more than the alternating sum below. */
+void
+mpfr_zeta_ui_range (mpfr_ptr *const tab, int *tern, unsigned long m,
+                    unsigned long n, mpfr_rnd_t r)
+{
+  mpfr_prec_t p, pmax;
+  unsigned long i, j, j0, k, kmax, kbits, nk, err;
+  mpz_t *q, d, t, s;
+  mpfr_t y;
+  int *tv, inex;
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_TMP_DECL (marker);
+
+  if (r == MPFR_RNDA)
+    r = MPFR_RNDU; /* since the results are positive for m >= 2 */
+
+  /* the trivial cases are handled by mpfr_zeta_ui: m = 0, m = 1, and
+     m >= PREC(tab[i]), where zeta(m) rounds to 1 or 1 + ulp(1) */
+  pmax = 0;
+  for (i = 0; i < n; i++)
+    {
+      j = m + i;
+      if (j < 2 || j >= MPFR_PREC (tab[i]))
+        {
+          inex = mpfr_zeta_ui (tab[i], j, r);
+          if (tern != NULL)
+            tern[i] = inex;
+        }
+      else if (MPFR_PREC (tab[i]) > pmax)
+        pmax = MPFR_PREC (tab[i]);
+    }
+  if (pmax == 0)
+    return;
+
+  MPFR_TMP_MARK (marker);
+  /* tv[i] is the ternary value of tab[i] computed below, or 2 if it could
+     not be rounded */
+  tv = (int *) MPFR_TMP_ALLOC (n * sizeof (int));
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* working precision, as in mpfr_zeta_ui */
+  p = pmax + MPFR_INT_CEIL_LOG2 (pmax);
+  p += MPFR_INT_CEIL_LOG2 (p) + 15;
+
+  /* 0.39321985067869744 = log(2)/log(3+sqrt(8)) */
+  nk = 1 + (unsigned long) (0.39321985067869744 * (double) p);
+
+  mpz_init (s);
+  mpz_init (d);
+  mpz_init (t);
+  q = (mpz_t *) (*__gmp_allocate_func) ((nk + 1) * sizeof (mpz_t));
+
+  /* computation of the d[k], stored in q[k] */
+  mpz_set_ui (t, 1);
+  mpz_mul_2exp (t, t, 2 * nk - 1); /* t[nk] */
+  mpz_set (d, t);
+  for (k = nk; k > 0; k--)
+    {
+      mpz_init_set (q[k], d);
+      /* t[k-1]/t[k] = k*(2k-1)/(nk-k+1)/(nk+k-1)/2, see mpfr_zeta_ui */
+      mpz_mul_ui (t, t, k);
+      mpz_mul_ui (t, t, 2 * k - 1);
+      mpz_fdiv_q_2exp (t, t, 1);
+      mpz_divexact_ui (t, t, nk - k + 1);
+      mpz_divexact_ui (t, t, nk + k - 1);
+      mpz_add (d, d, t);
+    }
+
+  mpfr_init2 (y, p);
+
+  /* q[k] = floor(d[k]/k^j) for the current argument j: k^j > d[k] for
+     k > kmax, thus those terms are zero */
+  kmax = nk;
+  j0 = (m < 2) ? 2 : m;
+  for (j = j0, i = j0 - m; i < n; i++, j++)
+    {
+      if (j == j0)
+        for (k = 2; k <= kmax; k++)
+          {
+            kbits = (MPFR_INT_CEIL_LOG2 (k + 1) - 1) * j + 1;
+            /* k^j has at least kbits bits */
+            if (kbits > mpz_sizeinbase (q[k], 2))
+              {
+                /* q[k'] = 0 for k <= k' <= kmax */
+                kmax = k - 1;
+                break;
+              }
+            mpz_ui_pow_ui (t, k, j);
+            mpz_tdiv_q (q[k], q[k], t);
+          }
+      else
+        for (k = 2; k <= kmax; k++)
+          mpz_tdiv_q_ui (q[k], q[k], k);
+      while (kmax > 1 && mpz_sgn (q[kmax]) == 0)
+        kmax--;
+
+      tv[i] = 2;
+      if (j >= MPFR_PREC (tab[i]))
+        continue; /* already computed above */
+
+      /* alternating sum, from k = kmax down to 1 as in mpfr_zeta_ui */
+      mpz_set_ui (s, 0);
+      for (k = kmax; k > 0; k--)
+        if (k % 2)
+          mpz_add (s, s, q[k]);
+        else
+          mpz_sub (s, s, q[k]);
+
+      /* multiply by 1/(1-2^(1-j)) = 1 + 2^(1-j) + 2^(2-j) + ... */
+      err = nk + 4;
+      mpz_fdiv_q_2exp (t, s, j - 1);
+      do
+        {
+          err ++;
+          mpz_add (s, s, t);
+          mpz_fdiv_q_2exp (t, t, j - 1);
+        }
+      while (mpz_cmp_ui (t, 0) > 0);
+
+      /* divide by d */
+      mpz_mul_2exp (s, s, p);
+      mpz_tdiv_q (s, s, d);
+      mpfr_set_z (y, s, MPFR_RNDN);
+      mpfr_div_2ui (y, y, p, MPFR_RNDN);
+
+      err = MPFR_INT_CEIL_LOG2 (err);
+      if (MPFR_CAN_ROUND (y, p - err, MPFR_PREC (tab[i]), r))
+        tv[i] = mpfr_set (tab[i], y, r);
+    }
+
+  mpfr_clear (y);
+  for (k = 1; k <= nk; k++)
+    mpz_clear (q[k]);
+  (*__gmp_free_func) (q, (nk + 1) * sizeof (mpz_t));
+  mpz_clear (d);
+  mpz_clear (t);
+  mpz_clear (s);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+
+  for (i = 0, j = m; i < n; i++, j++)
+    if (j >= 2 && j < MPFR_PREC (tab[i]))
+      {
+        if (tv[i] != 2)
+          inex = mpfr_check_range (tab[i], tv[i], r);
+        else /* Ziv's loop with a larger precision */
+          inex = mpfr_zeta_ui (tab[i], j, r);
+        if (tern != NULL)
+          tern[i] = inex;
+      }
+
+  MPFR_TMP_FREE (marker);
+}
@@ -0,0 +1,99 @@
+/* mpfr_ziv_stats_enable, mpfr_ziv_stats_get, mpfr_ziv_stats_reset --
+   statistics on the Ziv loops
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Each Ziv loop has a per-thread record, declared by MPFR_ZIV_DECL (see
+   mpfr-impl.h). A record is linked in the list of the current thread the
+   first time it is updated, thus the list only contains the loops that
+   were entered while the statistics were enabled. Since both the records
+   and the list are per thread, no locking is needed. */
+
+/* Per-thread switches of the instrumentation (MPFR_INSTR_* bits), which
+   are tested by MPFR_ZIV_INIT, MPFR_ZIV_NEXT and MPFR_LATENCY_FUNC. */
+MPFR_THREAD_ATTR int __gmpfr_instr = 0;
+
+static MPFR_THREAD_ATTR mpfr_ziv_rec_ptr ziv_stats_list = NULL;
+
+/* Account for iteration number iter (1 for the first one) of the loop
+   whose record is r, with working precision prec. */
+void
+mpfr_ziv_update (mpfr_ziv_rec_ptr r, int iter, mpfr_prec_t prec)
+{
+  if (__gmpfr_instr & MPFR_INSTR_TRACE)
+    mpfr_trace_event (&r->trace_id, r->st.name, MPFR_TRACE_ZIV, iter, prec);
+  if (!(__gmpfr_instr & MPFR_INSTR_ZIV_STATS))
+    return;
+  if (MPFR_UNLIKELY (!r->linked))
+    {
+      r->next = ziv_stats_list;
+      ziv_stats_list = r;
+      r->linked = 1;
+    }
+  if (iter == 1)
+    r->st.calls ++;
+  else if (iter == 2)
+    r->st.failures ++;
+  if ((unsigned long) iter > r->st.max_iter)
+    r->st.max_iter = iter;
+  if (prec > r->st.max_prec)
+    r->st.max_prec = prec;
+}
+
+int
+mpfr_ziv_stats_enable (int enable)
+{
+  int old = (__gmpfr_instr & MPFR_INSTR_ZIV_STATS) != 0;
+
+  if (enable)
+    __gmpfr_instr |= MPFR_INSTR_ZIV_STATS;
+  else
+    __gmpfr_instr &= ~MPFR_INSTR_ZIV_STATS;
+  return old;
+}
+
+int
+mpfr_ziv_stats_get (mpfr_ziv_stats_t *st, unsigned long i)
+{
+  mpfr_ziv_rec_ptr r;
+
+  for (r = ziv_stats_list; r != NULL && i > 0; r = r->next, i--);
+  if (r == NULL)
+    return 0;
+  *st = r->st;
+  return 1;
+}
+
+void
+mpfr_ziv_stats_reset (void)
+{
+  mpfr_ziv_rec_ptr r;
+
+  for (r = ziv_stats_list; r != NULL; r = r->next)
+    {
+      r->st.calls = 0;
+      r->st.failures = 0;
+      r->st.max_iter = 0;
+      r->st.max_prec = 0;
+    }
+}
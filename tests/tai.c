@@ -25,9 +25,10 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define TEST_FUNCTION mpfr_ai
 #define TEST_RANDOM_EMIN -5
 #define TEST_RANDOM_EMAX 5
-#define REDUCE_EMAX 7 /* this is to avoid that test_generic() calls mpfr_ai
-                         with too large inputs. FIXME: remove this once
-                         mpfr_ai can handle large inputs */
+#define REDUCE_EMAX 1000 /* Ai(x) for x < 0 needs 2/3*|x|^(3/2) modulo 2*Pi,
+                            thus a working precision of more than 3/2*EXP(x)
+                            bits: avoid that test_generic() calls mpfr_ai
+                            on -2^emax */
 #include "tgeneric.c"
 
 static void
@@ -46,7 +47,6 @@ check_large (void)
       printf ("Error in mpfr_ai for x=-2^8\n");
       exit (1);
     }
-#if 0 /* disabled since mpfr_ai does not currently handle large arguments */
   mpfr_set_str_binary (x, "-1E26");
   mpfr_ai (y, x, MPFR_RNDN);
   mpfr_set_str_binary (z, "-110001111100000011001010010101001101001011001011101011001010100100001110001101101101000010000011001000001011E-118");
@@ -55,16 +55,83 @@ check_large (void)
       printf ("Error in mpfr_ai for x=-2^26\n");
       exit (1);
     }
+#if 0 /* disabled since this needs a working precision of about 1.6e9 bits */
   mpfr_set_str_binary (x, "-0.11111111111111111111111111111111111111E1073741823");
   mpfr_ai (y, x, MPFR_RNDN);
   /* FIXME: compute the correctly rounded value we should get for Ai(x),
      and check we get this value */
 #endif
+
+  /* Ai(2^40) ~ exp(-2/3*2^60) underflows */
+  mpfr_set_ui_2exp (x, 1, 40, MPFR_RNDN);
+  mpfr_clear_flags ();
+  mpfr_ai (y, x, MPFR_RNDN);
+  if (! MPFR_IS_ZERO (y) || MPFR_IS_NEG (y) || ! mpfr_underflow_p ())
+    {
+      printf ("Error in mpfr_ai for x=2^40, rnd=RNDN\n");
+      printf ("Got "); mpfr_dump (y);
+      exit (1);
+    }
+  mpfr_clear_flags ();
+  mpfr_ai (y, x, MPFR_RNDU);
+  mpfr_set_ui_2exp (z, 1, mpfr_get_emin () - 1, MPFR_RNDN);
+  if (! mpfr_equal_p (y, z) || ! mpfr_underflow_p ())
+    {
+      printf ("Error in mpfr_ai for x=2^40, rnd=RNDU\n");
+      printf ("Got "); mpfr_dump (y);
+      exit (1);
+    }
+
   mpfr_clear (x);
   mpfr_clear (y);
   mpfr_clear (z);
 }
 
+/* Check the asymptotic expansion, used for |x| large enough with respect to
+   the precision, against the power series, used with 400 bits. */
+static void
+check_asympt (void)
+{
+  mpfr_t x, y, t;
+  mpfr_prec_t p;
+  mpfr_rnd_t rnd;
+  int i, inex;
+
+  mpfr_init2 (x, 20);
+  mpfr_init2 (y, MPFR_PREC_MIN);
+  mpfr_init2 (t, 400);
+  for (i = 0; i < 200; i++)
+    {
+      p = MPFR_PREC_MIN + (randlimb () % 60);
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_ui (x, x, 12, MPFR_RNDN);
+      mpfr_add_ui (x, x, 8, MPFR_RNDN);
+      if (i & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_set_prec (t, 400);
+      mpfr_ai (t, x, MPFR_RNDN);
+      rnd = RND_RAND ();
+      if (! mpfr_can_round (t, 390, MPFR_RNDN, rnd, p))
+        continue;
+      mpfr_set_prec (y, p);
+      inex = mpfr_ai (y, x, rnd);
+      mpfr_prec_round (t, p, rnd);
+      if (! mpfr_equal_p (y, t))
+        {
+          printf ("Error in check_asympt for p=%lu, rnd=%s\n",
+                  (unsigned long) p, mpfr_print_rnd_mode (rnd));
+          printf ("x = "); mpfr_dump (x);
+          printf ("Expected "); mpfr_dump (t);
+          printf ("Got      "); mpfr_dump (y);
+          exit (1);
+        }
+      MPFR_ASSERTN (inex != 0);
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+  mpfr_clear (t);
+}
+
 static void
 check_zero (void)
 {
@@ -97,6 +164,7 @@ main (int argc, char *argv[])
 
   check_large ();
   check_zero ();
+  check_asympt ();
 
   test_generic (MPFR_PREC_MIN, 100, 5);
 
@@ -0,0 +1,178 @@
+/* Test file for mpfr_alloc_stats_enable, mpfr_alloc_stats_export and
+   mpfr_alloc_stats_reset.
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* large enough so that MPFR_TMP_ALLOC does not use alloca */
+#define BIGPREC 300000
+
+/* Set *a to the counters of function name for the current thread, all
+   zero if it has none. */
+static void
+get_stats (mpfr_alloc_stats_t *a, const char *name)
+{
+  mpfr_alloc_stats_t tab[16];
+  int i;
+
+  for (i = 0; i < 16; i++)
+    tab[i].name = NULL;
+  if (mpfr_alloc_stats_export (tab, 16) != 0)
+    {
+      printf ("Error, mpfr_alloc_stats_export should return 0\n");
+      exit (1);
+    }
+  memset (a, 0, sizeof (mpfr_alloc_stats_t));
+  for (i = 0; i < 16 && tab[i].name != NULL; i++)
+    if (strcmp (tab[i].name, name) == 0)
+      *a = tab[i];
+}
+
+/* Counters of one call to mpfr_log(3) at precision BIGPREC */
+static void
+stats_log (mpfr_alloc_stats_t *a)
+{
+  mpfr_t x, y;
+
+  mpfr_init2 (x, BIGPREC);
+  mpfr_init2 (y, BIGPREC);
+  mpfr_set_ui (x, 3, MPFR_RNDN);
+  mpfr_alloc_stats_reset ();
+  mpfr_log (y, x, MPFR_RNDN);
+  get_stats (a, "mpfr_log");
+  mpfr_clear (x);
+  mpfr_clear (y);
+  if (a->calls != 1 || a->mallocs == 0 || a->peak > a->bytes)
+    {
+      printf ("Error, wrong counters for mpfr_log\n");
+      printf ("calls=%lu mallocs=%lu bytes=%lu peak=%lu\n", a->calls,
+              a->mallocs, (unsigned long) a->bytes,
+              (unsigned long) a->peak);
+      exit (1);
+    }
+}
+
+/* The memory that mpfr_log keeps in the caches (pi, log(2), the mpz pool)
+   is counted in the call that fills them: it is still live when that call
+   returns, thus it is included in its peak. The next call allocates less,
+   and after mpfr_free_cache, which also frees the counters, a call
+   allocates exactly as much as the first one again. */
+static void
+check_cache (void)
+{
+  mpfr_alloc_stats_t cold, warm, again;
+
+  mpfr_free_cache ();
+  if (mpfr_alloc_stats_enable (1) != 0)
+    {
+      printf ("Error, accounting should be disabled by default\n");
+      exit (1);
+    }
+  stats_log (&cold);
+  stats_log (&warm);
+  mpfr_free_cache ();
+  get_stats (&again, "mpfr_log");
+  if (again.calls != 0)
+    {
+      printf ("Error, counters not freed by mpfr_free_cache\n");
+      exit (1);
+    }
+  stats_log (&again);
+  mpfr_alloc_stats_enable (0);
+
+  /* pi and log(2) are kept with at least BIGPREC bits each */
+  if (cold.peak < 2 * (BIGPREC / CHAR_BIT) ||
+      warm.bytes >= cold.bytes || warm.peak >= cold.peak ||
+      again.mallocs != cold.mallocs || again.bytes != cold.bytes ||
+      again.peak != cold.peak)
+    {
+      printf ("Error, wrong counters for the cached constants\n");
+      printf ("cold:  mallocs=%lu bytes=%lu peak=%lu\n", cold.mallocs,
+              (unsigned long) cold.bytes, (unsigned long) cold.peak);
+      printf ("warm:  mallocs=%lu bytes=%lu peak=%lu\n", warm.mallocs,
+              (unsigned long) warm.bytes, (unsigned long) warm.peak);
+      printf ("again: mallocs=%lu bytes=%lu peak=%lu\n", again.mallocs,
+              (unsigned long) again.bytes, (unsigned long) again.peak);
+      exit (1);
+    }
+}
+
+/* The allocations of nested calls go to the outermost one, and the string
+   returned by mpfr_get_str is counted, though it is not freed by it. */
+static void
+check_attribution (void)
+{
+  mpfr_alloc_stats_t a;
+  mpfr_t x, y, z;
+  mpfr_exp_t e;
+  char *s;
+
+  mpfr_init2 (x, 53);
+  mpfr_init2 (y, BIGPREC);
+  mpfr_init2 (z, 53);
+  mpfr_set_ui (z, 3, MPFR_RNDN);
+  mpfr_set_ui_2exp (x, 1, -1, MPFR_RNDN);
+
+  mpfr_alloc_stats_reset ();
+  mpfr_alloc_stats_enable (1);
+  mpfr_pow (y, z, x, MPFR_RNDN);  /* calls mpfr_exp */
+  s = mpfr_get_str (NULL, &e, 10, 0, y, MPFR_RNDN);
+  mpfr_alloc_stats_enable (0);
+
+  get_stats (&a, "mpfr_exp");
+  if (a.calls != 0)
+    {
+      printf ("Error, mpfr_exp called by mpfr_pow should not be counted\n");
+      exit (1);
+    }
+  get_stats (&a, "mpfr_pow");
+  if (a.calls != 1 || a.bytes < BIGPREC / CHAR_BIT)
+    {
+      printf ("Error, wrong counters for mpfr_pow\n");
+      exit (1);
+    }
+  get_stats (&a, "mpfr_get_str");
+  if (a.calls != 1 || a.bytes < strlen (s) + 1 || a.peak < strlen (s) + 1)
+    {
+      printf ("Error, the string of mpfr_get_str is not counted\n");
+      exit (1);
+    }
+
+  mpfr_free_str (s);
+  mpfr_clear (x);
+  mpfr_clear (y);
+  mpfr_clear (z);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+#if __MPFR_GNUC(3,3)
+  check_cache ();
+  check_attribution ();
+#endif
+
+  tests_end_mpfr ();
+  return 0;
+}
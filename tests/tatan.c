@@ -20,6 +20,7 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+#define MPFR_NEED_LONGLONG_H
 #include "mpfr-test.h"
 
 static void
@@ -614,6 +615,84 @@ reduced_expo_range (void)
   mpfr_clears (x, y, ex_y, (mpfr_ptr) 0);
 }
 
+/* check atan(x) and atan2(y,x) for large |x| and |y/x| respectively,
+   where atan uses the series of atan(1/x) with a few terms, against
+   sign(y)*(Pi/2 - atan(x/|y|)), computed with a larger precision */
+static void
+check_large (void)
+{
+  static const short large_tab[] = { MPFR_ATAN_LARGE_TAB };
+  mpfr_t x, y, u, t, z;
+  mpfr_prec_t p, q;
+  mpfr_rnd_t rnd;
+  long e;
+  int i, n, inex, atan2_p;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, y, u, t, z, (mpfr_ptr) 0);
+  for (i = 0; i < 200; i++)
+    {
+      atan2_p = i & 1;
+      p = MPFR_PREC_MIN + (randlimb () % 300);
+      n = 1 + (randlimb () % (2 * large_tab[MPFR_PREC_TAB_INDEX (p + 5)]));
+      e = (p + 2 * n - 1) / (2 * n) + 1 + (randlimb () % 4);
+      mpfr_set_prec (x, MPFR_PREC_MIN + (randlimb () % 300));
+      mpfr_set_prec (y, MPFR_PREC_MIN + (randlimb () % 300));
+      mpfr_urandomb (y, RANDS);
+      if (MPFR_IS_ZERO (y))
+        continue;
+      mpfr_set_exp (y, e);
+      if (randlimb () & 1)
+        mpfr_neg (y, y, MPFR_RNDN);
+      if (atan2_p)
+        {
+          mpfr_urandomb (x, RANDS);
+          if (MPFR_IS_ZERO (x))
+            continue;
+          if (randlimb () & 1)
+            mpfr_neg (x, x, MPFR_RNDN);
+        }
+      else
+        mpfr_set_ui (x, 1, MPFR_RNDN);
+
+      /* t = Pi/2 - atan(x/|y|) >= Pi/4, with an error of a few ulps */
+      q = p + MPFR_PREC (x) + MPFR_PREC (y) + 20;
+      mpfr_set_prec (u, q);
+      mpfr_set_prec (t, q);
+      mpfr_div (u, x, y, MPFR_RNDN);
+      mpfr_abs (u, u, MPFR_RNDN);
+      if (MPFR_IS_NEG (x))
+        mpfr_neg (u, u, MPFR_RNDN);
+      mpfr_atan (u, u, MPFR_RNDN);
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_div_2ui (t, t, 1, MPFR_RNDN);
+      mpfr_sub (t, t, u, MPFR_RNDN);
+      if (MPFR_IS_NEG (y))
+        mpfr_neg (t, t, MPFR_RNDN);
+
+      rnd = RND_RAND ();
+      if (! mpfr_can_round (t, q - 3, MPFR_RNDN, rnd, p))
+        continue;
+      mpfr_set_prec (z, p);
+      if (atan2_p)
+        inex = mpfr_atan2 (z, y, x, rnd);
+      else
+        inex = mpfr_atan (z, y, rnd);
+      mpfr_prec_round (t, p, rnd);
+      if (! mpfr_equal_p (z, t))
+        {
+          printf ("Error in check_large for %s, rnd=%s\n",
+                  atan2_p ? "atan2" : "atan", mpfr_print_rnd_mode (rnd));
+          printf ("y = "); mpfr_dump (y);
+          printf ("x = "); mpfr_dump (x);
+          printf ("Expected "); mpfr_dump (t);
+          printf ("Got      "); mpfr_dump (z);
+          exit (1);
+        }
+      MPFR_ASSERTN (inex != 0);
+    }
+  mpfr_clears (x, y, u, t, z, (mpfr_ptr) 0);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -626,6 +705,7 @@ main (int argc, char *argv[])
   atan2_bug_20071003 ();
   atan2_different_prec ();
   reduced_expo_range ();
+  check_large ();
 
   test_generic_atan  (MPFR_PREC_MIN, 200, 17);
   test_generic_atan2 (MPFR_PREC_MIN, 200, 17);
@@ -20,11 +20,54 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+/* see check_forced_series */
+#define MPFR_NEED_LONGLONG_H
+#define MPFR_TUNE_TAB_CONST
 #include "mpfr-test.h"
 
 #define TEST_FUNCTION mpfr_eint
 #include "tgeneric.c"
 
+/* Like in tuneup, eint.c is compiled here with a writable table
+   eint_asympt_tab, with mpfr_eint renamed to eint_tab. */
+int eint_tab (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+#define mpfr_eint eint_tab
+#include "eint.c"
+#undef mpfr_eint
+
+/* When tuneup forces the series for large x (by a large value in
+   MPFR_EINT_ASYMPT_TAB), the series may not converge in the working
+   precision: mpfr_eint_aux then returns a failure, and it used to leave
+   its result unset (NaN), whose exponent was used by mpfr_eint. */
+static void
+check_forced_series (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  int i, inex1, inex2;
+
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    eint_asympt_tab[i] = SHRT_MAX;
+  mpfr_init2 (x, 32);
+  for (p = MPFR_PREC_MIN; p <= 32; p++)
+    {
+      mpfr_inits2 (p, y, z, (mpfr_ptr) 0);
+      mpfr_set_ui (x, 16, MPFR_RNDN);
+      inex1 = eint_tab (y, x, MPFR_RNDN);
+      inex2 = mpfr_eint (z, x, MPFR_RNDN);
+      if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in check_forced_series for prec = %lu\n",
+                  (unsigned long) p);
+          printf ("expected "); mpfr_dump (z);
+          printf ("got      "); mpfr_dump (y);
+          exit (1);
+        }
+      mpfr_clears (y, z, (mpfr_ptr) 0);
+    }
+  mpfr_clear (x);
+}
+
 static void
 check_specials (void)
 {
@@ -237,6 +280,7 @@ main (int argc, char *argv[])
   else
     {
       check_specials ();
+      check_forced_series ();
 
       test_generic (MPFR_PREC_MIN, 100, 100);
     }
@@ -601,6 +601,152 @@ test_erfc (void)
   mpfr_clears (x, y, z, (mpfr_ptr) 0);
 }
 
+/* Check erfc(x) for x in [1, 33], where it is computed with the series of
+   mpfr_erfc_0 or just above the switch to the asymptotic expansion, against
+   a computation in larger precision. */
+static void
+mid_range (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  int i, rnd;
+
+  mpfr_init2 (x, 53);
+  for (i = 0; i < 12; i++)
+    {
+      p = 40 + (randlimb () % 1000);
+      mpfr_init2 (y, p);
+      mpfr_init2 (z, p + 20);
+      mpfr_urandomb (x, RANDS);
+      if (i < 4) /* x^2 close to 0.7p */
+        {
+          mpfr_mul_d (x, x, 0.05, MPFR_RNDN);
+          mpfr_add_d (x, x, 0.975, MPFR_RNDN);
+          mpfr_mul_ui (x, x, 7 * p, MPFR_RNDN);
+          mpfr_div_ui (x, x, 10, MPFR_RNDN);
+          mpfr_sqrt (x, x, MPFR_RNDN);
+        }
+      else
+        {
+          mpfr_mul_2ui (x, x, i / 2, MPFR_RNDN);
+          mpfr_add_ui (x, x, 1, MPFR_RNDN);
+        }
+      mpfr_erfc (z, x, MPFR_RNDN);
+      RND_LOOP (rnd)
+        if (mpfr_can_round (z, p + 20, MPFR_RNDN, MPFR_RNDZ,
+                            p + (rnd == MPFR_RNDN)))
+          {
+            mpfr_t t;
+
+            mpfr_init2 (t, p);
+            mpfr_set (t, z, (mpfr_rnd_t) rnd);
+            mpfr_erfc (y, x, (mpfr_rnd_t) rnd);
+            if (! mpfr_equal_p (y, t))
+              {
+                printf ("Error in mid_range for prec = %lu, %s\nx = ",
+                        (unsigned long) p,
+                        mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+                mpfr_dump (x);
+                printf ("got      ");
+                mpfr_dump (y);
+                printf ("expected ");
+                mpfr_dump (t);
+                exit (1);
+              }
+            mpfr_clear (t);
+          }
+      mpfr_clears (y, z, (mpfr_ptr) 0);
+    }
+
+  /* this used to fail with an assertion failure in mpfr_erf */
+  mpfr_set_prec (x, 1000);
+  mpfr_init2 (y, 1000);
+  mpfr_set_str (x, "27.5", 10, MPFR_RNDN);
+  mpfr_erfc (y, x, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_cmp_ui_2exp (y, 1, -1097) > 0 &&
+                mpfr_cmp_ui_2exp (y, 1, -1096) < 0);
+
+  /* this used to loop forever: the asymptotic expansion was used for a
+     working precision of 10 bits, where it does not reach ulp(y) */
+  mpfr_set_prec (x, 80);
+  mpfr_set_prec (y, 2);
+  mpfr_set_str_binary (x, "0.10101010010101011100011100011101001100111101011"
+                       "001001110000100110100100011100010E2");
+  mpfr_erfc (y, x, MPFR_RNDD);
+  MPFR_ASSERTN (mpfr_cmp_ui_2exp (y, 1, -13) == 0);
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+/* Check that mpfr_erf_erfc agrees with mpfr_erf and mpfr_erfc, including
+   the ternary value and the flags. */
+static void
+erf_erfc_consistency (void)
+{
+  mpfr_t x, y1, y2, z1, z2;
+  mpfr_rnd_t rnd;
+  unsigned int flags_erf, flags_erfc, flags;
+  int inex_erf, inex_erfc, inex, inex_ref;
+  int i;
+
+  for (i = 0; i <= 1000; i++)
+    {
+      mpfr_init2 (x, MPFR_PREC_MIN + (randlimb () % 200));
+      mpfr_inits2 (MPFR_PREC_MIN + (randlimb () % 200), y1, y2, (mpfr_ptr) 0);
+      mpfr_inits2 (MPFR_PREC_MIN + (randlimb () % 200), z1, z2, (mpfr_ptr) 0);
+      if (i == 0)
+        mpfr_set_nan (x);
+      else if (i < 3)
+        mpfr_set_inf (x, i == 1 ? 1 : -1);
+      else if (i == 3)
+        mpfr_set_zero (x, -1);
+      else if (i < 10) /* x = +/-1/2, +/-1, +/-2 */
+        mpfr_set_si_2exp (x, (i & 1) ? 1 : -1, i / 2 - 3, MPFR_RNDN);
+      else
+        tests_default_random (x, 128, -20, 6, 0);
+      /* for odd i, check with y and x the same variable */
+      if (i & 1)
+        mpfr_prec_round (x, mpfr_get_prec (y2), MPFR_RNDN);
+      rnd = RND_RAND ();
+      mpfr_clear_flags ();
+      inex_erf = mpfr_erf (y1, x, rnd);
+      flags_erf = __gmpfr_flags;
+      mpfr_clear_flags ();
+      inex_erfc = mpfr_erfc (z1, x, rnd);
+      flags_erfc = __gmpfr_flags;
+      mpfr_clear_flags ();
+      if (i & 1)
+        {
+          mpfr_set (y2, x, MPFR_RNDN);
+          inex = mpfr_erf_erfc (y2, z2, y2, rnd);
+        }
+      else
+        inex = mpfr_erf_erfc (y2, z2, x, rnd);
+      flags = __gmpfr_flags;
+      inex_ref = INEX (inex_erf, inex_erfc);
+      if (! (mpfr_equal_p (y1, y2) || (mpfr_nan_p (y1) && mpfr_nan_p (y2))) ||
+          ! (mpfr_equal_p (z1, z2) || (mpfr_nan_p (z1) && mpfr_nan_p (z2))) ||
+          (! mpfr_nan_p (y1) && inex != inex_ref) ||
+          flags != (flags_erf | flags_erfc))
+        {
+          printf ("mpfr_erf_erfc and mpfr_erf/mpfr_erfc disagree on %s,"
+                  " i = %d\nx = ", mpfr_print_rnd_mode (rnd), i);
+          mpfr_dump (x);
+          printf ("erf  = ");
+          mpfr_dump (y1);
+          printf ("got    ");
+          mpfr_dump (y2);
+          printf ("erfc = ");
+          mpfr_dump (z1);
+          printf ("got    ");
+          mpfr_dump (z2);
+          printf ("inex = %d (expected %d), flags = %u (expected %u)\n",
+                  inex, inex_ref, flags, flags_erf | flags_erfc);
+          exit (1);
+        }
+      mpfr_clears (x, y1, y2, z1, z2, (mpfr_ptr) 0);
+    }
+}
+
 /* Failure in r7569 (2011-03-15) due to incorrect flags. */
 static void
 reduced_expo_range (void)
@@ -647,6 +793,8 @@ main (int argc, char *argv[])
   special_erfc ();
   large_arg ();
   test_erfc ();
+  mid_range ();
+  erf_erfc_consistency ();
   reduced_expo_range ();
 
   test_generic_erf (MPFR_PREC_MIN, 100, 15);
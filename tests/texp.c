@@ -209,6 +209,113 @@ compare_exp2_exp3 (mpfr_prec_t p0, mpfr_prec_t p1)
   mpfr_clear (z);
 }
 
+/* check mpfr_exp_2 with repeated calls at the same precision, which use
+   the per-thread cache of argument reduction data */
+static void
+check_exp_2_cache (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t prec;
+  mpfr_rnd_t rnd;
+  int i;
+
+  mpfr_inits2 (53, x, y, z, (mpfr_ptr) 0);
+  for (prec = 2; prec < 1000; prec += prec / 2 + 1)
+    {
+      mpfr_set_prec (y, prec);
+      mpfr_set_prec (z, prec);
+      for (i = -64; i < 200; i++)
+        {
+          if (i < 64)
+            {
+              /* x = i/256 is a multiple of 2^(-m) for small m */
+              if (i == 0)
+                continue;
+              mpfr_set_prec (x, 53);
+              mpfr_set_si_2exp (x, i, -8, MPFR_RNDN);
+            }
+          else
+            {
+              mpfr_set_prec (x, prec);
+              mpfr_urandomb (x, RANDS);
+              if (MPFR_IS_ZERO (x))
+                continue;
+              mpfr_mul_2si (x, x, (int) (randlimb () % 36) - 8, MPFR_RNDN);
+              if (randlimb () & 1)
+                mpfr_neg (x, x, MPFR_RNDN);
+            }
+          rnd = RND_RAND ();
+          mpfr_exp_2 (y, x, rnd);
+          mpfr_exp_3 (z, x, rnd);
+          if (mpfr_cmp (y, z))
+            {
+              printf ("Error in check_exp_2_cache for prec=%lu rnd=%s\n"
+                      "x=", (unsigned long) prec, mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("mpfr_exp_2 gives ");
+              mpfr_dump (y);
+              printf ("mpfr_exp_3 gives ");
+              mpfr_dump (z);
+              exit (1);
+            }
+          if (i == 100)
+            mpfr_free_cache ();
+        }
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+/* check sparse inputs, i.e., with few significant bits compared to the
+   target precision, for which mpfr_exp uses mpfr_exp_3 from a smaller
+   precision than MPFR_EXP_THRESHOLD */
+static void
+check_sparse (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t prec, px;
+  mpfr_rnd_t rnd;
+  int i, inex1, inex2;
+
+  mpfr_inits2 (53, x, y, z, (mpfr_ptr) 0);
+  for (prec = MPFR_EXP_SPARSE_THRESHOLD - 7;
+       prec < MPFR_EXP_SPARSE_THRESHOLD + 1000; prec += 331)
+    {
+      mpfr_set_prec (y, prec);
+      mpfr_set_prec (z, prec);
+      for (i = 0; i < 8; i++)
+        {
+          /* px ranges from 1 to about 2 prec / MPFR_EXP_SPARSE_RATIO, and
+             x may have a larger precision than its significant bits */
+          px = 1 + randlimb () % (2 * prec / MPFR_EXP_SPARSE_RATIO);
+          mpfr_set_prec (x, px);
+          mpfr_urandomb (x, RANDS);
+          if (MPFR_IS_ZERO (x))
+            mpfr_set_ui (x, 1, MPFR_RNDN);
+          mpfr_prec_round (x, px + (randlimb () % 3) * GMP_NUMB_BITS,
+                           MPFR_RNDN);
+          mpfr_mul_2si (x, x, (int) (randlimb () % 24) - 12, MPFR_RNDN);
+          if (randlimb () & 1)
+            mpfr_neg (x, x, MPFR_RNDN);
+          rnd = RND_RAND ();
+          inex1 = mpfr_exp (y, x, rnd);
+          inex2 = mpfr_exp_2 (z, x, rnd);
+          if (mpfr_cmp (y, z) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in check_sparse for prec=%lu rnd=%s\nx=",
+                      (unsigned long) prec, mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("mpfr_exp   gives ");
+              mpfr_dump (y);
+              printf ("mpfr_exp_2 gives ");
+              mpfr_dump (z);
+              printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
 static void
 check_large (void)
 {
@@ -979,6 +1086,12 @@ main (int argc, char *argv[])
   test_generic (MPFR_PREC_MIN, 100, 100);
 
   compare_exp2_exp3 (20, 1000);
+  check_exp_2_cache ();
+  check_sparse ();
+  /* check mpfr_exp_2 around the switch to the sinh-based evaluation */
+  if (MPFR_EXP_2_SINH_THRESHOLD > 20 && MPFR_EXP_2_SINH_THRESHOLD < 10000)
+    compare_exp2_exp3 (MPFR_EXP_2_SINH_THRESHOLD - 20,
+                       MPFR_EXP_2_SINH_THRESHOLD + 20);
   check_worst_cases();
   check3("0.0", MPFR_RNDU, "1.0");
   check3("-1e-170", MPFR_RNDU, "1.0");
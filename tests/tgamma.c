@@ -1055,6 +1055,54 @@ exp_lgamma_tests (void)
   set_emax (emax);
 }
 
+/* Check mpfr_gamma in large precision, where the terms of the Stirling
+   series are computed with a decreasing precision, against a result
+   computed with 64 more bits. */
+static void
+large_prec (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  mpfr_rnd_t rnd;
+  int i;
+
+  mpfr_init2 (x, 1500);
+  mpfr_init2 (y, 1500);
+  mpfr_init2 (z, 1564);
+  for (i = 0; i < 6; i++)
+    {
+      p = 1000 + (randlimb () % 500);
+      mpfr_set_prec (x, p);
+      mpfr_set_prec (y, p);
+      mpfr_set_prec (z, p + 64);
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2ui (x, x, 2 * i, MPFR_RNDN);
+      mpfr_add_ui (x, x, 1, MPFR_RNDN);
+      rnd = RND_RAND ();
+      mpfr_gamma (y, x, rnd);
+      mpfr_gamma (z, x, MPFR_RNDN);
+      if (mpfr_can_round (z, p + 60, MPFR_RNDN, MPFR_RNDZ,
+                          p + (rnd == MPFR_RNDN)))
+        {
+          mpfr_prec_round (z, p, rnd);
+          if (! mpfr_equal_p (y, z))
+            {
+              printf ("Error in large_prec for prec=%lu, rnd=%s\nx=",
+                      (unsigned long) p, mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("expected ");
+              mpfr_dump (z);
+              printf ("got      ");
+              mpfr_dump (y);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+  mpfr_clear (z);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1083,6 +1131,7 @@ main (int argc, char *argv[])
   test20100709 ();
   test20120426 ();
   exp_lgamma_tests ();
+  large_prec ();
 
   data_check ("data/gamma", mpfr_gamma, "mpfr_gamma");
 
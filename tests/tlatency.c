@@ -0,0 +1,157 @@
+/* Test file for mpfr_latency_enable, mpfr_latency_export and
+   mpfr_latency_reset.
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#define TABSIZE 64
+
+static mpfr_latency_hist_t tab[TABSIZE];
+
+static void
+clear_tab (void)
+{
+  int i;
+
+  for (i = 0; i < TABSIZE; i++)
+    tab[i].name = NULL;
+}
+
+/* Return the number of calls of function name in bucket k of tab. */
+static unsigned long
+count_calls (const char *name, int k)
+{
+  unsigned long n = 0;
+  int i, j;
+
+  for (i = 0; i < TABSIZE && tab[i].name != NULL; i++)
+    if (strcmp (tab[i].name, name) == 0)
+      for (j = 0; j < MPFR_LATENCY_BINS; j++)
+        n += tab[i].count[k][j];
+  return n;
+}
+
+static void
+run_exp (mpfr_prec_t p, int n)
+{
+  mpfr_t x, y;
+  int i;
+
+  mpfr_init2 (x, p);
+  mpfr_init2 (y, p);
+  for (i = 0; i < n; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_exp (y, x, MPFR_RNDN);
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+static void
+check_export (const char *s, int k, unsigned long expected)
+{
+  unsigned long n = count_calls ("mpfr_exp", k);
+
+  if (n != expected)
+    {
+      printf ("Error (%s): got %lu calls of mpfr_exp in bucket %d"
+              " instead of %lu\n", s, n, k, expected);
+      exit (1);
+    }
+}
+
+static void
+check_exp (void)
+{
+  mpfr_latency_hist_t small[1];
+
+  mpfr_latency_reset ();
+  if (mpfr_latency_enable (1) != 0)
+    {
+      printf ("Error, histograms should be disabled by default\n");
+      exit (1);
+    }
+  run_exp (53, 100);   /* bucket 0 */
+  run_exp (2000, 10);  /* bucket 5: 1024 < 2000 <= 2048 */
+  if (mpfr_latency_enable (0) != 1)
+    {
+      printf ("Error, mpfr_latency_enable should return 1\n");
+      exit (1);
+    }
+  run_exp (53, 10);    /* not recorded */
+
+  clear_tab ();
+  if (mpfr_latency_export (tab, TABSIZE) != 0)
+    {
+      printf ("Error, mpfr_latency_export should return 0\n");
+      exit (1);
+    }
+  check_export ("first export", 0, 100);
+  check_export ("first export", 5, 10);
+  check_export ("first export", 1, 0);
+
+  /* a second export adds the same values */
+  mpfr_latency_export (tab, TABSIZE);
+  check_export ("second export", 0, 200);
+  check_export ("second export", 5, 20);
+
+  /* no room for mpfr_exp: the only entry is used by another function */
+  small[0].name = "no such function";
+  if (mpfr_latency_export (small, 1) == 0)
+    {
+      printf ("Error, mpfr_latency_export should detect a full table\n");
+      exit (1);
+    }
+
+  mpfr_latency_reset ();
+  clear_tab ();
+  mpfr_latency_export (tab, TABSIZE);
+  check_export ("after reset", 0, 0);
+  check_export ("after reset", 5, 0);
+
+  /* mpfr_free_cache frees the histograms */
+  mpfr_latency_enable (1);
+  run_exp (53, 10);
+  mpfr_latency_enable (0);
+  mpfr_free_cache ();
+  clear_tab ();
+  mpfr_latency_export (tab, TABSIZE);
+  if (tab[0].name != NULL)
+    {
+      printf ("Error, histograms not freed by mpfr_free_cache\n");
+      exit (1);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+#if __MPFR_GNUC(3,3)
+  check_exp ();
+#endif
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -347,6 +347,10 @@ main (int argc, char *argv[])
   x_near_one ();
 
   test_generic (MPFR_PREC_MIN, 100, 40);
+  /* check the switch between the atanh and the AGM algorithms */
+  if (MPFR_LOG_ATANH_THRESHOLD > 20 && MPFR_LOG_ATANH_THRESHOLD < 10000)
+    test_generic (MPFR_LOG_ATANH_THRESHOLD - 20,
+                  MPFR_LOG_ATANH_THRESHOLD + 20, 2);
 
   data_check ("data/log", mpfr_log, "mpfr_log");
   bad_cases (mpfr_log, mpfr_exp, "mpfr_log", 256, -30, 30, 4, 128, 800, 50);
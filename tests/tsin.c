@@ -268,6 +268,155 @@ check_tiny (void)
   mpfr_clear (x);
 }
 
+/* check sin, cos and tan for huge arguments (which use the Payne-Hanek
+   reduction) against the values at the argument reduced with a very
+   accurate value of 2*Pi */
+static void
+check_huge (void)
+{
+  mpfr_t x, xr, c, y, z;
+  mpfr_prec_t p;
+  mpfr_exp_t e;
+  mpfr_rnd_t rnd;
+  int i, k;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, xr, c, y, z, (mpfr_ptr) 0);
+  for (i = 0; i < 40; i++)
+    {
+      p = 2 + (randlimb () % 200);
+      e = 2 + (randlimb () % 3000);
+      mpfr_set_prec (x, 2 + (randlimb () % 200));
+      mpfr_urandomb (x, RANDS);
+      if (MPFR_IS_ZERO (x))
+        continue;
+      mpfr_set_exp (x, e);
+      if (i & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_set_prec (c, e + p + 100);
+      mpfr_set_prec (xr, p + 80);
+      mpfr_const_pi (c, MPFR_RNDN);
+      mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
+      mpfr_remainder (xr, x, c, MPFR_RNDN);
+      mpfr_set_prec (y, p);
+      mpfr_set_prec (z, p);
+      for (k = 0; k < 3; k++)
+        {
+          rnd = RND_RAND ();
+          if (k == 0)
+            {
+              mpfr_sin (y, x, rnd);
+              mpfr_sin (z, xr, rnd);
+            }
+          else if (k == 1)
+            {
+              mpfr_cos (y, x, rnd);
+              mpfr_cos (z, xr, rnd);
+            }
+          else
+            {
+              mpfr_tan (y, x, rnd);
+              mpfr_tan (z, xr, rnd);
+            }
+          if (! mpfr_equal_p (y, z))
+            {
+              printf ("Error in check_huge for %s, rnd=%s, x=\n",
+                      k == 0 ? "sin" : k == 1 ? "cos" : "tan",
+                      mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("expected ");
+              mpfr_dump (z);
+              printf ("got      ");
+              mpfr_dump (y);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, xr, c, y, z, (mpfr_ptr) 0);
+}
+
+/* check sin and cos near multiples of Pi/2, where the reduced argument
+   is tiny, against the values at x - k*Pi/2 computed exactly enough */
+static void
+check_near_kpi (void)
+{
+  mpfr_t x, xr, c, y, z;
+  mpfr_prec_t p;
+  mpfr_rnd_t rnd;
+  unsigned long k;
+  int i;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, xr, c, y, z, (mpfr_ptr) 0);
+  for (i = 0; i < 100; i++)
+    {
+      p = 2 + (randlimb () % 300);
+      k = 1 + (randlimb () % 1000);
+      mpfr_set_prec (x, 2 + (randlimb () % 300));
+      mpfr_set_prec (c, 2 * MPFR_PREC (x) + p + 100);
+      mpfr_set_prec (xr, 2 * MPFR_PREC (x) + p + 100);
+      mpfr_const_pi (c, MPFR_RNDN);
+      mpfr_mul_ui (c, c, k, MPFR_RNDN);
+      mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+      mpfr_set (x, c, RND_RAND ());
+      mpfr_sub (xr, x, c, MPFR_RNDN);
+      if (MPFR_IS_ZERO (xr))
+        continue;
+      mpfr_set_prec (y, p);
+      mpfr_set_prec (z, p);
+      rnd = RND_RAND ();
+      /* sin(x) = sin(xr + k*Pi/2) */
+      mpfr_sin (y, x, rnd);
+      if (k & 1)
+        {
+          mpfr_cos (z, xr, (k & 2) ? MPFR_INVERT_RND (rnd) : rnd);
+          if (k & 2)
+            mpfr_neg (z, z, MPFR_RNDN);
+        }
+      else
+        {
+          mpfr_sin (z, xr, (k & 2) ? MPFR_INVERT_RND (rnd) : rnd);
+          if (k & 2)
+            mpfr_neg (z, z, MPFR_RNDN);
+        }
+      if (! mpfr_equal_p (y, z))
+        {
+          printf ("Error in check_near_kpi for sin, k=%lu, rnd=%s, x=\n",
+                  k, mpfr_print_rnd_mode (rnd));
+          mpfr_dump (x);
+          printf ("expected ");
+          mpfr_dump (z);
+          printf ("got      ");
+          mpfr_dump (y);
+          exit (1);
+        }
+      /* cos(x) = cos(xr + k*Pi/2) */
+      mpfr_cos (y, x, rnd);
+      if (k & 1)
+        {
+          mpfr_sin (z, xr, (k & 2) ? rnd : MPFR_INVERT_RND (rnd));
+          if ((k & 2) == 0)
+            mpfr_neg (z, z, MPFR_RNDN);
+        }
+      else
+        {
+          mpfr_cos (z, xr, (k & 2) ? MPFR_INVERT_RND (rnd) : rnd);
+          if (k & 2)
+            mpfr_neg (z, z, MPFR_RNDN);
+        }
+      if (! mpfr_equal_p (y, z))
+        {
+          printf ("Error in check_near_kpi for cos, k=%lu, rnd=%s, x=\n",
+                  k, mpfr_print_rnd_mode (rnd));
+          mpfr_dump (x);
+          printf ("expected ");
+          mpfr_dump (z);
+          printf ("got      ");
+          mpfr_dump (y);
+          exit (1);
+        }
+    }
+  mpfr_clears (x, xr, c, y, z, (mpfr_ptr) 0);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -367,6 +516,8 @@ main (int argc, char *argv[])
   test_generic (MPFR_SINCOS_THRESHOLD-1, MPFR_SINCOS_THRESHOLD+1, 2);
   test_sign ();
   check_tiny ();
+  check_huge ();
+  check_near_kpi ();
 
   data_check ("data/sin", mpfr_sin, "mpfr_sin");
   bad_cases (mpfr_sin, mpfr_asin, "mpfr_sin", 256, -40, 0, 4, 128, 800, 50);
@@ -0,0 +1,221 @@
+/* Test file for mpfr_trace_enable and mpfr_trace_dump.
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#define FILE_NAME "ttrace.dat" /* temporary file (written then read) */
+
+#define MAX_NAMES 256
+
+static char names[MAX_NAMES][64];
+static unsigned long nnames, lost, nrec;
+static FILE *fh;
+
+static unsigned long
+get (int n)
+{
+  unsigned char buf[4];
+  unsigned long x = 0;
+  int i;
+
+  if (fread (buf, n, 1, fh) != 1)
+    {
+      printf ("Error, truncated trace\n");
+      exit (1);
+    }
+  for (i = n - 1; i >= 0; i--)
+    x = (x << 8) | buf[i];
+  return x;
+}
+
+/* Dump the trace to FILE_NAME and read its header; the records can then
+   be read with get. */
+static void
+dump_and_read_header (void)
+{
+  char magic[8];
+  unsigned long i;
+
+  fh = fopen (FILE_NAME, "wb");
+  if (fh == NULL || mpfr_trace_dump (fh) != 0)
+    {
+      printf ("Error, cannot write the trace\n");
+      exit (1);
+    }
+  fclose (fh);
+  fh = fopen (FILE_NAME, "rb");
+  if (fh == NULL || fread (magic, 8, 1, fh) != 1 ||
+      memcmp (magic, "MPFRTRC1", 8) != 0)
+    {
+      printf ("Error, bad magic string\n");
+      exit (1);
+    }
+  nnames = get (4);
+  MPFR_ASSERTN (nnames <= MAX_NAMES);
+  for (i = 0; i < nnames; i++)
+    {
+      unsigned long l = get (2);
+
+      MPFR_ASSERTN (l < sizeof (names[i]));
+      if (l != 0 && fread (names[i], l, 1, fh) != 1)
+        {
+          printf ("Error, truncated trace\n");
+          exit (1);
+        }
+      names[i][l] = '\0';
+    }
+  lost = get (4);
+  nrec = get (4);
+}
+
+static void
+close_trace (void)
+{
+  fclose (fh);
+  remove (FILE_NAME);
+}
+
+static void
+check_exp (void)
+{
+  mpfr_t x, y;
+  unsigned long i, enter = 0, exit_ = 0, ziv = 0, func;
+  double time, old_time = 0.0;
+  int n = 20;
+
+  mpfr_init2 (x, 100);
+  mpfr_init2 (y, 100);
+  if (mpfr_trace_enable (10000) != 0)
+    {
+      printf ("Error, the trace should be disabled by default\n");
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_exp (y, x, MPFR_RNDN);
+    }
+  if (mpfr_trace_enable (0) != 1)
+    {
+      printf ("Error, mpfr_trace_enable should return 1\n");
+      exit (1);
+    }
+  mpfr_exp (y, x, MPFR_RNDN);  /* not traced */
+
+  dump_and_read_header ();
+  if (lost != 0 || nrec == 0)
+    {
+      printf ("Error, lost=%lu nrec=%lu\n", lost, nrec);
+      exit (1);
+    }
+  for (i = 0; i < nrec; i++)
+    {
+      unsigned long lo = get (4), hi = get (4), prec = get (4);
+      int kind, iter;
+
+      func = get (2);
+      kind = get (1);
+      iter = get (1);
+      time = (double) hi * 4294967296.0 + (double) lo;
+      if (time < old_time || func == 0 || func > nnames)
+        {
+          printf ("Error, bad record %lu (time %.0f, func %lu)\n",
+                  i, time, func);
+          exit (1);
+        }
+      old_time = time;
+      if (strcmp (names[func - 1], "mpfr_exp") == 0 && prec == 100)
+        {
+          enter += kind == 1;
+          exit_ += kind == 2;
+        }
+      if (kind == 3)
+        {
+          MPFR_ASSERTN (iter >= 1);
+          ziv ++;
+        }
+    }
+  close_trace ();
+  if (ziv == 0)
+    {
+      printf ("Error, no Ziv iterations in the trace\n");
+      exit (1);
+    }
+#if __MPFR_GNUC(3,3)
+  if (enter != n || exit_ != n)
+    {
+      printf ("Error, got %lu entries and %lu exits of mpfr_exp instead"
+              " of %d\n", enter, exit_, n);
+      exit (1);
+    }
+#endif
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+/* check that only the last events are kept */
+static void
+check_ring (void)
+{
+  mpfr_t x, y;
+  int i;
+
+  mpfr_init2 (x, 100);
+  mpfr_init2 (y, 100);
+  mpfr_set_ui (x, 17, MPFR_RNDN);
+  mpfr_trace_enable (4);
+  for (i = 0; i < 10; i++)
+    mpfr_sin (y, x, MPFR_RNDN);
+  mpfr_trace_enable (0);
+  dump_and_read_header ();
+  if (nrec != 4 || lost == 0)
+    {
+      printf ("Error, nrec=%lu lost=%lu for a ring of 4 records\n",
+              nrec, lost);
+      exit (1);
+    }
+  close_trace ();
+
+  /* mpfr_free_cache frees the trace */
+  mpfr_free_cache ();
+  dump_and_read_header ();
+  if (nnames != 0 || nrec != 0)
+    {
+      printf ("Error, trace not freed by mpfr_free_cache\n");
+      exit (1);
+    }
+  close_trace ();
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_exp ();
+  check_ring ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -0,0 +1,321 @@
+/* Test file for mpfr_exp_q, mpfr_log_q, mpfr_atan_q, mpfr_sin_q and
+   mpfr_cos_q.
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#ifndef MPFR_USE_MINI_GMP
+
+typedef int (*fq_t) (mpfr_ptr, mpq_srcptr, mpfr_rnd_t);
+typedef int (*f_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+static struct {
+  fq_t fq;
+  f_t f;
+  const char *name;
+} tab[] = {
+  { mpfr_exp_q, mpfr_exp, "exp" },
+  { mpfr_log_q, mpfr_log, "log" },
+  { mpfr_atan_q, mpfr_atan, "atan" },
+  { mpfr_sin_q, mpfr_sin, "sin" },
+  { mpfr_cos_q, mpfr_cos, "cos" }
+};
+
+#define NFUNCS (sizeof (tab) / sizeof (tab[0]))
+
+static void
+print_error (int i, mpq_srcptr q, mpfr_prec_t prec, mpfr_rnd_t rnd,
+             mpfr_srcptr got, mpfr_srcptr expected)
+{
+  printf ("Error in mpfr_%s_q for prec = %lu, %s, x = ", tab[i].name,
+          (unsigned long) prec, mpfr_print_rnd_mode (rnd));
+  mpq_out_str (stdout, 10, q);
+  printf ("\n  got      ");
+  mpfr_dump (got);
+  printf ("  expected ");
+  mpfr_dump (expected);
+  exit (1);
+}
+
+/* When q is a dyadic rational, it is exactly representable, thus the
+   value, the ternary value and the flags must be the same as with the
+   mpfr_t function. */
+static void
+check_dyadic (int i, mpq_srcptr q, mpfr_prec_t prec, mpfr_rnd_t rnd)
+{
+  mpfr_t x, y, z;
+  int inex1, inex2;
+  mpfr_flags_t flags1, flags2;
+
+  mpfr_init2 (x, mpz_sizeinbase (mpq_numref (q), 2) + 1);
+  mpfr_init2 (y, prec);
+  mpfr_init2 (z, prec);
+  inex1 = mpfr_set_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (inex1 == 0);
+  mpfr_clear_flags ();
+  inex1 = tab[i].f (y, x, rnd);
+  flags1 = __gmpfr_flags;
+  mpfr_clear_flags ();
+  inex2 = tab[i].fq (z, q, rnd);
+  flags2 = __gmpfr_flags;
+  if (! mpfr_equal_p (y, z) && ! (mpfr_nan_p (y) && mpfr_nan_p (z)))
+    print_error (i, q, prec, rnd, z, y);
+  if (! SAME_SIGN (inex1, inex2) || flags1 != flags2)
+    {
+      printf ("Wrong ternary value or flags in mpfr_%s_q for prec = %lu,"
+              " %s, x = ", tab[i].name, (unsigned long) prec,
+              mpfr_print_rnd_mode (rnd));
+      mpq_out_str (stdout, 10, q);
+      printf ("\n  expected inex = %d, flags =", inex1);
+      flags_out (flags1);
+      printf ("  got      inex = %d, flags =", inex2);
+      flags_out (flags2);
+      exit (1);
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+/* For a general rational, compare with the mpfr_t function evaluated at a
+   much larger precision. */
+static void
+check_rational (int i, mpq_srcptr q, mpfr_prec_t prec, mpfr_rnd_t rnd)
+{
+  mpfr_t x, y, z, t;
+  mpfr_prec_t yprec = 2 * prec + 64;
+  int inex;
+
+  mpfr_inits2 (yprec + 64, x, (mpfr_ptr) 0);
+  mpfr_inits2 (yprec, y, (mpfr_ptr) 0);
+  mpfr_inits2 (prec, z, t, (mpfr_ptr) 0);
+  mpfr_set_q (x, q, MPFR_RNDN);
+  tab[i].f (y, x, MPFR_RNDN);
+  inex = tab[i].fq (z, q, rnd);
+  /* the error on y is at most 2^(yprec-64) ulps, taking into account the
+     rounding of x */
+  if (mpfr_can_round (y, yprec - 64, MPFR_RNDN, MPFR_RNDZ,
+                      prec + (rnd == MPFR_RNDN)))
+    {
+      mpfr_set (t, y, rnd);
+      if (! mpfr_equal_p (t, z))
+        print_error (i, q, prec, rnd, z, t);
+      if (inex == 0 || mpfr_cmp (z, y) * inex < 0)
+        {
+          printf ("Wrong ternary value in mpfr_%s_q for prec = %lu, %s,"
+                  " x = ", tab[i].name, (unsigned long) prec,
+                  mpfr_print_rnd_mode (rnd));
+          mpq_out_str (stdout, 10, q);
+          printf ("\n  got %d\n", inex);
+          exit (1);
+        }
+    }
+  mpfr_clears (x, y, z, t, (mpfr_ptr) 0);
+}
+
+static void
+special (void)
+{
+  mpfr_t x, y;
+  mpq_t q;
+  int i, inex;
+
+  mpfr_inits2 (53, x, y, (mpfr_ptr) 0);
+  mpq_init (q);
+
+  /* zero argument */
+  for (i = 0; i < (int) NFUNCS; i++)
+    {
+      if (tab[i].fq == mpfr_log_q)
+        continue;
+      mpfr_clear_flags ();
+      inex = tab[i].fq (x, q, MPFR_RNDN);
+      MPFR_ASSERTN (inex == 0 && __gmpfr_flags == 0);
+      if (tab[i].fq == mpfr_exp_q || tab[i].fq == mpfr_cos_q)
+        MPFR_ASSERTN (mpfr_cmp_ui (x, 1) == 0);
+      else
+        MPFR_ASSERTN (mpfr_zero_p (x) && mpfr_signbit (x) == 0);
+    }
+
+  mpfr_clear_flags ();
+  inex = mpfr_log_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (inex == 0 && mpfr_inf_p (x) && mpfr_sgn (x) < 0);
+  MPFR_ASSERTN (__gmpfr_flags == MPFR_FLAGS_DIVBY0);
+
+  mpq_set_si (q, -1, 3);
+  mpfr_clear_flags ();
+  mpfr_log_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_nan_p (x) && __gmpfr_flags == MPFR_FLAGS_NAN);
+
+  mpq_set_ui (q, 1, 1);
+  mpfr_clear_flags ();
+  inex = mpfr_log_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (inex == 0 && mpfr_zero_p (x) && mpfr_signbit (x) == 0);
+  MPFR_ASSERTN (__gmpfr_flags == 0);
+
+  /* atan(1) = Pi/4 and atan(-1) = -Pi/4 */
+  mpfr_const_pi (y, MPFR_RNDN);
+  mpfr_div_2ui (y, y, 2, MPFR_RNDN);
+  mpfr_atan_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_equal_p (x, y));
+  mpq_neg (q, q);
+  mpfr_atan_q (x, q, MPFR_RNDN);
+  mpfr_neg (y, y, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_equal_p (x, y));
+
+  /* overflow and underflow of exp */
+  mpz_ui_pow_ui (mpq_numref (q), 10, 30);
+  mpz_set_ui (mpq_denref (q), 7);
+  mpfr_clear_flags ();
+  inex = mpfr_exp_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (inex > 0 && mpfr_inf_p (x) && mpfr_sgn (x) > 0);
+  MPFR_ASSERTN (__gmpfr_flags == (MPFR_FLAGS_OVERFLOW | MPFR_FLAGS_INEXACT));
+  mpq_neg (q, q);
+  mpfr_clear_flags ();
+  inex = mpfr_exp_q (x, q, MPFR_RNDN);
+  MPFR_ASSERTN (inex < 0 && mpfr_zero_p (x) && mpfr_signbit (x) == 0);
+  MPFR_ASSERTN (__gmpfr_flags == (MPFR_FLAGS_UNDERFLOW | MPFR_FLAGS_INEXACT));
+  mpfr_clear_flags ();
+  inex = mpfr_exp_q (x, q, MPFR_RNDU);
+  MPFR_ASSERTN (inex > 0 && mpfr_cmp_ui_2exp (x, 1, mpfr_get_emin () - 1)
+                == 0);
+  MPFR_ASSERTN (__gmpfr_flags == (MPFR_FLAGS_UNDERFLOW | MPFR_FLAGS_INEXACT));
+
+  mpq_clear (q);
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+/* random rational with numerator of at most nbits bits and denominator of
+   at most dbits bits */
+static void
+random_q (mpq_ptr q, unsigned long nbits, unsigned long dbits)
+{
+  mpz_urandomb (mpq_numref (q), RANDS, nbits);
+  do
+    mpz_urandomb (mpq_denref (q), RANDS, dbits);
+  while (mpz_sgn (mpq_denref (q)) == 0);
+  if (randlimb () & 1)
+    mpz_neg (mpq_numref (q), mpq_numref (q));
+  mpq_canonicalize (q);
+}
+
+static void
+random_tests (void)
+{
+  mpq_t q;
+  mpfr_prec_t prec;
+  int i, n, rnd;
+
+  mpq_init (q);
+  for (n = 0; n < 200; n++)
+    for (i = 0; i < (int) NFUNCS; i++)
+      {
+        prec = MPFR_PREC_MIN + (randlimb () % 300);
+        /* dyadic rationals */
+        random_q (q, 1 + randlimb () % 40, 1);
+        mpz_mul_2exp (mpq_denref (q), mpq_denref (q), randlimb () % 40);
+        mpq_canonicalize (q);
+        if (tab[i].fq == mpfr_log_q)
+          mpq_abs (q, q);
+        RND_LOOP (rnd)
+          check_dyadic (i, q, prec, (mpfr_rnd_t) rnd);
+        /* general rationals */
+        random_q (q, 1 + randlimb () % 30, 1 + randlimb () % 30);
+        if (mpq_sgn (q) == 0)
+          continue;
+        if (tab[i].fq == mpfr_log_q)
+          mpq_abs (q, q);
+        RND_LOOP (rnd)
+          check_rational (i, q, prec, (mpfr_rnd_t) rnd);
+      }
+  mpq_clear (q);
+}
+
+/* large precision and small rationals, or arguments for which the series
+   of log and atan converge fast, to exercise the binary splitting */
+static void
+binary_splitting (void)
+{
+  const char *near[] = { "1000001/1000000", "4097/2048", "-1/1000",
+                         "1000/999", "-2001/1", "3/8191" };
+  mpq_t q;
+  mpfr_prec_t prec;
+  int i, j, n;
+
+  mpq_init (q);
+  mpq_set_si (q, 1, 3);
+  for (i = 0; i < (int) NFUNCS; i++)
+    check_rational (i, q, 3000, MPFR_RNDN);
+  mpq_set_si (q, -1234567, 10);
+  for (i = 0; i < (int) NFUNCS; i++)
+    if (tab[i].fq != mpfr_log_q)
+      check_rational (i, q, 2000, MPFR_RNDZ);
+  mpq_set_si (q, 22, 7);
+  check_rational (3, q, 2500, MPFR_RNDN); /* sin(22/7) is small */
+  for (n = 0; n < 10; n++)
+    for (i = 0; i < (int) NFUNCS; i++)
+      {
+        prec = 2000 + (randlimb () % 1000);
+        random_q (q, 1 + randlimb () % 12, 1 + randlimb () % 12);
+        if (mpq_sgn (q) == 0)
+          continue;
+        if (tab[i].fq == mpfr_log_q)
+          mpq_abs (q, q);
+        check_rational (i, q, prec, RND_RAND ());
+      }
+  for (j = 0; j < (int) (sizeof (near) / sizeof (near[0])); j++)
+    {
+      mpq_set_str (q, near[j], 10);
+      mpq_canonicalize (q);
+      for (prec = MPFR_PREC_MIN; prec < 200; prec += 7)
+        {
+          check_rational (2, q, prec, RND_RAND ());
+          if (mpq_sgn (q) > 0)
+            check_rational (1, q, prec, RND_RAND ());
+        }
+      check_rational (2, q, 1000, RND_RAND ());
+      if (mpq_sgn (q) > 0)
+        check_rational (1, q, 1000, RND_RAND ());
+    }
+  mpq_clear (q);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  special ();
+  random_tests ();
+  binary_splitting ();
+
+  tests_end_mpfr ();
+  return 0;
+}
+
+#else
+
+int
+main (void)
+{
+  return 77;
+}
+
+#endif
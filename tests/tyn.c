@@ -22,6 +22,67 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #include "mpfr-test.h"
 
+/* Compare mpfr_yn_range with mpfr_yn, with outputs of random (different)
+   precisions. */
+static void
+test_range (void)
+{
+  mpfr_t v[50], x, z;
+  mpfr_ptr tab[50];
+  int tern[50], inex;
+  unsigned long n, i;
+  mpfr_prec_t pmax;
+  int k, rnd;
+
+  for (i = 0; i < 50; i++)
+    {
+      mpfr_init (v[i]);
+      tab[i] = v[i];
+    }
+  mpfr_init2 (x, 53);
+  mpfr_init (z);
+
+  for (k = 0; k < 16; k++)
+    {
+      /* x in [0, 2^(k-8)), n in [1, 50] */
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2si (x, x, k - 8, MPFR_RNDN);
+      n = 1 + randlimb () % 50;
+      pmax = (k % 4) ? 100 : 500;
+      for (i = 0; i < n; i++)
+        mpfr_set_prec (tab[i], MPFR_PREC_MIN + randlimb () % pmax);
+      RND_LOOP (rnd)
+        {
+          mpfr_yn_range (tab, tern, n, x, (mpfr_rnd_t) rnd);
+          for (i = 0; i < n; i++)
+            {
+              mpfr_set_prec (z, mpfr_get_prec (tab[i]));
+              inex = mpfr_yn (z, i, x, (mpfr_rnd_t) rnd);
+              if (! mpfr_equal_p (tab[i], z) || ! SAME_SIGN (inex, tern[i]))
+                {
+                  printf ("Error in mpfr_yn_range for n = %lu, i = %lu, %s\nx = ",
+                          n, i, mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+                  mpfr_dump (x);
+                  printf ("expected ");
+                  mpfr_dump (z);
+                  printf ("got      ");
+                  mpfr_dump (tab[i]);
+                  printf ("with inex = %d and %d\n", inex, tern[i]);
+                  exit (1);
+                }
+            }
+        }
+    }
+
+  /* tern may be NULL */
+  mpfr_yn_range (tab, NULL, 3, x, MPFR_RNDN);
+
+  for (i = 0; i < 50; i++)
+    mpfr_clear (v[i]);
+  mpfr_clear (x);
+  mpfr_clear (z);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -180,6 +241,8 @@ main (int argc, char *argv[])
       exit (1);
     }
 
+  test_range ();
+
  end:
   mpfr_clear (x);
   mpfr_clear (y);
@@ -226,6 +226,50 @@ interm_overflow (void)
   mpfr_clears (x, y1, y2, (mpfr_ptr) 0);
 }
 
+/* Check that the coefficients cached from one call to the next (at the same
+   working precision, possibly extended or at a different precision) give
+   the same results as a computation from scratch. */
+static void
+test_cache (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  int i, j, inex1, inex2;
+
+  mpfr_init2 (x, 64);
+  for (i = 0; i < 3; i++)
+    {
+      p = (i == 0) ? 53 : (i == 1) ? 200 : 500 + (randlimb () % 200);
+      mpfr_inits2 (p, y, z, (mpfr_ptr) 0);
+      for (j = 0; j < 4; j++)
+        {
+          /* s in [1.5, 23.5] */
+          mpfr_urandomb (x, RANDS);
+          mpfr_mul_ui (x, x, 22, MPFR_RNDN);
+          mpfr_add_ui (x, x, 1, MPFR_RNDN);
+          mpfr_add_d (x, x, 0.5, MPFR_RNDN);
+          /* y uses the coefficients cached by the previous calls */
+          inex1 = mpfr_zeta (y, x, MPFR_RNDN);
+          mpfr_free_cache ();
+          inex2 = mpfr_zeta (z, x, MPFR_RNDN);
+          if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in test_cache for prec = %lu\nx = ",
+                      (unsigned long) p);
+              mpfr_dump (x);
+              printf ("got      ");
+              mpfr_dump (y);
+              printf ("expected ");
+              mpfr_dump (z);
+              printf ("with inex = %d and %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+      mpfr_clears (y, z, (mpfr_ptr) 0);
+    }
+  mpfr_clear (x);
+}
+
 #define TEST_FUNCTION mpfr_zeta
 #define TEST_RANDOM_EMIN -48
 #define TEST_RANDOM_EMAX 31
@@ -483,6 +527,7 @@ main (int argc, char *argv[])
   test2 ();
 
   interm_overflow ();
+  test_cache ();
 
   tests_end_mpfr ();
   return 0;
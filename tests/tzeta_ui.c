@@ -24,6 +24,63 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #define TEST_FUNCTION mpfr_zeta_ui
 
+/* Compare mpfr_zeta_ui_range with mpfr_zeta_ui, with outputs of random
+   (different) precisions. */
+static void
+test_range (void)
+{
+  mpfr_t x[40], z;
+  mpfr_ptr tab[40];
+  int tern[40], inex;
+  unsigned long m, n, i;
+  mpfr_prec_t pmax;
+  int k, rnd;
+
+  for (i = 0; i < 40; i++)
+    {
+      mpfr_init (x[i]);
+      tab[i] = x[i];
+    }
+  mpfr_init (z);
+
+  for (k = 0; k < 20; k++)
+    {
+      m = randlimb () % ((k < 10) ? 4 : 100);
+      n = 1 + randlimb () % 40;
+      pmax = (k % 3) ? 150 : 1000;
+      for (i = 0; i < n; i++)
+        mpfr_set_prec (tab[i], MPFR_PREC_MIN + randlimb () % pmax);
+      RND_LOOP (rnd)
+        {
+          mpfr_zeta_ui_range (tab, tern, m, n, (mpfr_rnd_t) rnd);
+          for (i = 0; i < n; i++)
+            {
+              mpfr_set_prec (z, mpfr_get_prec (tab[i]));
+              inex = mpfr_zeta_ui (z, m + i, (mpfr_rnd_t) rnd);
+              if (! mpfr_equal_p (tab[i], z) || ! SAME_SIGN (inex, tern[i]))
+                {
+                  printf ("Error in mpfr_zeta_ui_range for m = %lu, n = %lu,"
+                          " i = %lu, %s\n", m, n, i,
+                          mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+                  printf ("expected ");
+                  mpfr_dump (z);
+                  printf ("got      ");
+                  mpfr_dump (tab[i]);
+                  printf ("with inex = %d and %d\n", inex, tern[i]);
+                  exit (1);
+                }
+            }
+        }
+    }
+
+  /* tern may be NULL */
+  mpfr_zeta_ui_range (tab, NULL, 2, 3, MPFR_RNDN);
+
+  for (i = 0; i < 40; i++)
+    mpfr_clear (x[i]);
+  mpfr_clear (z);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -194,6 +251,8 @@ main (int argc, char *argv[])
           }
     }
 
+  test_range ();
+
  clear_and_exit:
   mpfr_clear (x);
   mpfr_clear (y);
@@ -0,0 +1,124 @@
+/* Test file for mpfr_ziv_stats_enable, mpfr_ziv_stats_get and
+   mpfr_ziv_stats_reset.
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Put in *st the statistics of the loop of function name, and return 1,
+   or return 0 if there is no such loop. */
+static int
+find_stats (mpfr_ziv_stats_t *st, const char *name)
+{
+  unsigned long i;
+
+  for (i = 0; mpfr_ziv_stats_get (st, i); i++)
+    if (strcmp (st->name, name) == 0)
+      return 1;
+  return 0;
+}
+
+static void
+run_sin (int n)
+{
+  mpfr_t x, y;
+  int i;
+
+  mpfr_init2 (x, 100);
+  mpfr_init2 (y, 100);
+  for (i = 0; i < n; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2si (x, x, (i % 20) - 10, MPFR_RNDN);
+      mpfr_sin (y, x, MPFR_RNDN);
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+static void
+check_sin (void)
+{
+  mpfr_ziv_stats_t st, st2;
+  unsigned long i;
+
+  mpfr_ziv_stats_reset ();
+  if (mpfr_ziv_stats_enable (1) != 0)
+    {
+      printf ("Error, statistics should be disabled by default\n");
+      exit (1);
+    }
+  run_sin (1000);
+  if (mpfr_ziv_stats_enable (0) != 1)
+    {
+      printf ("Error, mpfr_ziv_stats_enable should return 1\n");
+      exit (1);
+    }
+
+  if (!find_stats (&st, "mpfr_sin"))
+    {
+      printf ("Error, no statistics for mpfr_sin\n");
+      exit (1);
+    }
+  if (st.calls == 0 || st.failures > st.calls || st.max_iter == 0 ||
+      st.max_prec <= 100 || (st.failures != 0) != (st.max_iter >= 2))
+    {
+      printf ("Error, inconsistent statistics for mpfr_sin:\n");
+      printf ("calls=%lu failures=%lu max_iter=%lu max_prec=%lu\n",
+              st.calls, st.failures, st.max_iter,
+              (unsigned long) st.max_prec);
+      exit (1);
+    }
+
+  /* nothing should be recorded while the statistics are disabled */
+  run_sin (100);
+  find_stats (&st2, "mpfr_sin");
+  if (st2.calls != st.calls || st2.failures != st.failures)
+    {
+      printf ("Error, statistics updated while disabled\n");
+      exit (1);
+    }
+
+  mpfr_ziv_stats_reset ();
+  for (i = 0; mpfr_ziv_stats_get (&st, i); i++)
+    if (st.calls != 0 || st.failures != 0 || st.max_iter != 0 ||
+        st.max_prec != 0)
+      {
+        printf ("Error, statistics of %s not reset\n", st.name);
+        exit (1);
+      }
+  if (mpfr_ziv_stats_get (&st, i))
+    {
+      printf ("Error, mpfr_ziv_stats_get should return 0 past the end\n");
+      exit (1);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_sin ();
+
+  tests_end_mpfr ();
+  return 0;
+}
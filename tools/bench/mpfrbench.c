@@ -22,6 +22,19 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #ifdef HAVE_GETRUSAGE
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -249,8 +262,9 @@ compute_globalscore (mpz_t globalscore, int countop, mpz_t zscore[])
   mpz_root (globalscore, globalscore, countop);
 }
 
-int
-main (void)
+/* compute and print the MPFRbench score */
+static void
+bench_score (void)
 {
   int i;
   enum egroupfunc group;
@@ -305,5 +319,1312 @@ main (void)
     }
   mpz_clear (globalscore);
   gmp_randclear (randstate);
+}
+
+/*************************************************************************
+ * Benchmark suite: time each function of the table below, for each     *
+ * precision and each input distribution, and print the results in JSON *
+ *************************************************************************/
+
+/* calling sequences of the functions of the suite */
+enum ekind
+{
+  ekind_1op,        /* f (z, x, rnd) */
+  ekind_2op,        /* f (z, x, y, rnd) */
+  ekind_3op,        /* f (z, x, y, w, rnd) */
+  ekind_2res,       /* f (z, w, x, rnd), e.g., mpfr_sin_cos */
+  ekind_lgamma,     /* f (z, &sign, x, rnd) */
+  ekind_long_op,    /* f (z, n, x, rnd), e.g., mpfr_jn */
+  ekind_op_ulong,   /* f (z, x, n, rnd), e.g., mpfr_root */
+  ekind_ulong,      /* f (z, n, rnd), e.g., mpfr_zeta_ui */
+  ekind_const,      /* f (z, rnd) after mpfr_free_cache */
+  ekind_sum,        /* mpfr_sum of n numbers */
+  ekind_get_str,    /* mpfr_get_str in base n */
+  ekind_strtofr,    /* mpfr_strtofr in base n */
+  ekind_get_d       /* mpfr_get_d */
+};
+
+/* domain of the inputs; the generated inputs are folded into it */
+enum edomain
+{
+  edomain_all,      /* any real number */
+  edomain_pos,      /* x > 0 */
+  edomain_unit,     /* -1 < x < 1 */
+  edomain_ge1,      /* x > 1 */
+  edomain_gtm1      /* x > -1 */
+};
+
+typedef int (*fun1_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*fun2_t) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*fun3_t) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_srcptr,
+                       mpfr_rnd_t);
+typedef int (*fun2res_t) (mpfr_ptr, mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*funlgamma_t) (mpfr_ptr, int *, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*funlongop_t) (mpfr_ptr, long, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*funopulong_t) (mpfr_ptr, mpfr_srcptr, unsigned long,
+                             mpfr_rnd_t);
+typedef int (*funulong_t) (mpfr_ptr, unsigned long, mpfr_rnd_t);
+typedef int (*funconst_t) (mpfr_ptr, mpfr_rnd_t);
+
+#define FUN(f) ((void (*) (void)) (f))
+
+struct suitecase
+{
+  const char *name;
+  enum ekind kind;
+  void (*func) (void);          /* cast back according to kind */
+  enum edomain domain;
+  const char *singular;         /* singular point, see suite_input */
+  long n;                       /* integer argument, if any */
+  int nohuge;                   /* non-zero to skip the huge distribution */
+};
+
+/* The "singular" distribution generates inputs near the given point:
+   a number, "pi" or "pi/2", "y" (near the second operand) or "-y" (near
+   its opposite).
+   Note: zeta is only timed on inputs larger than 1, since the computation
+   of zeta(s) for s < 1/2 fails on an overflow of doubles in the error analysis
+   at precisions above 1000 bits or so (see the FIXME in zeta.c), and
+   gamma_inc is not timed on huge inputs, where it is too slow. */
+static const struct suitecase suite[] = {
+  {"add", ekind_2op, FUN (mpfr_add), edomain_all, "-y", 0},
+  {"sub", ekind_2op, FUN (mpfr_sub), edomain_all, "y", 0},
+  {"mul", ekind_2op, FUN (mpfr_mul), edomain_all, "0", 0},
+  {"sqr", ekind_1op, FUN (mpfr_sqr), edomain_all, "0", 0},
+  {"div", ekind_2op, FUN (mpfr_div), edomain_all, "y", 0},
+  {"sqrt", ekind_1op, FUN (mpfr_sqrt), edomain_pos, "1", 0},
+  {"rec_sqrt", ekind_1op, FUN (mpfr_rec_sqrt), edomain_pos, "1", 0},
+  {"cbrt", ekind_1op, FUN (mpfr_cbrt), edomain_all, "1", 0},
+  {"root", ekind_op_ulong, FUN (mpfr_root), edomain_all, "1", 5},
+  {"fma", ekind_3op, FUN (mpfr_fma), edomain_all, "0", 0},
+  {"fms", ekind_3op, FUN (mpfr_fms), edomain_all, "0", 0},
+  {"sum", ekind_sum, NULL, edomain_all, "0", 16},
+  {"agm", ekind_2op, FUN (mpfr_agm), edomain_pos, "y", 0},
+  {"hypot", ekind_2op, FUN (mpfr_hypot), edomain_all, "0", 0},
+  {"fmod", ekind_2op, FUN (mpfr_fmod), edomain_all, "y", 0},
+  {"remainder", ekind_2op, FUN (mpfr_remainder), edomain_all, "y", 0},
+  {"exp", ekind_1op, FUN (mpfr_exp), edomain_all, "0", 0},
+  {"exp2", ekind_1op, FUN (mpfr_exp2), edomain_all, "0", 0},
+  {"exp10", ekind_1op, FUN (mpfr_exp10), edomain_all, "0", 0},
+  {"expm1", ekind_1op, FUN (mpfr_expm1), edomain_all, "0", 0},
+  {"log", ekind_1op, FUN (mpfr_log), edomain_pos, "1", 0},
+  {"log2", ekind_1op, FUN (mpfr_log2), edomain_pos, "1", 0},
+  {"log10", ekind_1op, FUN (mpfr_log10), edomain_pos, "1", 0},
+  {"log1p", ekind_1op, FUN (mpfr_log1p), edomain_gtm1, "-1", 0},
+  {"pow", ekind_2op, FUN (mpfr_pow), edomain_pos, "1", 0},
+  {"pow_ui", ekind_op_ulong, FUN (mpfr_pow_ui), edomain_all, "1", 17},
+  {"sin", ekind_1op, FUN (mpfr_sin), edomain_all, "pi", 0},
+  {"cos", ekind_1op, FUN (mpfr_cos), edomain_all, "pi/2", 0},
+  {"tan", ekind_1op, FUN (mpfr_tan), edomain_all, "pi/2", 0},
+  {"sin_cos", ekind_2res, FUN (mpfr_sin_cos), edomain_all, "pi", 0},
+  {"sec", ekind_1op, FUN (mpfr_sec), edomain_all, "pi/2", 0},
+  {"csc", ekind_1op, FUN (mpfr_csc), edomain_all, "pi", 0},
+  {"cot", ekind_1op, FUN (mpfr_cot), edomain_all, "pi/2", 0},
+  {"asin", ekind_1op, FUN (mpfr_asin), edomain_unit, "1", 0},
+  {"acos", ekind_1op, FUN (mpfr_acos), edomain_unit, "1", 0},
+  {"atan", ekind_1op, FUN (mpfr_atan), edomain_all, "0", 0},
+  {"atan2", ekind_2op, FUN (mpfr_atan2), edomain_all, "0", 0},
+  {"sinh", ekind_1op, FUN (mpfr_sinh), edomain_all, "0", 0},
+  {"cosh", ekind_1op, FUN (mpfr_cosh), edomain_all, "0", 0},
+  {"tanh", ekind_1op, FUN (mpfr_tanh), edomain_all, "0", 0},
+  {"sinh_cosh", ekind_2res, FUN (mpfr_sinh_cosh), edomain_all, "0", 0},
+  {"sech", ekind_1op, FUN (mpfr_sech), edomain_all, "0", 0},
+  {"csch", ekind_1op, FUN (mpfr_csch), edomain_all, "0", 0},
+  {"coth", ekind_1op, FUN (mpfr_coth), edomain_all, "0", 0},
+  {"asinh", ekind_1op, FUN (mpfr_asinh), edomain_all, "0", 0},
+  {"acosh", ekind_1op, FUN (mpfr_acosh), edomain_ge1, "1", 0},
+  {"atanh", ekind_1op, FUN (mpfr_atanh), edomain_unit, "1", 0},
+  {"eint", ekind_1op, FUN (mpfr_eint), edomain_all,
+   "0.37250741078136663446", 0},
+  {"li2", ekind_1op, FUN (mpfr_li2), edomain_all, "1", 0},
+  {"gamma", ekind_1op, FUN (mpfr_gamma), edomain_all, "-3", 0},
+  {"lngamma", ekind_1op, FUN (mpfr_lngamma), edomain_pos, "1", 0},
+  {"lgamma", ekind_lgamma, FUN (mpfr_lgamma), edomain_all, "2", 0},
+  {"digamma", ekind_1op, FUN (mpfr_digamma), edomain_all,
+   "1.4616321449683623413", 0},
+  {"gamma_inc", ekind_2op, FUN (mpfr_gamma_inc), edomain_pos, "y", 0, 1},
+  {"zeta", ekind_1op, FUN (mpfr_zeta), edomain_ge1, "1", 0},
+  {"zeta_ui", ekind_ulong, FUN (mpfr_zeta_ui), edomain_all, "0", 3},
+  {"erf", ekind_1op, FUN (mpfr_erf), edomain_all, "0", 0},
+  {"erfc", ekind_1op, FUN (mpfr_erfc), edomain_all, "0", 0},
+  {"j0", ekind_1op, FUN (mpfr_j0), edomain_all, "2.4048255576957727686", 0},
+  {"j1", ekind_1op, FUN (mpfr_j1), edomain_all, "3.8317059702075123156", 0},
+  {"jn", ekind_long_op, FUN (mpfr_jn), edomain_all, "0", 5},
+  {"y0", ekind_1op, FUN (mpfr_y0), edomain_pos, "0.89357696627916752158", 0},
+  {"y1", ekind_1op, FUN (mpfr_y1), edomain_pos, "2.1971413260310170351", 0},
+  {"yn", ekind_long_op, FUN (mpfr_yn), edomain_pos, "0", 5},
+  {"ai", ekind_1op, FUN (mpfr_ai), edomain_all, "-2.3381074104597670385", 0},
+  {"const_pi", ekind_const, FUN (mpfr_const_pi), edomain_all, "0", 0},
+  {"const_log2", ekind_const, FUN (mpfr_const_log2), edomain_all, "0", 0},
+  {"const_euler", ekind_const, FUN (mpfr_const_euler), edomain_all, "0", 0},
+  {"const_catalan", ekind_const, FUN (mpfr_const_catalan), edomain_all,
+   "0", 0},
+  {"get_str", ekind_get_str, NULL, edomain_all, "0", 10},
+  {"strtofr", ekind_strtofr, NULL, edomain_all, "0", 10},
+  {"get_d", ekind_get_d, NULL, edomain_all, "0", 0}
+};
+
+#define SUITE_SIZE ((int) (sizeof (suite) / sizeof (suite[0])))
+
+/* names of the input distributions, see suite_input */
+static const char *const distname[] = { "random", "singular", "huge" };
+
+#define NB_DIST ((int) (sizeof (distname) / sizeof (distname[0])))
+
+/* number of different inputs of each operand, used cyclically */
+#define NB_SUITE_INPUTS 128
+
+/* inputs of one case of the suite */
+struct suiteinputs
+{
+  mpfr_t x[NB_SUITE_INPUTS], y[NB_SUITE_INPUTS], w[NB_SUITE_INPUTS];
+  mpfr_ptr px[NB_SUITE_INPUTS + 64]; /* for mpfr_sum */
+  char *str[NB_SUITE_INPUTS];        /* for mpfr_strtofr */
+  char *buf;                         /* for mpfr_get_str */
+  mpfr_t z, z2;                      /* outputs */
+  int free_cache;                    /* see ekind_const in suite_run */
+};
+
+/* Set x to u * 2^e, where u is uniformly distributed in [-1,1) and e is
+   uniformly distributed in [emin,emax], or in [-emax,-emin] with
+   probability 1/2 if neg is non-zero. */
+static void
+suite_random (mpfr_ptr x, long emin, long emax, int neg,
+              gmp_randstate_t randstate)
+{
+  long e;
+
+  e = emin + (long) gmp_urandomm_ui (randstate, emax - emin + 1);
+  if (neg && gmp_urandomb_ui (randstate, 1))
+    e = -e;
+  mpfr_urandomb (x, randstate);
+  mpfr_mul_2ui (x, x, 1, MPFR_RNDN);
+  mpfr_sub_ui (x, x, 1, MPFR_RNDN);
+  mpfr_mul_2si (x, x, e, MPFR_RNDN);
+}
+
+/* Fold x into the domain d. */
+static void
+suite_fold (mpfr_ptr x, enum edomain d)
+{
+  if (mpfr_zero_p (x))
+    mpfr_set_ui_2exp (x, 1, -1, MPFR_RNDN);
+  switch (d)
+    {
+    case edomain_all:
+      break;
+    case edomain_pos:
+      mpfr_abs (x, x, MPFR_RNDN);
+      break;
+    case edomain_unit:
+      /* |x| >= 1 if and only if its exponent is positive */
+      if (mpfr_get_exp (x) > 0)
+        mpfr_ui_div (x, 1, x, MPFR_RNDZ);
+      if (mpfr_get_exp (x) > 0)
+        mpfr_div_2ui (x, x, 1, MPFR_RNDN);
+      break;
+    case edomain_ge1:
+      mpfr_abs (x, x, MPFR_RNDN);
+      if (mpfr_cmp_ui (x, 1) <= 0)
+        mpfr_ui_div (x, 1, x, MPFR_RNDU);
+      if (mpfr_cmp_ui (x, 1) <= 0)
+        mpfr_nextabove (x);
+      break;
+    case edomain_gtm1:
+      /* reflect around -1 */
+      if (mpfr_cmp_si (x, -1) <= 0)
+        {
+          mpfr_add_ui (x, x, 2, MPFR_RNDN);
+          mpfr_neg (x, x, MPFR_RNDN);
+        }
+      if (mpfr_cmp_si (x, -1) <= 0)
+        mpfr_nextabove (x);
+      break;
+    }
+}
+
+/* Set x to an input of case c for the distribution dist, where y is
+   the other operand, if any:
+   - random: |x| < 16, with a uniformly distributed significand;
+   - singular: x = s + d, where s is the singular point of c, and
+     d = u * 2^(-e), u being uniformly distributed in [-1,1) and e in
+     [1,p], so that all the distances to s have the same probability;
+   - huge: 2^64 <= |x| < 2^1024 or 2^(-1024) <= |x| < 2^(-64).
+   The result is folded into the domain of c. */
+static void
+suite_input (mpfr_ptr x, const struct suitecase *c, int dist,
+             mpfr_srcptr y, gmp_randstate_t randstate)
+{
+  mpfr_prec_t p = mpfr_get_prec (x);
+
+  if (dist == 0)
+    suite_random (x, -4, 4, 0, randstate);
+  else if (dist == 2)
+    suite_random (x, 64, 1024, 1, randstate);
+  else
+    {
+      const char *s = c->singular;
+      mpfr_t d;
+
+      mpfr_init2 (d, p);
+      suite_random (d, -p, -1, 0, randstate);
+      if ((strcmp (s, "y") == 0 || strcmp (s, "-y") == 0) && y != NULL)
+        {
+          mpfr_mul (d, d, y, MPFR_RNDN);
+          mpfr_add (x, y, d, MPFR_RNDN);
+          if (s[0] == '-')
+            mpfr_neg (x, x, MPFR_RNDN);
+        }
+      else
+        {
+          if (strncmp (s, "pi", 2) == 0)
+            {
+              mpfr_const_pi (x, MPFR_RNDN);
+              if (s[2] == '/')
+                mpfr_div_2ui (x, x, 1, MPFR_RNDN);
+            }
+          else if (s[0] == 'y' || s[1] == 'y')
+            mpfr_set_ui (x, 0, MPFR_RNDN);
+          else
+            mpfr_set_str (x, s, 10, MPFR_RNDN);
+          mpfr_add (x, x, d, MPFR_RNDN);
+        }
+      mpfr_clear (d);
+    }
+  suite_fold (x, c->domain);
+}
+
+static void
+suite_init_inputs (struct suiteinputs *in, const struct suitecase *c,
+                   mpfr_prec_t p, int dist, gmp_randstate_t randstate)
+{
+  int i;
+
+  for (i = 0; i < NB_SUITE_INPUTS; i++)
+    {
+      mpfr_init2 (in->y[i], p);
+      mpfr_init2 (in->w[i], p);
+      mpfr_init2 (in->x[i], p);
+      /* only x follows the singular distribution */
+      suite_input (in->y[i], c, dist == 1 ? 0 : dist, NULL, randstate);
+      suite_input (in->w[i], c, dist == 1 ? 0 : dist, NULL, randstate);
+      suite_input (in->x[i], c, dist, in->y[i], randstate);
+      in->str[i] = NULL;
+      if (c->kind == ekind_strtofr)
+        mpfr_asprintf (&in->str[i], "%.*Re",
+                       (int) (1 + p * 0.30103), in->x[i]);
+    }
+  for (i = 0; i < NB_SUITE_INPUTS + 64; i++)
+    in->px[i] = in->x[i % NB_SUITE_INPUTS];
+  /* mpfr_get_str needs at most 1 + ceil(p*log10(2)) + 2 characters */
+  in->buf = (char *) malloc (p / 3 + 16);
+  if (in->buf == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  mpfr_init2 (in->z, p);
+  mpfr_init2 (in->z2, p);
+  in->free_cache = 1;
+}
+
+static void
+suite_clear_inputs (struct suiteinputs *in)
+{
+  int i;
+
+  for (i = 0; i < NB_SUITE_INPUTS; i++)
+    {
+      mpfr_clear (in->x[i]);
+      mpfr_clear (in->y[i]);
+      mpfr_clear (in->w[i]);
+      if (in->str[i] != NULL)
+        mpfr_free_str (in->str[i]);
+    }
+  free (in->buf);
+  mpfr_clear (in->z);
+  mpfr_clear (in->z2);
+}
+
+static volatile double suite_sink;
+
+#define SUITE_LOOP(call)                        \
+  for (i = 0, k = 0; i < niter; i++)            \
+    {                                           \
+      call;                                     \
+      if (++k == NB_SUITE_INPUTS)               \
+        k = 0;                                  \
+    }
+
+/* do niter calls of case c */
+static void
+suite_run (const struct suitecase *c, struct suiteinputs *in,
+           unsigned long niter)
+{
+  unsigned long i;
+  int k, s;
+  mpfr_exp_t e;
+  double d = 0.0;
+
+  switch (c->kind)
+    {
+    case ekind_1op:
+      SUITE_LOOP (((fun1_t) c->func) (in->z, in->x[k], MPFR_RNDN));
+      break;
+    case ekind_2op:
+      SUITE_LOOP (((fun2_t) c->func) (in->z, in->x[k], in->y[k],
+                                      MPFR_RNDN));
+      break;
+    case ekind_3op:
+      SUITE_LOOP (((fun3_t) c->func) (in->z, in->x[k], in->y[k], in->w[k],
+                                      MPFR_RNDN));
+      break;
+    case ekind_2res:
+      SUITE_LOOP (((fun2res_t) c->func) (in->z, in->z2, in->x[k],
+                                         MPFR_RNDN));
+      break;
+    case ekind_lgamma:
+      SUITE_LOOP (((funlgamma_t) c->func) (in->z, &s, in->x[k], MPFR_RNDN));
+      break;
+    case ekind_long_op:
+      SUITE_LOOP (((funlongop_t) c->func) (in->z, c->n, in->x[k],
+                                           MPFR_RNDN));
+      break;
+    case ekind_op_ulong:
+      SUITE_LOOP (((funopulong_t) c->func) (in->z, in->x[k], c->n,
+                                            MPFR_RNDN));
+      break;
+    case ekind_ulong:
+      SUITE_LOOP (((funulong_t) c->func) (in->z, c->n, MPFR_RNDN));
+      break;
+    case ekind_const:
+      /* the caches are not freed when several threads are run, since the
+         global caches cannot be freed while they are used, thus the time
+         of a cache hit is measured in this case */
+      if (in->free_cache)
+        {
+          SUITE_LOOP ((mpfr_free_cache2 ((mpfr_free_cache_t)
+                                         (MPFR_FREE_LOCAL_CACHE |
+                                          MPFR_FREE_GLOBAL_CACHE)),
+                       ((funconst_t) c->func) (in->z, MPFR_RNDN)));
+        }
+      else
+        {
+          SUITE_LOOP (((funconst_t) c->func) (in->z, MPFR_RNDN));
+        }
+      break;
+    case ekind_sum:
+      SUITE_LOOP (mpfr_sum (in->z, in->px + k, c->n, MPFR_RNDN));
+      break;
+    case ekind_get_str:
+      SUITE_LOOP (mpfr_get_str (in->buf, &e, c->n, 0, in->x[k], MPFR_RNDN));
+      break;
+    case ekind_strtofr:
+      SUITE_LOOP (mpfr_strtofr (in->z, in->str[k], NULL, c->n, MPFR_RNDN));
+      break;
+    case ekind_get_d:
+      SUITE_LOOP (d += mpfr_get_d (in->x[k], MPFR_RNDN));
+      break;
+    }
+  suite_sink = d;
+}
+
+/* return the time in microseconds of niter calls of case c */
+static unsigned long
+suite_time (const struct suitecase *c, struct suiteinputs *in,
+            unsigned long niter)
+{
+  unsigned long t0;
+
+  t0 = get_cputime ();
+  suite_run (c, in, niter);
+  return get_cputime () - t0;
+}
+
+static int
+cmp_double (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* median of the n sorted values t[0..n-1] */
+static double
+median (const double *t, int n)
+{
+  return n % 2 ? t[n / 2] : (t[n / 2 - 1] + t[n / 2]) / 2;
+}
+
+/* Return the number of calls of case c such that they take about
+   sample_us microseconds; this also fills the caches. */
+static unsigned long
+suite_calibrate (const struct suitecase *c, struct suiteinputs *in,
+                 unsigned long sample_us)
+{
+  unsigned long niter, t;
+
+  for (niter = 1; ; niter *= 2)
+    {
+      t = suite_time (c, in, niter);
+      if (t >= sample_us / 4 || niter >= ULONG_MAX / 4)
+        break;
+    }
+  if (t < sample_us)
+    niter = (unsigned long) ((double) niter * sample_us / (t + 1));
+  return niter;
+}
+
+/* Hardware performance counters, read with perf_event_open on Linux.
+   The counters are per call, and they only count the user-space events
+   of the current thread. */
+static const char *const countername[] = {
+  "cycles", "instructions", "branch_misses", "cache_misses", "page_faults"
+};
+
+#define NB_COUNTERS ((int) (sizeof (countername) / sizeof (countername[0])))
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+
+static const struct { unsigned int type; unsigned long config; }
+counterevent[NB_COUNTERS] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }
+};
+
+static int counterfd[NB_COUNTERS];
+
+/* Open the counters selected by ev[], and return the number of counters
+   that could be opened; the other ones are ignored. */
+static int
+counters_open (const char *ev)
+{
+  struct perf_event_attr attr;
+  int i, n = 0;
+
+  for (i = 0; i < NB_COUNTERS; i++)
+    {
+      counterfd[i] = -1;
+      if (!ev[i])
+        continue;
+      memset (&attr, 0, sizeof (attr));
+      attr.type = counterevent[i].type;
+      attr.size = sizeof (attr);
+      attr.config = counterevent[i].config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+      counterfd[i] = syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (counterfd[i] < 0)
+        fprintf (stderr, "Can't open the %s counter: %s\n",
+                 countername[i], strerror (errno));
+      else
+        n++;
+    }
+  return n;
+}
+
+static void
+counters_start (void)
+{
+  int i;
+
+  for (i = 0; i < NB_COUNTERS; i++)
+    if (counterfd[i] >= 0)
+      {
+        ioctl (counterfd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl (counterfd[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+}
+
+/* Stop the counters and set c[i] to the value of counter i, or to -1 if
+   it is not available. If the kernel had to multiplex the counters, the
+   values are extrapolated to the whole time. */
+static void
+counters_stop (double *c)
+{
+  __u64 v[3];  /* value, time enabled, time running */
+  int i;
+
+  for (i = 0; i < NB_COUNTERS; i++)
+    {
+      c[i] = -1.0;
+      if (counterfd[i] < 0)
+        continue;
+      ioctl (counterfd[i], PERF_EVENT_IOC_DISABLE, 0);
+      if (read (counterfd[i], v, sizeof (v)) == sizeof (v) && v[2] != 0)
+        c[i] = (double) v[0] * ((double) v[1] / (double) v[2]);
+    }
+}
+
+#endif
+
+/* options of the suite */
+struct suiteoptions
+{
+  char sel[SUITE_SIZE];         /* selected functions */
+  mpfr_prec_t *prec;            /* precisions */
+  int nprec;
+  char dist[NB_DIST];           /* selected distributions */
+  int nsamples;                 /* number of samples per case */
+  unsigned long sample_us;      /* target duration of a sample */
+  int *threads;                 /* numbers of threads, see suite_threads */
+  int nthreads;
+  char events[NB_COUNTERS];     /* selected counters */
+};
+
+#ifdef HAVE_PTHREAD
+
+/* Memory accounting: the GMP memory functions are replaced by wrappers
+   that count the bytes allocated by the current thread. */
+#if defined (__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+  !defined (__STDC_NO_THREADS__)
+# define BENCH_TLS _Thread_local
+#elif defined (__GNUC__)
+# define BENCH_TLS __thread
+#endif
+
+#ifdef BENCH_TLS
+static BENCH_TLS long mem_cur, mem_peak;
+
+static void *
+bench_allocate (size_t n)
+{
+  void *p = malloc (n);
+
+  if (p == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  mem_cur += n;
+  if (mem_cur > mem_peak)
+    mem_peak = mem_cur;
+  return p;
+}
+
+static void *
+bench_reallocate (void *p, size_t old, size_t n)
+{
+  p = realloc (p, n);
+  if (p == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  mem_cur += (long) n - (long) old;
+  if (mem_cur > mem_peak)
+    mem_peak = mem_cur;
+  return p;
+}
+
+static void
+bench_free (void *p, size_t n)
+{
+  free (p);
+  mem_cur -= n;
+}
+#endif
+
+/* get the wall-clock time in microseconds */
+static double
+get_walltime (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (double) tv.tv_sec * 1e6 + (double) tv.tv_usec;
+}
+
+/* pthread_barrier_t is optional in POSIX, thus use our own barrier */
+struct suitebarrier
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  int n, count;
+  unsigned long round;
+  double time;                  /* time at which the last round ended */
+};
+
+/* Wait until all the threads have called barrier_wait, and return the
+   wall-clock time read by the last one, i.e., the time at which all the
+   threads are released, whichever thread is woken first. */
+static double
+barrier_wait (struct suitebarrier *b)
+{
+  unsigned long r;
+  double time;
+
+  pthread_mutex_lock (&b->lock);
+  r = b->round;
+  if (++b->count == b->n)
+    {
+      b->count = 0;
+      b->round++;
+      b->time = get_walltime ();
+      pthread_cond_broadcast (&b->cond);
+    }
+  else
+    while (r == b->round)
+      pthread_cond_wait (&b->cond, &b->lock);
+  /* b->time cannot change before this thread calls barrier_wait again */
+  time = b->time;
+  pthread_mutex_unlock (&b->lock);
+  return time;
+}
+
+struct suitethread
+{
+  const struct suitecase *c;
+  mpfr_prec_t p;
+  int dist, nsamples, id;
+  unsigned long niter;
+  struct suitebarrier *barrier;
+  double *wall;                 /* wall-clock time of each sample */
+  long mem_peak;                /* peak of the memory, without the inputs */
+  long mem_kept;                /* memory kept at the end, i.e., caches */
+};
+
+/* Each thread has its own inputs (the same for all threads), and all the
+   threads start each sample at the same time. A sample lasts from the
+   release of the threads to the end of the last one, as seen by the
+   barrier, so that it does not depend on when thread 0 is scheduled. */
+static void *
+suite_thread (void *arg)
+{
+  struct suitethread *t = (struct suitethread *) arg;
+  struct suiteinputs in;
+  gmp_randstate_t randstate;
+  double t0, t1;
+  long base = 0, inputs = 0;
+  int s;
+
+#ifdef BENCH_TLS
+  base = mem_cur;
+#endif
+  gmp_randinit_default (randstate);
+  gmp_randseed_ui (randstate, 17);
+  suite_init_inputs (&in, t->c, t->p, t->dist, randstate);
+  in.free_cache = 0;
+#ifdef BENCH_TLS
+  inputs = mem_cur - base;
+  mem_peak = mem_cur;
+#endif
+  suite_run (t->c, &in, t->niter / 8 + 1); /* fill the caches */
+  for (s = 0; s < t->nsamples; s++)
+    {
+      t0 = barrier_wait (t->barrier);
+      suite_run (t->c, &in, t->niter);
+      t1 = barrier_wait (t->barrier);
+      if (t->id == 0)
+        t->wall[s] = t1 - t0;
+    }
+  suite_clear_inputs (&in);
+  gmp_randclear (randstate);
+#ifdef BENCH_TLS
+  t->mem_peak = mem_peak - base - inputs;
+  t->mem_kept = mem_cur - base;
+#endif
+  mpfr_free_cache ();
+  return NULL;
+}
+
+/* Run case c on k threads, each doing niter calls per sample, and print
+   the median and extrema over the samples of the throughput (calls per
+   second of all threads together), the scaling efficiency with respect to the throughput ref on one thread, and the
+   maximal memory per thread. Return ref, which is set to the throughput
+   if k = 1. */
+static double
+suite_threads (const struct suitecase *c, mpfr_prec_t p, int dist,
+               unsigned long niter, double ref, int k,
+               const struct suiteoptions *opt)
+{
+  pthread_t *tid;
+  struct suitethread *t;
+  struct suitebarrier b;
+  double *wall, r;
+  long peak = 0, kept = 0;
+  int i, n = opt->nsamples;
+
+  tid = (pthread_t *) malloc (k * sizeof (pthread_t));
+  t = (struct suitethread *) malloc (k * sizeof (struct suitethread));
+  wall = (double *) malloc (n * sizeof (double));
+  if (tid == NULL || t == NULL || wall == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  pthread_mutex_init (&b.lock, NULL);
+  pthread_cond_init (&b.cond, NULL);
+  b.n = k;
+  b.count = 0;
+  b.round = 0;
+  b.time = 0.0;
+  for (i = 0; i < k; i++)
+    {
+      t[i].c = c;
+      t[i].p = p;
+      t[i].dist = dist;
+      t[i].nsamples = n;
+      t[i].id = i;
+      t[i].niter = niter;
+      t[i].barrier = &b;
+      t[i].wall = wall;
+      t[i].mem_peak = t[i].mem_kept = 0;
+      if (pthread_create (tid + i, NULL, suite_thread, t + i) != 0)
+        {
+          fprintf (stderr, "Can't create thread %d\n", i);
+          exit (1);
+        }
+    }
+  for (i = 0; i < k; i++)
+    {
+      pthread_join (tid[i], NULL);
+      if (t[i].mem_peak > peak)
+        peak = t[i].mem_peak;
+      if (t[i].mem_kept > kept)
+        kept = t[i].mem_kept;
+    }
+  pthread_cond_destroy (&b.cond);
+  pthread_mutex_destroy (&b.lock);
+
+  /* throughput of each sample */
+  for (i = 0; i < n; i++)
+    wall[i] = 1e6 * (double) k * (double) niter / (wall[i] + 1e-3);
+  qsort (wall, n, sizeof (double), cmp_double);
+  r = median (wall, n);
+  if (k == 1)
+    ref = r;
+  printf (",\n    {\"func\": \"%s\", \"prec\": %lu, \"dist\": \"%s\", "
+          "\"threads\": %d, \"iter\": %lu, \"ops_per_s\": %.0f, "
+          "\"min_ops_per_s\": %.0f, \"max_ops_per_s\": %.0f, "
+          "\"efficiency\": %.3f", c->name, (unsigned long) p,
+          distname[dist], k, niter, r, wall[0], wall[n - 1],
+          r / (ref * k));
+#ifdef BENCH_TLS
+  printf (", \"mem_peak_bytes\": %ld, \"mem_kept_bytes\": %ld", peak, kept);
+#endif
+  printf ("}");
+  fflush (stdout);
+
+  free (tid);
+  free (t);
+  free (wall);
+  return ref;
+}
+
+#endif
+
+/* Time case c at precision p for the distribution dist: the number of
+   calls per sample is chosen so that a sample takes about
+   opt->sample_us, then the median, extrema and median absolute deviation
+   of the time per call over opt->nsamples samples are printed. */
+static void
+suite_case (const struct suitecase *c, mpfr_prec_t p, int dist,
+            const struct suiteoptions *opt, gmp_randstate_t randstate,
+            int first)
+{
+  struct suiteinputs in;
+  unsigned long niter;
+  double *ns, *dev, med, mad;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  double cnt[NB_COUNTERS];
+#endif
+#ifdef HAVE_PTHREAD
+  double ref;
+#endif
+  int i;
+
+  /* the inputs only depend on the case, not on the selected cases */
+  gmp_randseed_ui (randstate, 17);
+  suite_init_inputs (&in, c, p, dist, randstate);
+
+  niter = suite_calibrate (c, &in, opt->sample_us);
+
+  ns = (double *) malloc (2 * opt->nsamples * sizeof (double));
+  if (ns == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  dev = ns + opt->nsamples;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  counters_start ();
+#endif
+  for (i = 0; i < opt->nsamples; i++)
+    ns[i] = 1e3 * (double) suite_time (c, &in, niter) / (double) niter;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  counters_stop (cnt);
+#endif
+  qsort (ns, opt->nsamples, sizeof (double), cmp_double);
+  med = median (ns, opt->nsamples);
+  for (i = 0; i < opt->nsamples; i++)
+    dev[i] = ns[i] >= med ? ns[i] - med : med - ns[i];
+  qsort (dev, opt->nsamples, sizeof (double), cmp_double);
+  mad = median (dev, opt->nsamples);
+
+  /* keep one case per line, see suite_compare */
+  printf ("%s\n    {\"func\": \"%s\", \"prec\": %lu, \"dist\": \"%s\", "
+          "\"iter\": %lu, \"median_ns\": %.2f, \"min_ns\": %.2f, "
+          "\"max_ns\": %.2f, \"mad_ns\": %.2f", first ? "" : ",",
+          c->name, (unsigned long) p, distname[dist], niter, med, ns[0],
+          ns[opt->nsamples - 1], mad);
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  /* the counters are given per call, and ipc is instructions per cycle */
+  for (i = 0; i < NB_COUNTERS; i++)
+    if (opt->events[i])
+      {
+        if (cnt[i] < 0.0)
+          printf (", \"%s\": null", countername[i]);
+        else
+          printf (", \"%s\": %.2f", countername[i],
+                  cnt[i] / ((double) opt->nsamples * (double) niter));
+      }
+  if (opt->events[0] && opt->events[1])
+    {
+      if (cnt[0] > 0.0 && cnt[1] >= 0.0)
+        printf (", \"ipc\": %.3f", cnt[1] / cnt[0]);
+      else
+        printf (", \"ipc\": null");
+    }
+#endif
+  printf ("}");
+  fflush (stdout);
+
+  free (ns);
+
+#ifdef HAVE_PTHREAD
+  if (opt->nthreads != 0 && c->kind == ekind_const)
+    {
+      /* the threads do not free the caches, see suite_run */
+      in.free_cache = 0;
+      niter = suite_calibrate (c, &in, opt->sample_us);
+    }
+  /* opt->threads[0] = 1 (see main), thus ref is set by the first call */
+  for (i = 0, ref = 0.0; i < opt->nthreads; i++)
+    ref = suite_threads (c, p, dist, niter, ref, opt->threads[i], opt);
+#endif
+
+  suite_clear_inputs (&in);
+}
+
+/* print s as a JSON string */
+static void
+json_string (const char *s)
+{
+  putchar ('"');
+  for (; *s != '\0'; s++)
+    if (*s == '"' || *s == '\\')
+      printf ("\\%c", *s);
+    else if ((unsigned char) *s < 0x20)
+      printf ("\\u%04x", (unsigned int) (unsigned char) *s);
+    else
+      putchar (*s);
+  putchar ('"');
+}
+
+static void
+bench_suite (const struct suiteoptions *opt)
+{
+  gmp_randstate_t randstate;
+  int i, j, d, first = 1;
+
+  gmp_randinit_default (randstate);
+
+  printf ("{\n  \"mpfr\": ");
+  json_string (mpfr_get_version ());
+  printf (",\n  \"gmp\": ");
+  json_string (gmp_version);
+#ifdef __GMP_CC
+  printf (",\n  \"cc\": ");
+  json_string (__GMP_CC);
+#endif
+#ifdef __GMP_CFLAGS
+  printf (",\n  \"cflags\": ");
+  json_string (__GMP_CFLAGS);
+#endif
+  printf (",\n  \"shared_cache\": %s",
+          mpfr_buildopt_sharedcache_p () ? "true" : "false");
+  if (memchr (opt->events, 1, NB_COUNTERS) != NULL)
+    {
+      printf (",\n  \"counters\": [");
+      for (i = 0, j = 0; i < NB_COUNTERS; i++)
+        if (opt->events[i])
+          printf ("%s\"%s\"", j++ == 0 ? "" : ", ", countername[i]);
+      printf ("]");
+    }
+  if (opt->nthreads != 0)
+    {
+      printf (",\n  \"threads\": [");
+      for (i = 0; i < opt->nthreads; i++)
+        printf ("%s%d", i == 0 ? "" : ", ", opt->threads[i]);
+      printf ("]");
+    }
+  printf (",\n  \"samples\": %d,\n  \"sample_us\": %lu,\n  \"results\": [",
+          opt->nsamples, opt->sample_us);
+
+  for (i = 0; i < SUITE_SIZE; i++)
+    if (opt->sel[i])
+      for (j = 0; j < opt->nprec; j++)
+        for (d = 0; d < NB_DIST; d++)
+          if (opt->dist[d] && !(d == 2 && suite[i].nohuge))
+            {
+              suite_case (suite + i, opt->prec[j], d, opt, randstate, first);
+              first = 0;
+            }
+  printf ("\n  ]\n}\n");
+  gmp_randclear (randstate);
+}
+
+/* one result read by suite_compare */
+struct suiteresult
+{
+  char func[32], dist[16];
+  unsigned long prec;
+  double median, mad;
+};
+
+/* Read the results of the JSON file written by the suite. */
+static struct suiteresult *
+suite_read (const char *name, int *n)
+{
+  FILE *f;
+  char line[1024];
+  struct suiteresult *r = NULL, cur;
+  int alloc = 0;
+  unsigned long iter;
+  double mn, mx;
+
+  f = fopen (name, "r");
+  if (f == NULL)
+    {
+      perror (name);
+      exit (1);
+    }
+  *n = 0;
+  while (fgets (line, sizeof (line), f) != NULL)
+    {
+      if (sscanf (line, " {\"func\": \"%31[^\"]\", \"prec\": %lu, "
+                  "\"dist\": \"%15[^\"]\", \"iter\": %lu, \"median_ns\": %lf, "
+                  "\"min_ns\": %lf, \"max_ns\": %lf, \"mad_ns\": %lf",
+                  cur.func, &cur.prec, cur.dist, &iter, &cur.median, &mn, &mx,
+                  &cur.mad) != 8)
+        continue;
+      if (*n == alloc)
+        {
+          alloc = alloc == 0 ? 256 : 2 * alloc;
+          r = (struct suiteresult *) realloc (r, alloc * sizeof (*r));
+          if (r == NULL)
+            {
+              fprintf (stderr, "Can't allocate memory\n");
+              exit (1);
+            }
+        }
+      r[(*n)++] = cur;
+    }
+  fclose (f);
+  return r;
+}
+
+/* Compare the results of two runs of the suite, and print the cases
+   whose median changed by more than pct percent and by more than twice
+   the sum of the median absolute deviations. Return the number of such
+   cases that became slower. */
+static int
+suite_compare (const char *oldname, const char *newname, double pct)
+{
+  struct suiteresult *a, *b;
+  int na, nb, i, j, slower = 0;
+
+  a = suite_read (oldname, &na);
+  b = suite_read (newname, &nb);
+  printf ("%-14s %7s %-8s %12s %12s %8s\n", "function", "prec", "dist",
+          "old (ns)", "new (ns)", "change");
+  for (j = 0; j < nb; j++)
+    {
+      double r;
+
+      for (i = 0; i < na && (strcmp (a[i].func, b[j].func) != 0 ||
+                             a[i].prec != b[j].prec ||
+                             strcmp (a[i].dist, b[j].dist) != 0); i++);
+      if (i == na || a[i].median <= 0.0)
+        continue;
+      r = 100.0 * (b[j].median - a[i].median) / a[i].median;
+      if ((r > pct || r < -pct) &&
+          (b[j].median > a[i].median ? b[j].median - a[i].median :
+           a[i].median - b[j].median) > 2.0 * (a[i].mad + b[j].mad))
+        {
+          printf ("%-14s %7lu %-8s %12.2f %12.2f %+7.1f%%\n", b[j].func,
+                  b[j].prec, b[j].dist, a[i].median, b[j].median, r);
+          slower += r > 0;
+        }
+    }
+  free (a);
+  free (b);
+  return slower;
+}
+
+static void
+usage (const char *progname)
+{
+  fprintf (stderr, "Usage: %s\n"
+           "   or: %s -s [-f func,...] [-p prec,...] [-d dist,...]"
+           " [-n samples] [-m ms]\n"
+           "          [-t threads,...] [-e counter,...]\n"
+           "   or: %s -c old.json new.json [percent]\n"
+           "   or: %s -l\n", progname, progname, progname, progname);
+  exit (1);
+}
+
+/* Parse the comma-separated list s, calling f on each element. */
+static void
+parse_list (const char *s, void (*f) (const char *, void *), void *data)
+{
+  char item[64];
+
+  while (*s != '\0')
+    {
+      size_t l = strcspn (s, ",");
+
+      if (l >= sizeof (item))
+        l = sizeof (item) - 1;
+      memcpy (item, s, l);
+      item[l] = '\0';
+      f (item, data);
+      s += l;
+      if (*s == ',')
+        s++;
+    }
+}
+
+static void
+select_func (const char *name, void *data)
+{
+  struct suiteoptions *opt = (struct suiteoptions *) data;
+  int i;
+
+  if (strcmp (name, "all") == 0)
+    {
+      memset (opt->sel, 1, SUITE_SIZE);
+      return;
+    }
+  for (i = 0; i < SUITE_SIZE && strcmp (name, suite[i].name) != 0; i++);
+  if (i == SUITE_SIZE)
+    {
+      fprintf (stderr, "Unknown function %s (see -l)\n", name);
+      exit (1);
+    }
+  opt->sel[i] = 1;
+}
+
+static void
+select_dist (const char *name, void *data)
+{
+  struct suiteoptions *opt = (struct suiteoptions *) data;
+  int i;
+
+  if (strcmp (name, "all") == 0)
+    {
+      memset (opt->dist, 1, NB_DIST);
+      return;
+    }
+  for (i = 0; i < NB_DIST && strcmp (name, distname[i]) != 0; i++);
+  if (i == NB_DIST)
+    {
+      fprintf (stderr, "Unknown distribution %s\n", name);
+      exit (1);
+    }
+  opt->dist[i] = 1;
+}
+
+static void
+select_event (const char *name, void *data)
+{
+  struct suiteoptions *opt = (struct suiteoptions *) data;
+  int i;
+
+  if (strcmp (name, "all") == 0)
+    {
+      memset (opt->events, 1, NB_COUNTERS);
+      return;
+    }
+  for (i = 0; i < NB_COUNTERS && strcmp (name, countername[i]) != 0; i++);
+  if (i == NB_COUNTERS)
+    {
+      fprintf (stderr, "Unknown counter %s\n", name);
+      exit (1);
+    }
+  opt->events[i] = 1;
+}
+
+static void
+add_prec (struct suiteoptions *opt, long p)
+{
+  if (p < MPFR_PREC_MIN || p > 100000000)
+    {
+      fprintf (stderr, "Invalid precision %ld\n", p);
+      exit (1);
+    }
+  opt->prec = (mpfr_prec_t *)
+    realloc (opt->prec, (opt->nprec + 1) * sizeof (mpfr_prec_t));
+  if (opt->prec == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  opt->prec[opt->nprec++] = p;
+}
+
+/* p adds precision p, and p:q adds p, 2p, 4p, ... up to q */
+static void
+select_prec (const char *s, void *data)
+{
+  struct suiteoptions *opt = (struct suiteoptions *) data;
+  long p, q;
+  char c;
+
+  if (sscanf (s, "%ld:%ld%c", &p, &q, &c) == 2)
+    for (add_prec (opt, p); 2 * p <= q; )
+      add_prec (opt, p *= 2);
+  else if (sscanf (s, "%ld%c", &p, &c) == 1)
+    add_prec (opt, p);
+  else
+    {
+      fprintf (stderr, "Invalid precision %s\n", s);
+      exit (1);
+    }
+}
+
+static void
+add_threads (struct suiteoptions *opt, long k)
+{
+  if (k < 1 || k > 1024)
+    {
+      fprintf (stderr, "Invalid number of threads %ld\n", k);
+      exit (1);
+    }
+  opt->threads = (int *)
+    realloc (opt->threads, (opt->nthreads + 1) * sizeof (int));
+  if (opt->threads == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+  opt->threads[opt->nthreads++] = k;
+}
+
+/* like select_prec, for the numbers of threads */
+static void
+select_threads (const char *s, void *data)
+{
+  struct suiteoptions *opt = (struct suiteoptions *) data;
+  long k, q;
+  char c;
+
+  if (sscanf (s, "%ld:%ld%c", &k, &q, &c) == 2)
+    for (add_threads (opt, k); 2 * k <= q; )
+      add_threads (opt, k *= 2);
+  else if (sscanf (s, "%ld%c", &k, &c) == 1)
+    add_threads (opt, k);
+  else
+    {
+      fprintf (stderr, "Invalid number of threads %s\n", s);
+      exit (1);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct suiteoptions opt;
+  int i;
+
+  if (argc == 1)
+    {
+      bench_score ();
+      return 0;
+    }
+  if (strcmp (argv[1], "-l") == 0 && argc == 2)
+    {
+      for (i = 0; i < SUITE_SIZE; i++)
+        printf ("%s\n", suite[i].name);
+      return 0;
+    }
+  if (strcmp (argv[1], "-c") == 0 && (argc == 4 || argc == 5))
+    return suite_compare (argv[2], argv[3],
+                          argc == 5 ? atof (argv[4]) : 5.0) != 0;
+  if (strcmp (argv[1], "-s") != 0)
+    usage (argv[0]);
+
+  memset (&opt, 0, sizeof (opt));
+  opt.nsamples = 7;
+  opt.sample_us = 20000;
+  for (i = 2; i < argc; i += 2)
+    {
+      if (i + 1 == argc)
+        usage (argv[0]);
+      if (strcmp (argv[i], "-f") == 0)
+        parse_list (argv[i + 1], select_func, &opt);
+      else if (strcmp (argv[i], "-p") == 0)
+        parse_list (argv[i + 1], select_prec, &opt);
+      else if (strcmp (argv[i], "-d") == 0)
+        parse_list (argv[i + 1], select_dist, &opt);
+      else if (strcmp (argv[i], "-n") == 0)
+        opt.nsamples = atoi (argv[i + 1]);
+      else if (strcmp (argv[i], "-m") == 0)
+        opt.sample_us = 1000 * strtoul (argv[i + 1], NULL, 10);
+      else if (strcmp (argv[i], "-t") == 0)
+        parse_list (argv[i + 1], select_threads, &opt);
+      else if (strcmp (argv[i], "-e") == 0)
+        parse_list (argv[i + 1], select_event, &opt);
+      else
+        usage (argv[0]);
+    }
+  if (opt.nsamples <= 0 || opt.sample_us == 0)
+    usage (argv[0]);
+  if (memchr (opt.sel, 1, SUITE_SIZE) == NULL)
+    memset (opt.sel, 1, SUITE_SIZE);
+  if (memchr (opt.dist, 1, NB_DIST) == NULL)
+    memset (opt.dist, 1, NB_DIST);
+  if (opt.nprec == 0)
+    parse_list ("53,113,256,1024,4096", select_prec, &opt);
+
+  if (opt.nthreads != 0)
+    {
+      /* the first run is on one thread, as a reference for the others */
+      for (i = 0; i < opt.nthreads && opt.threads[i] != 1; i++);
+      if (i == opt.nthreads)
+        add_threads (&opt, 1);
+      opt.threads[i] = opt.threads[0];
+      opt.threads[0] = 1;
+#ifdef HAVE_PTHREAD
+# ifdef BENCH_TLS
+      mp_set_memory_functions (bench_allocate, bench_reallocate, bench_free);
+# endif
+#else
+      fprintf (stderr, "Threads are not supported\n");
+      exit (1);
+#endif
+    }
+
+  if (memchr (opt.events, 1, NB_COUNTERS) != NULL)
+    {
+#ifdef HAVE_LINUX_PERF_EVENT_H
+      if (counters_open (opt.events) == 0)
+        memset (opt.events, 0, NB_COUNTERS);
+#else
+      fprintf (stderr, "Performance counters are not supported\n");
+      exit (1);
+#endif
+    }
+
+  bench_suite (&opt);
+  free (opt.prec);
+  free (opt.threads);
   return 0;
 }
@@ -0,0 +1,617 @@
+/* mpfrhard.c -- latency of the MPFR functions on hard-to-round cases
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+/* Usage: mpfrhard -g func prec [count [extra]]
+      or: mpfrhard [-f func] [-n trials] file...
+      or: mpfrhard -l
+   With -g, write to the standard output count synthetic hard cases for
+   func in precision prec. Otherwise, time func on the cases of the given
+   files and on random inputs of the same precisions and exponents, and
+   print the latency percentiles in JSON. The files have the format of
+   the tests/data files, which contain hard cases for binary64. See the
+   README file. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#ifdef MPFR_HAVE_CLOCK_GETTIME
+#include <time.h>
+#ifndef CLOCK_MONOTONIC
+#define CLOCK_MONOTONIC CLOCK_REALTIME
+#endif
+#elif defined (HAVE_GETTIMEOFDAY) && defined (HAVE_SYS_TIME_H)
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+#include "mpfr.h"
+
+typedef int (*hardfunc_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+/* y = x^(11/4), as in tests/tpow.c for data/pow275 */
+static int
+pow275 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  mpfr_t z;
+  int inex;
+
+  mpfr_init2 (z, 4);
+  mpfr_set_ui_2exp (z, 11, -2, MPFR_RNDN);
+  inex = mpfr_pow (y, x, z, rnd);
+  mpfr_clear (z);
+  return inex;
+}
+
+/* inverse of pow275: y = (x^4)^(1/11), where x^4 is exact */
+static int
+pow275_inv (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  mpfr_t z;
+  int inex;
+
+  mpfr_init2 (z, 4 * mpfr_get_prec (x));
+  mpfr_pow_ui (z, x, 4, MPFR_RNDN);
+  inex = mpfr_root (y, z, 11, rnd);
+  mpfr_clear (z);
+  return inex;
+}
+
+/* y = x^3 */
+static int
+cube (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  return mpfr_pow_ui (y, x, 3, rnd);
+}
+
+/* inverse of rec_sqrt: y = 1/x^2 (only used with rounding to nearest,
+   the double rounding does not matter for the generation) */
+static int
+rec_sqrt_inv (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  mpfr_sqr (y, x, rnd);
+  return mpfr_ui_div (y, 1, y, rnd);
+}
+
+static int
+lgamma1 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  int sign;
+
+  return mpfr_lgamma (y, &sign, x, rnd);
+}
+
+/* For the generation of hard cases, y is chosen with the sign pos (1 for
+   positive only, 0 for both signs) and an exponent in [emin,emax], such
+   that func(inv(y)) = y. The functions without inverse can only be timed
+   on existing files (from tests/data). */
+struct hardfunc
+{
+  const char *name;
+  hardfunc_t func;
+  hardfunc_t inv;
+  int pos;
+  long emin, emax;
+};
+
+static const struct hardfunc hardfuncs[] = {
+  { "exp",      mpfr_exp,      mpfr_log,     1, -32, 32 },
+  { "exp2",     mpfr_exp2,     mpfr_log2,    1, -32, 32 },
+  { "exp10",    mpfr_exp10,    mpfr_log10,   1, -32, 32 },
+  { "expm1",    mpfr_expm1,    mpfr_log1p,   1, -32, 32 },
+  { "log",      mpfr_log,      mpfr_exp,     0, -16, 5 },
+  { "log2",     mpfr_log2,     mpfr_exp2,    0, -16, 5 },
+  { "log10",    mpfr_log10,    mpfr_exp10,   0, -16, 5 },
+  { "log1p",    mpfr_log1p,    mpfr_expm1,   0, -16, 5 },
+  { "sin",      mpfr_sin,      mpfr_asin,    0, -16, 0 },
+  { "cos",      mpfr_cos,      mpfr_acos,    0, -16, 0 },
+  { "tan",      mpfr_tan,      mpfr_atan,    0, -16, 16 },
+  { "asin",     mpfr_asin,     mpfr_sin,     0, -16, 0 },
+  { "acos",     mpfr_acos,     mpfr_cos,     1, -16, 1 },
+  { "atan",     mpfr_atan,     mpfr_tan,     0, -16, 0 },
+  { "sinh",     mpfr_sinh,     mpfr_asinh,   0, -16, 16 },
+  { "cosh",     mpfr_cosh,     mpfr_acosh,   1, 1, 16 },
+  { "tanh",     mpfr_tanh,     mpfr_atanh,   0, -16, 0 },
+  { "asinh",    mpfr_asinh,    mpfr_sinh,    0, -16, 5 },
+  { "acosh",    mpfr_acosh,    mpfr_cosh,    1, -16, 5 },
+  { "atanh",    mpfr_atanh,    mpfr_tanh,    0, -16, 3 },
+  { "cbrt",     mpfr_cbrt,     cube,         0, -32, 32 },
+  { "rec_sqrt", mpfr_rec_sqrt, rec_sqrt_inv, 1, -32, 32 },
+  { "pow275",   pow275,        pow275_inv,   1, -32, 32 },
+  { "erf",      mpfr_erf,      NULL,         0, 0, 0 },
+  { "erfc",     mpfr_erfc,     NULL,         0, 0, 0 },
+  { "gamma",    mpfr_gamma,    NULL,         0, 0, 0 },
+  { "lgamma",   lgamma1,       NULL,         0, 0, 0 },
+  { "digamma",  mpfr_digamma,  NULL,         0, 0, 0 },
+  { "li2",      mpfr_li2,      NULL,         0, 0, 0 },
+  { "j0",       mpfr_j0,       NULL,         0, 0, 0 },
+  { "j1",       mpfr_j1,       NULL,         0, 0, 0 },
+  { "y0",       mpfr_y0,       NULL,         0, 0, 0 },
+  { "y1",       mpfr_y1,       NULL,         0, 0, 0 }
+};
+
+#define NB_HARDFUNCS ((int) (sizeof (hardfuncs) / sizeof (hardfuncs[0])))
+
+static const struct hardfunc *
+find_func (const char *name)
+{
+  int i;
+
+  for (i = 0; i < NB_HARDFUNCS; i++)
+    if (strcmp (hardfuncs[i].name, name) == 0)
+      return hardfuncs + i;
+  return NULL;
+}
+
+/****************************************************************************
+ *                         Generation of hard cases                         *
+ ****************************************************************************/
+
+/* Set y to a random number of sign pos (see struct hardfunc) and exponent
+   in [emin,emax]. */
+static void
+random_number (mpfr_ptr y, int pos, long emin, long emax,
+               gmp_randstate_t state)
+{
+  do
+    mpfr_urandomb (y, state);
+  while (mpfr_zero_p (y));
+  mpfr_set_exp (y, emin + (long) gmp_urandomm_ui (state, emax - emin + 1));
+  if (!pos && gmp_urandomb_ui (state, 1))
+    mpfr_neg (y, y, MPFR_RNDN);
+}
+
+/* Return approximately the number of identical bits after the rounding
+   bit of f(x) in precision py, if mid is non-zero, or after its last bit
+   otherwise, i.e., minus the exponent of the distance (in ulps) between
+   f(x) and the nearest midpoint or representable number respectively.
+   Return -1 if f(x) is not a regular number and LONG_MAX if f(x) seems
+   to be exact, which can only be detected up to extra + 64 bits. */
+static long
+hardness (hardfunc_t f, mpfr_srcptr x, mpfr_prec_t py, int mid,
+          mpfr_prec_t extra)
+{
+  mpfr_t z;
+  long h;
+
+  mpfr_init2 (z, py + extra + 64);
+  f (z, x, MPFR_RNDN);
+  if (!mpfr_regular_p (z))
+    h = -1;
+  else
+    {
+      /* all the operations below are exact */
+      mpfr_abs (z, z, MPFR_RNDN);
+      mpfr_mul_2si (z, z, py - mpfr_get_exp (z), MPFR_RNDN);
+      mpfr_frac (z, z, MPFR_RNDN);
+      if (mid)
+        mpfr_sub_d (z, z, 0.5, MPFR_RNDN);
+      else if (mpfr_cmp_d (z, 0.5) > 0)
+        mpfr_ui_sub (z, 1, z, MPFR_RNDN);
+      h = mpfr_zero_p (z) ? LONG_MAX : - (long) mpfr_get_exp (z);
+    }
+  mpfr_clear (z);
+  return h;
+}
+
+/* Write count hard cases for h in precision py, with inputs of precision
+   py + extra (or py + 1 + extra), like the bad_cases function of the
+   tests: y is a random number of precision py and x = inv(y) is rounded
+   to nearest, thus f(x) is very close to y. Half of the cases are hard
+   for the directed rounding modes (the result is given for MPFR_RNDZ),
+   the other half for rounding to nearest, y being then the midpoint of
+   two numbers of precision py. Only the cases with at least extra/2
+   identical bits after the rounding bit are kept. */
+static void
+generate (const struct hardfunc *h, mpfr_prec_t py, long count,
+          mpfr_prec_t extra)
+{
+  gmp_randstate_t state;
+  mpfr_t x, y;
+  long i, k;
+
+  gmp_randinit_default (state);
+  mpfr_inits2 (py, x, y, (mpfr_ptr) 0);
+  printf ("# Hard cases for %s in precision %lu, generated by mpfrhard"
+          " (MPFR %s):\n# the inputs have %lu extra bits, and the results"
+          " at least %lu identical bits\n# after the rounding bit.\n",
+          h->name, (unsigned long) py, mpfr_get_version (),
+          (unsigned long) extra, (unsigned long) extra / 2);
+  for (i = k = 0; k < count && i < 100 * count; i++)
+    {
+      int mid = k % 2 == 0;
+      long d;
+
+      mpfr_set_prec (y, py + mid);
+      random_number (y, h->pos, h->emin, h->emax, state);
+      if (mid && mpfr_min_prec (y) <= py)
+        mpfr_nextabove (y); /* y is now a midpoint in precision py */
+      mpfr_set_prec (x, py + mid + extra);
+      mpfr_clear_flags ();
+      h->inv (x, y, MPFR_RNDN);
+      if (!mpfr_regular_p (x) || mpfr_nanflag_p () || mpfr_overflow_p ()
+          || mpfr_underflow_p ())
+        continue;
+      d = hardness (h->func, x, py, mid, extra);
+      if (d < extra / 2 || d >= extra + 48)
+        continue;
+      mpfr_set_prec (y, py);
+      h->func (y, x, mid ? MPFR_RNDN : MPFR_RNDZ);
+      mpfr_printf ("%lu %lu %c %Ra %Ra\n", (unsigned long) mpfr_get_prec (x),
+                   (unsigned long) py, mid ? 'n' : 'z', x, y);
+      k++;
+    }
+  if (k < count)
+    fprintf (stderr, "Only %ld hard cases found for %s\n", k, h->name);
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+  gmp_randclear (state);
+}
+
+/****************************************************************************
+ *                                  Timings                                 *
+ ****************************************************************************/
+
+struct hardcase
+{
+  mpfr_t x;          /* hard input */
+  mpfr_t xr;         /* random input with the same precision and exponent */
+  mpfr_prec_t prec;  /* precision of the result */
+  mpfr_rnd_t rnd;
+  double t, tr;      /* time of a call in nanoseconds */
+};
+
+/* minimal duration of a measure in nanoseconds */
+#define MIN_MEASURE_NS 10000.0
+
+/* return the current time in nanoseconds */
+static double
+get_time_ns (void)
+{
+#ifdef MPFR_HAVE_CLOCK_GETTIME
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+#elif defined (HAVE_GETTIMEOFDAY) && defined (HAVE_SYS_TIME_H)
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (double) tv.tv_sec * 1e9 + (double) tv.tv_usec * 1e3;
+#else
+  return (double) clock () * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* Read the cases of the file name, in the format of the tests/data files
+   (see the data_check function of the tests), and add them to *tab,
+   which has *n elements. The result is checked, but not stored. */
+static void
+read_cases (const char *name, hardfunc_t f, struct hardcase **tab, long *n,
+            gmp_randstate_t state)
+{
+  FILE *fp;
+  long xprec, yprec;
+  mpfr_t y, z;
+  char r;
+  int c;
+
+  fp = fopen (name, "r");
+  if (fp == NULL)
+    {
+      perror (name);
+      exit (1);
+    }
+  mpfr_inits (y, z, (mpfr_ptr) 0);
+  while (fscanf (fp, " ") != EOF && (c = getc (fp)) != EOF)
+    {
+      struct hardcase *h;
+
+      if (c == '#')
+        {
+          while ((c = getc (fp)) != EOF && c != '\n');
+          continue;
+        }
+      ungetc (c, fp);
+      if (fscanf (fp, "%ld %ld %c", &xprec, &yprec, &r) != 3 ||
+          xprec < MPFR_PREC_MIN || xprec > MPFR_PREC_MAX ||
+          yprec < MPFR_PREC_MIN || yprec > MPFR_PREC_MAX)
+        {
+          fprintf (stderr, "Corrupted line in file %s\n", name);
+          exit (1);
+        }
+      *tab = (struct hardcase *) realloc (*tab, (*n + 1) * sizeof (**tab));
+      if (*tab == NULL)
+        {
+          fprintf (stderr, "Can't allocate memory\n");
+          exit (1);
+        }
+      h = *tab + *n;
+      /* '*' (exact case) and 'Z' (hard case for the directed rounding
+         modes, see data_check) are timed in a single rounding mode */
+      h->rnd = r == 'n' || r == '*' ? MPFR_RNDN : r == 'u' ? MPFR_RNDU
+        : r == 'd' ? MPFR_RNDD : MPFR_RNDZ;
+      h->prec = yprec;
+      mpfr_init2 (h->x, xprec);
+      mpfr_init2 (h->xr, xprec);
+      mpfr_set_prec (y, yprec);
+      mpfr_set_prec (z, yprec);
+      if (mpfr_inp_str (h->x, fp, 0, MPFR_RNDN) == 0 ||
+          mpfr_inp_str (y, fp, 0, MPFR_RNDN) == 0)
+        {
+          fprintf (stderr, "Corrupted number in file %s\n", name);
+          exit (1);
+        }
+      f (z, h->x, h->rnd);
+      if (!mpfr_equal_p (y, z) && !(mpfr_nan_p (y) && mpfr_nan_p (z)))
+        mpfr_fprintf (stderr, "Warning: wrong result in file %s for"
+                      " x = %Ra\n", name, h->x);
+      /* random input of the same precision, sign and exponent */
+      if (mpfr_regular_p (h->x))
+        {
+          do
+            mpfr_urandomb (h->xr, state);
+          while (mpfr_zero_p (h->xr));
+          mpfr_set_exp (h->xr, mpfr_get_exp (h->x));
+          mpfr_setsign (h->xr, h->xr, mpfr_signbit (h->x), MPFR_RNDN);
+        }
+      else
+        mpfr_set (h->xr, h->x, MPFR_RNDN);
+      (*n)++;
+    }
+  mpfr_clears (y, z, (mpfr_ptr) 0);
+  fclose (fp);
+}
+
+static int
+cmp_double (const void *a, const void *b)
+{
+  double u = *(const double *) a, v = *(const double *) b;
+
+  return u < v ? -1 : u > v;
+}
+
+/* Print the percentiles of the n times in t (which is sorted), and the
+   Ziv loop statistics of the calls of f on the inputs x (random ones if
+   random is non-zero) of the n cases in c. */
+static void
+print_stats (const char *label, double *t, hardfunc_t f, mpfr_ptr z,
+             const struct hardcase *c, long n, int random)
+{
+  static const int pct[] = { 50, 90, 99 };
+  mpfr_ziv_stats_t st;
+  unsigned long i, failures = 0, max_iter = 0;
+  long j;
+  int k;
+
+  qsort (t, n, sizeof (double), cmp_double);
+  printf (",\n     \"%s\": {", label);
+  for (k = 0; k < (int) (sizeof (pct) / sizeof (pct[0])); k++)
+    {
+      /* nearest rank */
+      j = (pct[k] * n + 99) / 100 - 1;
+      printf ("\"p%d_ns\": %.2f, ", pct[k], t[j < 0 ? 0 : j]);
+    }
+  printf ("\"max_ns\": %.2f", t[n - 1]);
+
+  mpfr_ziv_stats_reset ();
+  mpfr_ziv_stats_enable (1);
+  for (j = 0; j < n; j++)
+    f (z, random ? c[j].xr : c[j].x, c[j].rnd);
+  mpfr_ziv_stats_enable (0);
+  for (i = 0; mpfr_ziv_stats_get (&st, i); i++)
+    {
+      failures += st.failures;
+      if (st.max_iter > max_iter)
+        max_iter = st.max_iter;
+    }
+  printf (", \"ziv_failures\": %.3f, \"ziv_max_iter\": %lu}",
+          (double) failures / n, max_iter);
+}
+
+/* Time f on the n cases of c, which have the same output precision. */
+static void
+time_cases (const char *fname, const char *file, hardfunc_t f,
+            struct hardcase *c, long n, int trials, int first)
+{
+  mpfr_t z;
+  double t0, *t;
+  long i, j, r, iter;
+  int k;
+
+  mpfr_init2 (z, c[0].prec);
+  t = (double *) malloc (n * sizeof (double));
+  if (t == NULL)
+    {
+      fprintf (stderr, "Can't allocate memory\n");
+      exit (1);
+    }
+
+  /* warm up (constants, etc.) and calibration */
+  for (i = 0; i < n; i++)
+    f (z, c[i].xr, c[i].rnd);
+  t0 = get_time_ns ();
+  for (i = 0; i < n; i++)
+    f (z, c[i].xr, c[i].rnd);
+  t0 = (get_time_ns () - t0) / n;
+  iter = t0 >= MIN_MEASURE_NS ? 1 : (long) (MIN_MEASURE_NS / t0) + 1;
+
+  /* The time of a case is the minimum over the trials of the time of
+     iter calls. Each trial goes over all the cases, so that a temporary
+     perturbation of the machine does not affect all the measures of a
+     case. The hard and the random inputs are timed in separate passes,
+     since the calls on an input may change the state of the caches
+     seen by the calls on the next one. */
+  for (k = 0; k < trials; k++)
+    for (j = 0; j < 2; j++)
+      for (i = 0; i < n; i++)
+        {
+          mpfr_srcptr x = j ? c[i].xr : c[i].x;
+          double d;
+
+          t0 = get_time_ns ();
+          for (r = 0; r < iter; r++)
+            f (z, x, c[i].rnd);
+          d = (get_time_ns () - t0) / iter;
+          if (j)
+            c[i].tr = k == 0 || d < c[i].tr ? d : c[i].tr;
+          else
+            c[i].t = k == 0 || d < c[i].t ? d : c[i].t;
+        }
+
+  printf ("%s\n    {\"func\": \"%s\", \"file\": \"%s\", \"prec\": %lu,"
+          " \"cases\": %ld, \"iter\": %ld", first ? "" : ",", fname, file,
+          (unsigned long) c[0].prec, n, iter);
+  for (i = 0; i < n; i++)
+    t[i] = c[i].t;
+  print_stats ("hard", t, f, z, c, n, 0);
+  for (i = 0; i < n; i++)
+    t[i] = c[i].tr;
+  print_stats ("random", t, f, z, c, n, 1);
+  printf ("}");
+
+  free (t);
+  mpfr_clear (z);
+}
+
+static int
+cmp_prec (const void *a, const void *b)
+{
+  mpfr_prec_t p = ((const struct hardcase *) a)->prec;
+  mpfr_prec_t q = ((const struct hardcase *) b)->prec;
+
+  return p < q ? -1 : p > q;
+}
+
+/* Time the cases of the given files, grouped by output precision. The
+   function is fname, or given by the name of each file up to the first
+   dot if fname is NULL (e.g., exp for tests/data/exp or exp.113). */
+static void
+bench_files (const char *fname, char **files, int nfiles, int trials)
+{
+  gmp_randstate_t state;
+  int i, first = 1;
+
+  gmp_randinit_default (state);
+  printf ("{\n  \"mpfr\": \"%s\",\n  \"gmp\": \"%s\",\n  \"trials\": %d,\n"
+          "  \"results\": [", mpfr_get_version (), gmp_version, trials);
+  for (i = 0; i < nfiles; i++)
+    {
+      const struct hardfunc *h;
+      struct hardcase *c = NULL;
+      const char *base;
+      char name[64];
+      long n = 0, j, k;
+
+      base = strrchr (files[i], '/');
+      base = base == NULL ? files[i] : base + 1;
+      if (fname == NULL)
+        {
+          size_t l = strcspn (base, ".");
+
+          if (l >= sizeof (name))
+            l = sizeof (name) - 1;
+          memcpy (name, base, l);
+          name[l] = '\0';
+        }
+      h = find_func (fname != NULL ? fname : name);
+      if (h == NULL)
+        {
+          fprintf (stderr, "Unknown function %s (see -l)\n",
+                   fname != NULL ? fname : name);
+          exit (1);
+        }
+      read_cases (files[i], h->func, &c, &n, state);
+      qsort (c, n, sizeof (struct hardcase), cmp_prec);
+      for (j = 0; j < n; j = k)
+        {
+          for (k = j + 1; k < n && c[k].prec == c[j].prec; k++);
+          time_cases (h->name, base, h->func, c + j, k - j, trials, first);
+          first = 0;
+        }
+      for (j = 0; j < n; j++)
+        mpfr_clears (c[j].x, c[j].xr, (mpfr_ptr) 0);
+      free (c);
+    }
+  printf ("\n  ]\n}\n");
+  gmp_randclear (state);
+}
+
+static void
+usage (const char *progname)
+{
+  fprintf (stderr, "Usage: %s -g func prec [count [extra]]\n"
+           "   or: %s [-f func] [-n trials] file...\n"
+           "   or: %s -l\n", progname, progname, progname);
+  exit (1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  const char *progname = argv[0], *fname = NULL;
+  int i, trials = 5;
+
+  if (argc == 2 && strcmp (argv[1], "-l") == 0)
+    {
+      for (i = 0; i < NB_HARDFUNCS; i++)
+        printf ("%s%s\n", hardfuncs[i].name,
+                hardfuncs[i].inv != NULL ? " (-g)" : "");
+      return 0;
+    }
+
+  if (argc >= 4 && strcmp (argv[1], "-g") == 0)
+    {
+      const struct hardfunc *h = find_func (argv[2]);
+      long prec = atol (argv[3]);
+      long count = argc > 4 ? atol (argv[4]) : 1000;
+      long extra = argc > 5 ? atol (argv[5]) : prec;
+
+      if (argc > 6)
+        usage (progname);
+      if (h == NULL || h->inv == NULL)
+        {
+          fprintf (stderr, "No generator for %s (see -l)\n", argv[2]);
+          exit (1);
+        }
+      if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX / 4 || count < 0
+          || extra < 2 || extra > MPFR_PREC_MAX / 4)
+        {
+          fprintf (stderr, "Invalid precision, count or extra bits\n");
+          exit (1);
+        }
+      generate (h, prec, count, extra);
+      return 0;
+    }
+
+  for (argv++, argc--; argc >= 2 && argv[0][0] == '-'; argv += 2, argc -= 2)
+    if (strcmp (argv[0], "-f") == 0)
+      fname = argv[1];
+    else if (strcmp (argv[0], "-n") == 0 && (trials = atoi (argv[1])) > 0)
+      ;
+    else
+      usage (progname);
+  if (argc == 0 || argv[0][0] == '-')
+    usage (progname);
+  bench_files (fname, argv, argc, trials);
+  mpfr_free_cache ();
+  return 0;
+}
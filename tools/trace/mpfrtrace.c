@@ -0,0 +1,239 @@
+/* mpfrtrace -- decode a binary trace written by mpfr_trace_dump
+
+Copyright 2016 Free Software Foundation, Inc.
+Contributed by the AriC and Caramba projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+/* Usage: mpfrtrace [-s] file
+   Without -s, print the events, indented by call depth.
+   With -s, print a summary per function.
+   The format is described in src/trace.c. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_ENTER 1
+#define TRACE_EXIT  2
+#define TRACE_ZIV   3
+
+#define MAX_DEPTH 256
+
+typedef struct {
+  double        time;
+  unsigned long prec;
+  unsigned int  func;
+  int           kind;
+  int           iter;
+} event_t;
+
+typedef struct {
+  unsigned long calls;      /* number of entries */
+  unsigned long timed;      /* number of matched entry/exit pairs */
+  double        total;      /* total time of the matched pairs */
+  double        max;        /* maximal time of the matched pairs */
+  unsigned long loops;      /* number of Ziv loops */
+  unsigned long failures;   /* number of failed first iterations */
+  int           max_iter;
+  unsigned long max_prec;   /* maximal working precision */
+} summary_t;
+
+static const char *progname;
+static FILE *in;
+static char **names;
+static unsigned long nnames;
+
+static void
+fail (const char *msg)
+{
+  fprintf (stderr, "%s: %s\n", progname, msg);
+  exit (1);
+}
+
+static unsigned long
+get (int n)
+{
+  unsigned char buf[4];
+  unsigned long x = 0;
+  int i;
+
+  if (fread (buf, n, 1, in) != 1)
+    fail ("truncated trace");
+  for (i = n - 1; i >= 0; i--)
+    x = (x << 8) | buf[i];
+  return x;
+}
+
+static const char *
+name (unsigned int func)
+{
+  return func >= 1 && func <= nnames ? names[func - 1] : "?";
+}
+
+static void
+read_event (event_t *e)
+{
+  unsigned long lo, hi;
+
+  lo = get (4);
+  hi = get (4);
+  e->time = (double) hi * 4294967296.0 + (double) lo;
+  e->prec = get (4);
+  e->func = get (2);
+  e->kind = get (1);
+  e->iter = get (1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  char magic[8];
+  unsigned long lost, m, i;
+  int summary = 0, depth = 0;
+  unsigned int stack_func[MAX_DEPTH];
+  double stack_time[MAX_DEPTH];
+  summary_t *sum;
+  event_t e;
+
+  progname = argv[0];
+  if (argc == 3 && strcmp (argv[1], "-s") == 0)
+    {
+      summary = 1;
+      argv++;
+      argc--;
+    }
+  if (argc != 2)
+    {
+      fprintf (stderr, "Usage: %s [-s] file\n", progname);
+      exit (1);
+    }
+  in = fopen (argv[1], "rb");
+  if (in == NULL)
+    {
+      perror (argv[1]);
+      exit (1);
+    }
+  if (fread (magic, 8, 1, in) != 1 || memcmp (magic, "MPFRTRC1", 8) != 0)
+    fail ("not an MPFR trace");
+
+  nnames = get (4);
+  names = (char **) malloc ((nnames + 1) * sizeof (char *));
+  if (names == NULL)
+    fail ("not enough memory");
+  for (i = 0; i < nnames; i++)
+    {
+      unsigned long l = get (2);
+
+      names[i] = (char *) malloc (l + 1);
+      if (names[i] == NULL)
+        fail ("not enough memory");
+      if (l != 0 && fread (names[i], l, 1, in) != 1)
+        fail ("truncated trace");
+      names[i][l] = '\0';
+    }
+  sum = (summary_t *) calloc (nnames + 1, sizeof (summary_t));
+  if (sum == NULL)
+    fail ("not enough memory");
+
+  lost = get (4);
+  m = get (4);
+  if (lost != 0)
+    printf ("# %lu older events were overwritten\n", lost);
+  if (!summary)
+    printf ("# %14s  %-5s %-24s %10s %4s\n",
+            "time (ns)", "event", "function", "prec", "iter");
+
+  for (i = 0; i < m; i++)
+    {
+      read_event (&e);
+      if (e.func > nnames)
+        e.func = 0;
+      if (e.kind == TRACE_EXIT)
+        {
+          int d;
+
+          /* find the matching entry, if it is still in the trace */
+          for (d = depth - 1; d >= 0 && stack_func[d] != e.func; d--);
+          if (d >= 0)
+            {
+              double t = e.time - stack_time[d];
+
+              sum[e.func].timed ++;
+              sum[e.func].total += t;
+              if (t > sum[e.func].max)
+                sum[e.func].max = t;
+              depth = d;
+            }
+        }
+      if (!summary)
+        {
+          const char *k = e.kind == TRACE_ENTER ? "enter" :
+            e.kind == TRACE_EXIT ? "exit" : e.kind == TRACE_ZIV ? "ziv" : "?";
+
+          printf ("%16.0f  %-5s %*s%-*s %10lu", e.time, k, 2 * depth, "",
+                  24 - 2 * depth > 0 ? 24 - 2 * depth : 0, name (e.func),
+                  e.prec);
+          if (e.kind == TRACE_ZIV)
+            printf (" %4d", e.iter);
+          printf ("\n");
+        }
+      if (e.kind == TRACE_ENTER)
+        {
+          sum[e.func].calls ++;
+          if (depth < MAX_DEPTH)
+            {
+              stack_func[depth] = e.func;
+              stack_time[depth] = e.time;
+              depth ++;
+            }
+        }
+      else if (e.kind == TRACE_ZIV)
+        {
+          summary_t *s = sum + e.func;
+
+          s->loops += e.iter == 1;
+          s->failures += e.iter == 2;
+          if (e.iter > s->max_iter)
+            s->max_iter = e.iter;
+          if (e.prec > s->max_prec)
+            s->max_prec = e.prec;
+        }
+    }
+
+  if (summary)
+    {
+      printf ("# %-22s %8s %12s %12s %8s %8s %4s %10s\n", "function",
+              "calls", "avg (ns)", "max (ns)", "loops", "failures", "iter",
+              "max prec");
+      for (i = 0; i <= nnames; i++)
+        {
+          summary_t *s = sum + (i < nnames ? i + 1 : 0);
+
+          if (s->calls == 0 && s->loops == 0)
+            continue;
+          printf ("%-24s %8lu %12.0f %12.0f %8lu %8lu %4d %10lu\n",
+                  name (i < nnames ? i + 1 : 0), s->calls,
+                  s->timed ? s->total / s->timed : 0.0, s->max,
+                  s->loops, s->failures, s->max_iter, s->max_prec);
+        }
+    }
+
+  fclose (in);
+  return 0;
+}
@@ -332,6 +332,29 @@ timing_ai2 (struct speed_params *s)
   SPEED_MPFR_FUNC_2D (mpfr_ai2);
 }
 
+/* asymptotic expansion, with Smith's method as fallback when it does not
+   converge enough (as done by mpfr_ai) */
+static int
+mpfr_ai3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+  int inex;
+
+  inex = MPFR_GET_EXP (x) >= 2 ? mpfr_ai_asympt (y, x, rnd) : 0;
+  return inex != 0 ? inex : mpfr_ai2 (y, x, rnd);
+}
+
+double
+timing_ai3 (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_2D (mpfr_ai3);
+}
+
+double
+timing_ai (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_2D (mpfr_ai);
+}
+
 /* These functions are for testing purpose only */
 /* They are used to draw which method is actually used */
 double
@@ -428,20 +451,26 @@ virtual_timing_ai2 (struct speed_params *s)
   return t;
 }
 
+/* Without argument, compare the naive method and Smith's method for
+   Ai(x) with x in [-80, 60]. With the argument "asympt", compare mpfr_ai
+   (thus the choice made with MPFR_AI_ASYMPT_THRESHOLD) with the asymptotic
+   expansion tried first, for |x| from 1 to 2^20 ~ 10^6: the power series
+   alone would be far too slow for such arguments. */
 int
-main (void)
+main (int argc, char *argv[])
 {
   FILE *output;
   struct speed_params2D param;
   double (*speed_funcs[3]) (struct speed_params *s);
+  int asympt = argc > 1 && strcmp (argv[1], "asympt") == 0;
 
   /* char filename[256] = "virtual_timing_ai.dat"; */
   /* speed_funcs[0] = virtual_timing_ai1; */
   /* speed_funcs[1] = virtual_timing_ai2; */
 
-  char filename[256] = "airy.dat";
-  speed_funcs[0] = timing_ai1;
-  speed_funcs[1] = timing_ai2;
+  const char *filename = asympt ? "airy_asympt.dat" : "airy.dat";
+  speed_funcs[0] = asympt ? timing_ai : timing_ai1;
+  speed_funcs[1] = asympt ? timing_ai3 : timing_ai2;
 
   speed_funcs[2] = NULL;
   output = fopen (filename, "w");
@@ -458,6 +487,14 @@ main (void)
   param.nb_points_prec = 200;
   param.logarithmic_scale_x  = 0;
   param.logarithmic_scale_prec = 0;
+  if (asympt)
+    {
+      param.min_x = 0;
+      param.max_x = 20;
+      param.nb_points_x = 80;
+      param.nb_points_prec = 30;
+      param.logarithmic_scale_x = -1;
+    }
   param.speed_funcs = speed_funcs;
 
   generate_2D_sample (output, param);
@@ -24,6 +24,8 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #include <time.h>
 
 #define MPFR_NEED_LONGLONG_H
+/* the tables of the two-dimensional crossovers are tuned below */
+#define MPFR_TUNE_TAB_CONST
 #include "mpfr-impl.h"
 
 #undef _PROTO
@@ -247,8 +249,11 @@ int verbose;
 
 /* Setup mpfr_exp_2 */
 mpfr_prec_t mpfr_exp_2_threshold;
+mpfr_prec_t mpfr_exp_2_sinh_threshold = MPFR_PREC_MAX;
 #undef  MPFR_EXP_2_THRESHOLD
 #define MPFR_EXP_2_THRESHOLD mpfr_exp_2_threshold
+#undef  MPFR_EXP_2_SINH_THRESHOLD
+#define MPFR_EXP_2_SINH_THRESHOLD mpfr_exp_2_sinh_threshold
 #include "exp_2.c"
 static double
 speed_mpfr_exp_2 (struct speed_params *s)
@@ -256,10 +261,27 @@ speed_mpfr_exp_2 (struct speed_params *s)
   SPEED_MPFR_FUNC (mpfr_exp_2);
 }
 
+/* Setup mpfr_log */
+mpfr_prec_t mpfr_log_atanh_threshold;
+#undef  MPFR_LOG_ATANH_THRESHOLD
+#define MPFR_LOG_ATANH_THRESHOLD mpfr_log_atanh_threshold
+#include "log.c"
+static double
+speed_mpfr_log (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC (mpfr_log);
+}
+
 /* Setup mpfr_exp */
 mpfr_prec_t mpfr_exp_threshold;
+mpfr_prec_t mpfr_exp_sparse_threshold = MPFR_PREC_MAX; /* tuned below */
+mpfr_prec_t mpfr_exp_sparse_ratio = MPFR_EXP_SPARSE_RATIO;
 #undef  MPFR_EXP_THRESHOLD
 #define MPFR_EXP_THRESHOLD mpfr_exp_threshold
+#undef  MPFR_EXP_SPARSE_THRESHOLD
+#define MPFR_EXP_SPARSE_THRESHOLD mpfr_exp_sparse_threshold
+#undef  MPFR_EXP_SPARSE_RATIO
+#define MPFR_EXP_SPARSE_RATIO mpfr_exp_sparse_ratio
 #include "exp.c"
 static double
 speed_mpfr_exp (struct speed_params *s)
@@ -985,6 +1007,9 @@ long int mpfr_ai_threshold3;
 #define MPFR_AI_THRESHOLD2 mpfr_ai_threshold2
 #undef  MPFR_AI_THRESHOLD3
 #define MPFR_AI_THRESHOLD3 mpfr_ai_threshold3
+long int mpfr_ai_asympt_threshold;
+#undef  MPFR_AI_ASYMPT_THRESHOLD
+#define MPFR_AI_ASYMPT_THRESHOLD mpfr_ai_asympt_threshold
 
 #include "ai.c"
 
@@ -994,6 +1019,619 @@ speed_mpfr_ai (struct speed_params *s)
   SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_ai);
 }
 
+/* Return d > 0 if the power series are faster than the asymptotic
+   expansion for Ai(x) at precision p, and d < 0 otherwise. */
+static double
+domeasure_ai_asympt (mpfr_prec_t p, mpfr_t x)
+{
+  struct speed_params s;
+  mp_size_t size;
+  double t1, t2, d;
+  mpfr_t xtmp;
+
+  s.align_xp = MPFR_IS_NEG (x) ? 2 : 1;
+  s.align_yp = s.align_wp = 64;
+  s.size = p;
+  size = (p - 1)/GMP_NUMB_BITS+1;
+
+  mpfr_init2 (xtmp, p);
+  mpn_random (xtmp->_mpfr_d, size);
+  xtmp->_mpfr_d[size-1] |= MPFR_LIMB_HIGHBIT;
+  MPFR_SET_EXP (xtmp, -53);
+  mpfr_add_ui (xtmp, xtmp, 1, MPFR_RNDN);
+  mpfr_mul (xtmp, xtmp, x, MPFR_RNDN);
+  s.xp = xtmp->_mpfr_d;
+  s.r = MPFR_GET_EXP (xtmp);
+
+  mpfr_ai_asympt_threshold = LONG_MAX;
+  t1 = mpfr_speed_measure (speed_mpfr_ai, &s, "power series");
+  mpfr_ai_asympt_threshold = 0;
+  t2 = mpfr_speed_measure (speed_mpfr_ai, &s, "asymptotic expansion");
+
+  if (t2 >= t1)
+    d = (t2 - t1) / t2;
+  else
+    d = (t2 - t1) / t1;
+  mpfr_clear (xtmp);
+  return d;
+}
+
+/* The asymptotic expansion is used for Ai(x) when
+   MPFR_AI_SCALE*|x|^(3/2) >= MPFR_AI_ASYMPT_THRESHOLD*p. For a few
+   precisions and both signs of x, find by bisection the smallest
+   threshold for which the asymptotic expansion is faster at the boundary,
+   and keep the largest one. */
+static void
+tune_ai_asympt (void)
+{
+  static const int mult[3] = { 1, 4, 16 };
+  long int lo, hi, mid, best = 0;
+  mpfr_prec_t p;
+  mpfr_t x;
+  int i, j, sign;
+
+  mpfr_init2 (x, MPFR_SMALL_PRECISION);
+  for (i = 0; i < 3; i++)
+    for (sign = 1; sign >= -1; sign -= 2)
+      {
+        p = MPFR_PREC_MIN + mult[i] * GMP_NUMB_BITS;
+        /* below MPFR_AI_SCALE/2 the expansion cannot give p bits */
+        lo = MPFR_AI_SCALE / 2;
+        hi = 4 * MPFR_AI_SCALE;
+        for (j = 0; j < 8; j++)
+          {
+            mid = lo + (hi - lo) / 2;
+            /* x = sign * (mid*p/MPFR_AI_SCALE)^(2/3) */
+            mpfr_set_si (x, mid, MPFR_RNDN);
+            mpfr_mul_ui (x, x, (unsigned long) p, MPFR_RNDN);
+            mpfr_div_ui (x, x, MPFR_AI_SCALE, MPFR_RNDN);
+            mpfr_sqr (x, x, MPFR_RNDN);
+            mpfr_cbrt (x, x, MPFR_RNDN);
+            if (sign < 0)
+              mpfr_neg (x, x, MPFR_RNDN);
+            if (domeasure_ai_asympt (p, x) < 0)
+              hi = mid;
+            else
+              lo = mid;
+          }
+        if (verbose)
+          printf ("p=%lu x%s0: threshold %ld\n", (unsigned long) p,
+                  sign > 0 ? ">" : "<", hi);
+        if (hi > best)
+          best = hi;
+      }
+  mpfr_clear (x);
+  mpfr_ai_asympt_threshold = best;
+}
+
+
+/*******************************************************
+ *      Tuning functions for the crossovers which      *
+ *      depend on the precision and the magnitude      *
+ *******************************************************/
+
+/* These crossovers are given by tables of MPFR_PREC_TAB_SIZE values,
+   one per precision range (see MPFR_PREC_TAB_INDEX in mpfr-impl.h). */
+
+#include "erfc.c"
+#include "eint.c"
+#include "jn.c"
+#undef MPFR_JN
+#undef FUNCTION
+#include "yn.c"
+#include "lngamma.c"
+#undef GAMMA_FUNC
+#undef ALPHA_TAB
+#include "gamma.c"
+#include "zeta.c"
+#include "atan.c"
+
+static double
+speed_mpfr_erfc (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_erfc);
+}
+
+static double
+speed_mpfr_eint (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_eint);
+}
+
+static int
+mpfr_j0_jn (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t r)
+{
+  return mpfr_jn (y, 0, x, r);
+}
+
+static double
+speed_mpfr_jn (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_j0_jn);
+}
+
+static int
+mpfr_y0_yn (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t r)
+{
+  return mpfr_yn (y, 0, x, r);
+}
+
+static double
+speed_mpfr_yn (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_y0_yn);
+}
+
+static double
+speed_mpfr_lngamma (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_lngamma);
+}
+
+static double
+speed_mpfr_gamma (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_gamma);
+}
+
+static double
+speed_mpfr_zeta (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_zeta);
+}
+
+static double
+speed_mpfr_atan (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC_WITH_EXPONENT (mpfr_atan);
+}
+
+/* Set x to the input on the boundary given by the value c of the table,
+   for the precision p. */
+
+static void
+boundary_erfc (mpfr_ptr x, long c, mpfr_prec_t p)
+{
+  double w;
+
+  /* x^2 = c*w/1024, where w is the working precision of mpfr_erfc,
+     which depends on EXP(x) ~ log2(x^2)/2 */
+  w = (double) (p + MPFR_INT_CEIL_LOG2 (p) + 3);
+  w += __gmpfr_ceil_log2 ((double) c * w / 1024.0);
+  mpfr_set_d (x, (double) c * w / 1024.0, MPFR_RNDN);
+  mpfr_sqrt (x, x, MPFR_RNDN);
+}
+
+static void
+boundary_eint (mpfr_ptr x, long c, mpfr_prec_t p)
+{
+  double w, y;
+
+  /* x = c/1024*(w + EXP(x)/2)*log(2) + 1, where w is the working
+     precision of mpfr_eint */
+  w = (double) (p + 2 * MPFR_INT_CEIL_LOG2 (p) + 6);
+  y = (double) c / 1024.0 * w * LOG2;
+  y = (double) c / 1024.0 * (w + 0.5 * __gmpfr_ceil_log2 (y)) * LOG2 + 1.0;
+  mpfr_set_d (x, y, MPFR_RNDN);
+}
+
+static void
+boundary_jyn (mpfr_ptr x, long c, mpfr_prec_t p)
+{
+  /* x = c*p/1024 + 3 */
+  mpfr_set_d (x, (double) c * (double) p / 1024.0 + 3.0, MPFR_RNDN);
+}
+
+static void
+boundary_zeta (mpfr_ptr x, long c, mpfr_prec_t p)
+{
+  /* x = c*d/1024, where d is the working precision of mpfr_zeta_pos */
+  mpfr_set_d (x, (double) c * (double) (p + MPFR_INT_CEIL_LOG2 (p) + 10)
+              / 1024.0, MPFR_RNDN);
+}
+
+static void
+boundary_atan (mpfr_ptr x, long c, mpfr_prec_t p)
+{
+  mpfr_uexp_t prec = p + 5;
+
+  /* mpfr_atan_large needs c terms for x = 2^ceil(prec/(2c)) */
+  mpfr_set_ui_2exp (x, 1, (prec + 2 * c - 1) / (2 * c), MPFR_RNDN);
+}
+
+/* Each crossover is tuned by bisection on its value c in [lo, hi], where
+   the second algorithm is used for the inputs beyond the boundary given
+   by c (for a larger c if larger is zero, for a smaller c otherwise).
+   The values c1 and c2 force the first and the second algorithm for the
+   inputs near the boundaries. */
+struct tune_tab_s
+{
+  const char *name;
+  short *tab;
+  short c1, c2;
+  long lo, hi;
+  int larger;
+  speed_function_t fun;
+  void (*boundary) (mpfr_ptr, long, mpfr_prec_t);
+};
+
+static const struct tune_tab_s tune_tab[] =
+  {
+    { "MPFR_ERFC_ASYMPT_TAB", erfc_asympt_tab, SHRT_MAX, 0, 710, 8192, 0,
+      speed_mpfr_erfc, boundary_erfc },
+    { "MPFR_EINT_ASYMPT_TAB", eint_asympt_tab, SHRT_MAX, 0, 1024, 8192, 0,
+      speed_mpfr_eint, boundary_eint },
+    { "MPFR_JN_ASYMPT_TAB", jn_asympt_tab, SHRT_MAX, 0, 355, 4096, 0,
+      speed_mpfr_jn, boundary_jyn },
+    { "MPFR_YN_ASYMPT_TAB", yn_asympt_tab, SHRT_MAX, 0, 355, 4096, 0,
+      speed_mpfr_yn, boundary_jyn },
+    { "MPFR_ZETA_DIRECT_TAB", zeta_direct_tab, 0, 1, 128, 1024, 0,
+      speed_mpfr_zeta, boundary_zeta },
+    { "MPFR_ATAN_LARGE_TAB", atan_large_tab, 0, SHRT_MAX, 1, 64, 1,
+      speed_mpfr_atan, boundary_atan }
+  };
+
+/* Precision used to tune the entry i of the tables, in the middle of its
+   range, so that the working precision is in the same range. */
+static mpfr_prec_t
+tune_tab_prec (int i)
+{
+  return 3 * ((mpfr_prec_t) 16 << i);
+}
+
+static void
+set_tab (short *tab, short c)
+{
+  int i;
+
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    tab[i] = c;
+}
+
+/* Set tab to the tuned values res, and write them to f. */
+static void
+write_tab (FILE *f, const char *name, short *tab, const short *res)
+{
+  int i;
+
+  fprintf (f, "#define %s ", name);
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    {
+      tab[i] = res[i];
+      fprintf (f, "%d%s", res[i], i < MPFR_PREC_TAB_SIZE - 1 ? "," : "\n");
+    }
+}
+
+/* Return d > 0 if the first algorithm of t is faster than the second one
+   for x at precision p, and d < 0 otherwise. */
+static double
+domeasure_tab (const struct tune_tab_s *t, mpfr_prec_t p, mpfr_t x)
+{
+  struct speed_params s;
+  mp_size_t size;
+  double t1, t2, d;
+  mpfr_t xtmp;
+
+  s.align_xp = MPFR_IS_NEG (x) ? 2 : 1;
+  s.align_yp = s.align_wp = 64;
+  s.size = p;
+  size = (p - 1)/GMP_NUMB_BITS+1;
+
+  mpfr_init2 (xtmp, p);
+  mpn_random (xtmp->_mpfr_d, size);
+  xtmp->_mpfr_d[size-1] |= MPFR_LIMB_HIGHBIT;
+  MPFR_SET_EXP (xtmp, -53);
+  mpfr_add_ui (xtmp, xtmp, 1, MPFR_RNDN);
+  mpfr_mul (xtmp, xtmp, x, MPFR_RNDN);
+  s.xp = xtmp->_mpfr_d;
+  s.r = MPFR_GET_EXP (xtmp);
+
+  set_tab (t->tab, t->c1);
+  t1 = mpfr_speed_measure (t->fun, &s, "first algorithm");
+  set_tab (t->tab, t->c2);
+  t2 = mpfr_speed_measure (t->fun, &s, "second algorithm");
+
+  if (t2 >= t1)
+    d = (t2 - t1) / t2;
+  else
+    d = (t2 - t1) / t1;
+  mpfr_clear (xtmp);
+  return d;
+}
+
+/* Tune the table of t and write it to f. */
+static void
+tune_tab_crossover (FILE *f, const struct tune_tab_s *t)
+{
+  short res[MPFR_PREC_TAB_SIZE];
+  long lo, hi, mid;
+  mpfr_prec_t p;
+  mpfr_t x;
+  int i;
+
+  if (verbose)
+    printf ("Tuning %s...\n", t->name);
+  mpfr_init2 (x, MPFR_SMALL_PRECISION);
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    {
+      p = tune_tab_prec (i);
+      lo = t->lo;
+      hi = t->hi;
+      while (hi - lo > 1 && hi - lo > lo / 64)
+        {
+          mid = lo + (hi - lo) / 2;
+          t->boundary (x, mid, p);
+          if ((domeasure_tab (t, p, x) < 0) != (t->larger != 0))
+            hi = mid;
+          else
+            lo = mid;
+        }
+      res[i] = t->larger ? lo : hi;
+      if (verbose)
+        printf ("p=%lu: %d\n", (unsigned long) p, res[i]);
+    }
+  mpfr_clear (x);
+
+  write_tab (f, t->name, t->tab, res);
+}
+
+/* The value alpha of the argument reduction of mpfr_lngamma and mpfr_gamma
+   is not a crossover, thus for each precision range, we keep the fastest
+   value among a few ones, for an input x in [4, 8). Since gamma.c includes
+   lngamma.c, each function has its own table. */
+static void
+tune_gamma_alpha (FILE *f, const char *name, short *tab,
+                  double (*func) (struct speed_params *), char *fname)
+{
+  static const short alpha[] = { 128, 192, 256, 384, 512, 768, 1024 };
+  short res[MPFR_PREC_TAB_SIZE];
+  struct speed_params s;
+  mpfr_prec_t p;
+  mp_size_t size;
+  mpfr_t x;
+  double t, tmin;
+  int i, j;
+
+  if (verbose)
+    printf ("Tuning %s...\n", name);
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    {
+      p = tune_tab_prec (i);
+      size = (p - 1)/GMP_NUMB_BITS+1;
+      mpfr_init2 (x, p);
+      mpn_random (x->_mpfr_d, size);
+      s.align_xp = 1;
+      s.align_yp = s.align_wp = 64;
+      s.size = p;
+      s.xp = x->_mpfr_d;
+      s.r = 3;
+      tmin = 0.0;
+      for (j = 0; j < (int) numberof (alpha); j++)
+        {
+          set_tab (tab, alpha[j]);
+          t = mpfr_speed_measure (func, &s, fname);
+          if (j == 0 || t < tmin)
+            {
+              tmin = t;
+              res[i] = alpha[j];
+            }
+        }
+      mpfr_clear (x);
+      if (verbose)
+        printf ("p=%lu: %d\n", (unsigned long) p, res[i]);
+    }
+
+  write_tab (f, name, tab, res);
+}
+
+
+/*******************************************************
+ *      Tuning functions for the crossovers which      *
+ *          depend on the size of the input            *
+ *******************************************************/
+
+/* Setup mpfr_exp_q */
+mpfr_prec_t mpfr_trans_q_threshold = MPFR_PREC_MAX; /* tuned below */
+mpfr_prec_t mpfr_trans_q_ratio = MPFR_TRANS_Q_RATIO;
+#undef  MPFR_TRANS_Q_THRESHOLD
+#define MPFR_TRANS_Q_THRESHOLD mpfr_trans_q_threshold
+#undef  MPFR_TRANS_Q_RATIO
+#define MPFR_TRANS_Q_RATIO mpfr_trans_q_ratio
+#include "trans_q.c"
+
+/* Setup mpfr_pow */
+#include "pow.c"
+
+/* For the precision p, the inputs of speed_mpfr_exp_sparse and
+   speed_mpfr_exp_q have size p/tune_size_ratio: this is the number of
+   significant bits of x for mpfr_exp, and the sum of the sizes of the
+   numerator and of the denominator of x for mpfr_exp_q. */
+static mpfr_prec_t tune_size_ratio;
+
+/* Set x to the high bits of {xp, LIMB_SIZE(p)}, with exponent 0. */
+static void
+set_high_bits (mpfr_ptr x, mpfr_limb_ptr xp, mpfr_prec_t p)
+{
+  mpfr_t y;
+
+  MPFR_TMP_INIT1 (xp, y, p);
+  MPFR_SET_EXP (y, 0);
+  mpfr_set (x, y, MPFR_RNDZ);
+}
+
+static double
+speed_mpfr_exp_sparse (struct speed_params *s)
+{
+  unsigned  i;
+  double    t;
+  mpfr_t    w, x;
+  mp_size_t size;
+
+  SPEED_RESTRICT_COND (s->size >= MPFR_PREC_MIN);
+  SPEED_RESTRICT_COND (s->size <= MPFR_PREC_MAX);
+  size = (s->size-1)/GMP_NUMB_BITS+1;
+  s->xp[size-1] |= MPFR_LIMB_HIGHBIT;
+  mpfr_init2 (w, s->size);
+  mpfr_init2 (x, MAX (s->size / tune_size_ratio, MPFR_PREC_MIN));
+  set_high_bits (x, s->xp, s->size);
+
+  speed_starttime ();
+  i = s->reps;
+  do
+    mpfr_exp (w, x, MPFR_RNDN);
+  while (--i != 0);
+  t = speed_endtime ();
+
+  mpfr_clear (w);
+  mpfr_clear (x);
+  return t;
+}
+
+static double
+speed_mpfr_exp_q (struct speed_params *s)
+{
+  unsigned  i;
+  double    t;
+  mpfr_t    w, x;
+  mpq_t     q;
+  mp_size_t size;
+
+  SPEED_RESTRICT_COND (s->size >= MPFR_PREC_MIN);
+  SPEED_RESTRICT_COND (s->size <= MPFR_PREC_MAX);
+  size = (s->size-1)/GMP_NUMB_BITS+1;
+  s->xp[size-1] |= MPFR_LIMB_HIGHBIT;
+  s->yp[size-1] |= MPFR_LIMB_HIGHBIT;
+  mpfr_init2 (w, s->size);
+  mpfr_init2 (x, MAX (s->size / (2 * tune_size_ratio), MPFR_PREC_MIN));
+  mpq_init (q);
+  set_high_bits (x, s->xp, s->size);
+  mpfr_get_z_2exp (mpq_numref (q), x);
+  set_high_bits (x, s->yp, s->size);
+  mpfr_get_z_2exp (mpq_denref (q), x);
+  mpq_canonicalize (q);
+
+  speed_starttime ();
+  i = s->reps;
+  do
+    mpfr_exp_q (w, q, MPFR_RNDN);
+  while (--i != 0);
+  t = speed_endtime ();
+
+  mpfr_clear (w);
+  mpfr_clear (x);
+  mpq_clear (q);
+  return t;
+}
+
+/* Tune a crossover of the form p >= threshold && size(x) <= p/ratio,
+   where the second algorithm is used if the condition holds. The ratio
+   is tuned first by bisection, at a precision large enough for the sizes
+   to be meaningful, then the threshold is tuned for the inputs of size
+   p/ratio. */
+#define TUNE_SIZE_PREC 4096
+static void
+tune_size_func (mpfr_prec_t *threshold, mpfr_prec_t *ratio,
+                double (*func) (struct speed_params *),
+                mpfr_prec_t pstart)
+{
+  mpfr_prec_t lo, hi, mid;
+
+  *ratio = 1; /* so that the algorithm only depends on the threshold */
+  lo = 2;
+  hi = 1024;
+  while (hi - lo > 1 && hi - lo > lo / 16)
+    {
+      mid = lo + (hi - lo) / 2;
+      tune_size_ratio = mid;
+      if (domeasure (threshold, func, TUNE_SIZE_PREC) < 0.0)
+        hi = mid;
+      else
+        lo = mid;
+    }
+  if (verbose)
+    printf ("ratio: %lu\n", (unsigned long) hi);
+  tune_size_ratio = hi;
+  tune_simple_func (threshold, func, pstart);
+  *ratio = hi;
+}
+
+static mpfr_t tune_pow_x, tune_pow_y;
+
+static double
+speed_mpfr_pow (struct speed_params *s)
+{
+  unsigned  i;
+  double    t;
+  mpfr_t    w;
+
+  mpfr_init2 (w, s->size);
+  speed_starttime ();
+  i = s->reps;
+  do
+    mpfr_pow (w, tune_pow_x, tune_pow_y, MPFR_RNDN);
+  while (--i != 0);
+  t = speed_endtime ();
+  mpfr_clear (w);
+  return t;
+}
+
+/* For each precision range, the largest exponent c of an integer y for
+   which mpfr_pow_z is faster than the general case of mpfr_pow is found
+   by bisection, with y = 2^c - 1 and x = 1 + 2^(k-c) u, where u is in
+   [1/2, 1): thus |log(x^y)| < 2^k. We take k such that x has at least 8
+   significant bits after the leading 1, and k <= 60 so that x^y does not
+   overflow, which bounds c. */
+static void
+tune_pow_z (FILE *f)
+{
+  short res[MPFR_PREC_TAB_SIZE];
+  struct speed_params s;
+  mpfr_prec_t p;
+  mp_size_t size;
+  long lo, hi, mid;
+  double t1, t2;
+  int i;
+
+  if (verbose)
+    printf ("Tuning MPFR_POW_Z_TAB...\n");
+  for (i = 0; i < MPFR_PREC_TAB_SIZE; i++)
+    {
+      p = tune_tab_prec (i);
+      size = (p - 1)/GMP_NUMB_BITS+1;
+      mpfr_init2 (tune_pow_x, p);
+      mpfr_init2 (tune_pow_y, p);
+      s.align_xp = s.align_yp = s.align_wp = 64;
+      s.size = p;
+      s.xp = tune_pow_x->_mpfr_d;
+      s.yp = tune_pow_y->_mpfr_d;
+      lo = MPFR_PREC_BITS;
+      hi = MIN (256, (long) p + 52);
+      while (hi - lo > 1 && hi - lo > lo / 64)
+        {
+          mid = lo + (hi - lo) / 2;
+          mpn_random (tune_pow_x->_mpfr_d, size);
+          tune_pow_x->_mpfr_d[size-1] |= MPFR_LIMB_HIGHBIT;
+          MPFR_SET_EXP (tune_pow_x, MAX (40, mid - (long) p + 8) - mid);
+          mpfr_add_ui (tune_pow_x, tune_pow_x, 1, MPFR_RNDN);
+          mpfr_set_ui_2exp (tune_pow_y, 1, mid, MPFR_RNDN);
+          mpfr_sub_ui (tune_pow_y, tune_pow_y, 1, MPFR_RNDZ);
+          set_tab (pow_z_tab, SHRT_MAX);
+          t1 = mpfr_speed_measure (speed_mpfr_pow, &s, "mpfr_pow_z");
+          set_tab (pow_z_tab, 0);
+          t2 = mpfr_speed_measure (speed_mpfr_pow, &s, "mpfr_pow");
+          if (t2 < t1)
+            hi = mid;
+          else
+            lo = mid;
+        }
+      res[i] = lo;
+      mpfr_clear (tune_pow_x);
+      mpfr_clear (tune_pow_y);
+      if (verbose)
+        printf ("p=%lu: %d\n", (unsigned long) p, res[i]);
+    }
+  write_tab (f, "MPFR_POW_Z_TAB", pow_z_tab, res);
+}
 
 /*******************************************************
  *            Tune all the threshold of MPFR           *
@@ -1007,6 +1645,7 @@ all (const char *filename)
   struct tm  *tp;
   mpfr_t x1, x2, x3, tmp1, tmp2;
   mpfr_prec_t p1, p2, p3;
+  int i;
 
   f = fopen (filename, "w");
   if (f == NULL)
@@ -1102,6 +1741,22 @@ all (const char *filename)
   fprintf (f, "#define MPFR_EXP_2_THRESHOLD %lu /* bits */\n",
            (unsigned long) mpfr_exp_2_threshold);
 
+  /* Tune the sinh-based evaluation in mpfr_exp_2 */
+  if (verbose)
+    printf ("Tuning mpfr_exp_2 (sinh)...\n");
+  tune_simple_func (&mpfr_exp_2_sinh_threshold, speed_mpfr_exp_2,
+                    MPFR_PREC_MIN+3*GMP_NUMB_BITS);
+  fprintf (f, "#define MPFR_EXP_2_SINH_THRESHOLD %lu /* bits */\n",
+           (unsigned long) mpfr_exp_2_sinh_threshold);
+
+  /* Tune mpfr_log */
+  if (verbose)
+    printf ("Tuning mpfr_log...\n");
+  tune_simple_func (&mpfr_log_atanh_threshold, speed_mpfr_log,
+                    MPFR_PREC_MIN+GMP_NUMB_BITS);
+  fprintf (f, "#define MPFR_LOG_ATANH_THRESHOLD %lu /* bits */\n",
+           (unsigned long) mpfr_log_atanh_threshold);
+
   /* Tune mpfr_exp */
   if (verbose)
     printf ("Tuning mpfr_exp...\n");
@@ -1110,6 +1765,20 @@ all (const char *filename)
   fprintf (f, "#define MPFR_EXP_THRESHOLD %lu /* bits */\n",
            (unsigned long) mpfr_exp_threshold);
 
+  /* Tune mpfr_exp for sparse inputs, where mpfr_exp_3 is compared to
+     mpfr_exp_2 in all precisions */
+  if (verbose)
+    printf ("Tuning mpfr_exp (sparse inputs)...\n");
+  p1 = mpfr_exp_threshold;
+  mpfr_exp_threshold = MPFR_PREC_MAX;
+  tune_size_func (&mpfr_exp_sparse_threshold, &mpfr_exp_sparse_ratio,
+                  speed_mpfr_exp_sparse, MPFR_PREC_MIN+3*GMP_NUMB_BITS);
+  mpfr_exp_threshold = p1;
+  fprintf (f, "#define MPFR_EXP_SPARSE_THRESHOLD %lu /* bits */\n",
+           (unsigned long) mpfr_exp_sparse_threshold);
+  fprintf (f, "#define MPFR_EXP_SPARSE_RATIO %lu\n",
+           (unsigned long) mpfr_exp_sparse_ratio);
+
   /* Tune mpfr_sin_cos */
   if (verbose)
     printf ("Tuning mpfr_sin_cos...\n");
@@ -1121,6 +1790,7 @@ all (const char *filename)
   /* Tune mpfr_ai */
   if (verbose)
     printf ("Tuning mpfr_ai...\n");
+  mpfr_ai_asympt_threshold = LONG_MAX; /* tuned below */
   mpfr_init2 (x1, MPFR_SMALL_PRECISION);
   mpfr_init2 (x2, MPFR_SMALL_PRECISION);
   mpfr_init2 (x3, MPFR_SMALL_PRECISION);
@@ -1164,9 +1834,36 @@ all (const char *filename)
   fprintf (f, "#define MPFR_AI_THRESHOLD2 %ld\n", mpfr_ai_threshold2);
   fprintf (f, "#define MPFR_AI_THRESHOLD3 %ld\n", mpfr_ai_threshold3);
 
+  tune_ai_asympt ();
+  fprintf (f, "#define MPFR_AI_ASYMPT_THRESHOLD %ld /* asymptotic expansion of mpfr_ai */\n",
+           mpfr_ai_asympt_threshold);
+
   mpfr_clear (x1); mpfr_clear (x2); mpfr_clear (x3);
   mpfr_clear (tmp1); mpfr_clear (tmp2);
 
+  /* Tune the crossovers depending on the precision and the magnitude */
+  for (i = 0; i < (int) numberof (tune_tab); i++)
+    tune_tab_crossover (f, &tune_tab[i]);
+  tune_gamma_alpha (f, "MPFR_LNGAMMA_ALPHA_TAB", lngamma_alpha_tab,
+                    speed_mpfr_lngamma, "mpfr_lngamma");
+  tune_gamma_alpha (f, "MPFR_GAMMA_ALPHA_TAB", gamma_alpha_tab,
+                    speed_mpfr_gamma, "mpfr_gamma");
+
+  /* Tune the binary splitting of mpfr_exp_q, mpfr_sin_q, etc. The other
+     crossovers to binary splitting are MPFR_EXP_THRESHOLD and
+     MPFR_SINCOS_THRESHOLD; mpfr_bsplit itself has none (see bsplit.c). */
+  if (verbose)
+    printf ("Tuning mpfr_exp_q...\n");
+  tune_size_func (&mpfr_trans_q_threshold, &mpfr_trans_q_ratio,
+                  speed_mpfr_exp_q, MPFR_PREC_MIN+3*GMP_NUMB_BITS);
+  fprintf (f, "#define MPFR_TRANS_Q_THRESHOLD %lu /* bits */\n",
+           (unsigned long) mpfr_trans_q_threshold);
+  fprintf (f, "#define MPFR_TRANS_Q_RATIO %lu\n",
+           (unsigned long) mpfr_trans_q_ratio);
+
+  /* Tune mpfr_pow for integer exponents */
+  tune_pow_z (f);
+
   /* End of tuning */
   time (&end_time);
   fprintf (f, "/* Tuneup completed successfully, took %ld seconds */\n",